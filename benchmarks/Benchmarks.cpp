@@ -0,0 +1,553 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#define IMGUI_DISABLE_INCLUDE_IMCONFIG_H
+#include "stdafx.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "CameraToolsConnector.h"
+#include "CameraToolsDataExchange.h"
+#include "CDataFile.h"
+#include "DepthOfFieldController.h"
+#include "FakeEffectRuntime.h"
+#include "FastJpegEncoder.h"
+#include "ImageUtils.h"
+#include "LerpUtils.h"
+#include "ReshadeStateSnapshot.h"
+#include "StateInterpolationPlan.h"
+#include "std_image_write.h"
+#include "StripedPngEncoder.h"
+#include "ThreadSafeQueue.h"
+#include "Utils.h"
+#include "fpng.h"
+
+/// <summary>
+/// Benchmarks of the hot paths of the addon, run against the fake effect_runtime. Meant to catch performance regressions between releases.
+/// Run with --benchmark_out=<file> --benchmark_out_format=json to get the results as JSON.
+/// </summary>
+namespace IGCS::Benchmarks
+{
+	// number of float4 uniforms interpolated by the lerp benchmarks. Heavy presets have over 2000.
+	static const size_t NUMBER_OF_UNIFORMS_TO_LERP = 2048;
+	// the synthetic preset used by the state benchmarks: 64 effects with 32 uniforms each, so it's about as heavy as the presets above.
+	static const int NUMBER_OF_EFFECTS_IN_PRESET = 64;
+	static const int NUMBER_OF_UNIFORMS_PER_EFFECT = 32;
+	// the work queue benchmark pushes this many items from each of the producer threads while the calling thread drains the queue.
+	static const int NUMBER_OF_QUEUE_PRODUCERS = 3;
+	static const int NUMBER_OF_ITEMS_PER_QUEUE_PRODUCER = 20000;
+	// the camera data exchange benchmark writes this many states from a writer thread while the calling thread reads them.
+	static const int NUMBER_OF_CAMERA_DATA_WRITES = 100000;
+	// size of the synthetic frame used by the pack and encoder benchmarks.
+	static const uint32_t FRAME_WIDTH = 3840;
+	static const uint32_t FRAME_HEIGHT = 2160;
+
+	static std::vector<uint8_t> createSyntheticFrame(uint32_t width, uint32_t height, uint32_t numberOfChannels)
+	{
+		// smooth gradients, hard edges and a bit of noise, so the encoders have something realistic to chew on. Deterministic so runs are comparable.
+		std::vector<uint8_t> frame((size_t)width * height * numberOfChannels);
+		uint32_t seed = 1;
+		for(uint32_t y = 0; y < height; y++)
+		{
+			for(uint32_t x = 0; x < width; x++)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				uint8_t* pixel = &frame[((size_t)y * width + x) * numberOfChannels];
+				pixel[0] = (uint8_t)((x * 255) / width + ((seed >> 24) & 7));
+				pixel[1] = (uint8_t)((y * 255) / height);
+				pixel[2] = (((x / 64) + (y / 64)) & 1) ? 220 : (uint8_t)(30 + ((seed >> 16) & 15));
+				if(numberOfChannels == 4)
+				{
+					pixel[3] = 0;
+				}
+			}
+		}
+		return frame;
+	}
+
+
+	static void addSyntheticPreset(FakeEffectRuntime& runtime, float valueSeed)
+	{
+		for(int i = 0; i < NUMBER_OF_EFFECTS_IN_PRESET; i++)
+		{
+			runtime.addSyntheticEffect(IGCS::Utils::formatString("Effect%d.fx", i), NUMBER_OF_UNIFORMS_PER_EFFECT, valueSeed);
+		}
+	}
+
+
+	static void setFrameLabel(benchmark::State& state)
+	{
+		state.SetLabel(IGCS::Utils::formatString("%ux%u", FRAME_WIDTH, FRAME_HEIGHT));
+	}
+
+
+	static void packRGBAToRGB(benchmark::State& state)
+	{
+		const auto kernelToUse = (IGCS::ImageUtils::PackKernel)state.range(0);
+		if(kernelToUse > IGCS::ImageUtils::bestSupportedPackKernel())
+		{
+			state.SkipWithError("kernel not supported by this CPU");
+			return;
+		}
+		const std::vector<uint8_t> source = createSyntheticFrame(FRAME_WIDTH, FRAME_HEIGHT, 4);
+		std::vector<uint8_t> destination((size_t)FRAME_WIDTH * FRAME_HEIGHT * 3);
+		const size_t numberOfPixels = (size_t)FRAME_WIDTH * FRAME_HEIGHT;
+		for(auto _ : state)
+		{
+			IGCS::ImageUtils::packRGBAToRGB(source.data(), destination.data(), numberOfPixels, kernelToUse);
+			benchmark::DoNotOptimize(destination.data());
+		}
+		state.SetBytesProcessed(state.iterations() * source.size());
+		state.SetLabel(IGCS::ImageUtils::packKernelName(kernelToUse));
+	}
+	BENCHMARK(packRGBAToRGB)->DenseRange((int)IGCS::ImageUtils::PackKernel::Scalar, (int)IGCS::ImageUtils::PackKernel::AVX2)->Unit(benchmark::kMillisecond);
+
+
+	static void appendToEncodedData(void* context, void* data, int size)
+	{
+		auto encodedData = static_cast<std::vector<uint8_t>*>(context);
+		encodedData->insert(encodedData->end(), static_cast<uint8_t*>(data), static_cast<uint8_t*>(data) + size);
+	}
+
+
+	static void encodeBmpStb(benchmark::State& state)
+	{
+		const std::vector<uint8_t> frame = createSyntheticFrame(FRAME_WIDTH, FRAME_HEIGHT, 3);
+		std::vector<uint8_t> encodedData;
+		encodedData.reserve(frame.size() + 1024);
+		for(auto _ : state)
+		{
+			encodedData.clear();
+			stbi_write_bmp_to_func(appendToEncodedData, &encodedData, FRAME_WIDTH, FRAME_HEIGHT, 3, frame.data());
+		}
+		state.SetBytesProcessed(state.iterations() * frame.size());
+		setFrameLabel(state);
+	}
+	BENCHMARK(encodeBmpStb)->Unit(benchmark::kMillisecond);
+
+
+	static void encodeJpgStb(benchmark::State& state)
+	{
+		const std::vector<uint8_t> frame = createSyntheticFrame(FRAME_WIDTH, FRAME_HEIGHT, 3);
+		std::vector<uint8_t> encodedData;
+		encodedData.reserve(frame.size() + 1024);
+		for(auto _ : state)
+		{
+			encodedData.clear();
+			stbi_write_jpg_to_func(appendToEncodedData, &encodedData, FRAME_WIDTH, FRAME_HEIGHT, 3, frame.data(), 98);
+		}
+		state.SetBytesProcessed(state.iterations() * frame.size());
+		setFrameLabel(state);
+	}
+	BENCHMARK(encodeJpgStb)->Unit(benchmark::kMillisecond);
+
+
+	/// <summary>
+	/// Argument: the number of threads to use, 0 means all cores.
+	/// </summary>
+	static void encodeJpgFast(benchmark::State& state)
+	{
+		if(!IGCS::FastJpegEncoder::isSupported())
+		{
+			state.SkipWithError("the fast jpeg encoder isn't supported by this CPU");
+			return;
+		}
+		const std::vector<uint8_t> frame = createSyntheticFrame(FRAME_WIDTH, FRAME_HEIGHT, 3);
+		std::vector<uint8_t> encodedData;
+		for(auto _ : state)
+		{
+			IGCS::FastJpegEncoder::encodeImageToMemory(frame.data(), FRAME_WIDTH, FRAME_HEIGHT, 98, encodedData, (uint32_t)state.range(0));
+		}
+		state.SetBytesProcessed(state.iterations() * frame.size());
+		setFrameLabel(state);
+	}
+	BENCHMARK(encodeJpgFast)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+	static void encodePngFpng(benchmark::State& state)
+	{
+		const std::vector<uint8_t> frame = createSyntheticFrame(FRAME_WIDTH, FRAME_HEIGHT, 3);
+		std::vector<uint8_t> encodedData;
+		for(auto _ : state)
+		{
+			fpng::fpng_encode_image_to_memory(frame.data(), FRAME_WIDTH, FRAME_HEIGHT, 3, encodedData);
+		}
+		state.SetBytesProcessed(state.iterations() * frame.size());
+		setFrameLabel(state);
+	}
+	BENCHMARK(encodePngFpng)->Unit(benchmark::kMillisecond);
+
+
+	static void encodePngStriped(benchmark::State& state)
+	{
+		const std::vector<uint8_t> frame = createSyntheticFrame(FRAME_WIDTH, FRAME_HEIGHT, 3);
+		std::vector<uint8_t> encodedData;
+		for(auto _ : state)
+		{
+			IGCS::StripedPngEncoder::encodeImageToMemory(frame.data(), FRAME_WIDTH, FRAME_HEIGHT, 3, encodedData);
+		}
+		state.SetBytesProcessed(state.iterations() * frame.size());
+		setFrameLabel(state);
+	}
+	BENCHMARK(encodePngStriped)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+	/// <summary>
+	/// Fills the lerp inputs for the lerp benchmarks. The spline coefficients are just different values, so the lerp inputs are reused for them.
+	/// </summary>
+	static void createLerpInputs(std::vector<float>& startValues, std::vector<float>& deltaValues)
+	{
+		const size_t numberOfFloats = NUMBER_OF_UNIFORMS_TO_LERP * 4;
+		startValues.resize(numberOfFloats);
+		deltaValues.resize(numberOfFloats);
+		for(size_t i = 0; i < numberOfFloats; i++)
+		{
+			startValues[i] = (float)(i % 97) * 0.25f;
+			deltaValues[i] = (float)(i % 13) - 6.0f;
+		}
+	}
+
+
+	static void lerpFloats(benchmark::State& state)
+	{
+		const auto kernelToUse = (IGCS::LerpUtils::LerpKernel)state.range(0);
+		if(kernelToUse > IGCS::LerpUtils::bestSupportedLerpKernel())
+		{
+			state.SkipWithError("kernel not supported by this CPU");
+			return;
+		}
+		std::vector<float> startValues, deltaValues;
+		createLerpInputs(startValues, deltaValues);
+		std::vector<float> interpolatedValues(startValues.size());
+		for(auto _ : state)
+		{
+			IGCS::LerpUtils::lerpFloats(startValues.data(), deltaValues.data(), 0.5f, interpolatedValues.data(), startValues.size(), kernelToUse);
+			benchmark::DoNotOptimize(interpolatedValues.data());
+		}
+		state.SetBytesProcessed(state.iterations() * startValues.size() * sizeof(float) * 2);
+		state.SetLabel(IGCS::LerpUtils::lerpKernelName(kernelToUse));
+	}
+	BENCHMARK(lerpFloats)->DenseRange((int)IGCS::LerpUtils::LerpKernel::Scalar, (int)IGCS::LerpUtils::LerpKernel::AVX);
+
+
+	static void evaluateCubicFloats(benchmark::State& state)
+	{
+		const auto kernelToUse = (IGCS::LerpUtils::LerpKernel)state.range(0);
+		if(kernelToUse > IGCS::LerpUtils::bestSupportedLerpKernel())
+		{
+			state.SkipWithError("kernel not supported by this CPU");
+			return;
+		}
+		std::vector<float> startValues, deltaValues;
+		createLerpInputs(startValues, deltaValues);
+		std::vector<float> interpolatedValues(startValues.size());
+		for(auto _ : state)
+		{
+			IGCS::LerpUtils::evaluateCubicFloats(startValues.data(), deltaValues.data(), deltaValues.data(), startValues.data(), 0.5f, interpolatedValues.data(), 
+												 startValues.size(), kernelToUse);
+			benchmark::DoNotOptimize(interpolatedValues.data());
+		}
+		state.SetBytesProcessed(state.iterations() * startValues.size() * sizeof(float) * 4);
+		state.SetLabel(IGCS::LerpUtils::lerpKernelName(kernelToUse));
+	}
+	BENCHMARK(evaluateCubicFloats)->DenseRange((int)IGCS::LerpUtils::LerpKernel::Scalar, (int)IGCS::LerpUtils::LerpKernel::AVX);
+
+
+	static void obtainReshadeState(benchmark::State& state)
+	{
+		FakeEffectRuntime runtime;
+		addSyntheticPreset(runtime, 0.0f);
+		for(auto _ : state)
+		{
+			ReshadeStateSnapshot snapshot;
+			snapshot.obtainReshadeState(&runtime);
+			benchmark::DoNotOptimize(snapshot);
+		}
+	}
+	BENCHMARK(obtainReshadeState)->Unit(benchmark::kMicrosecond);
+
+
+	/// <summary>
+	/// Obtains two states of the synthetic preset which differ in all their float uniforms.
+	/// </summary>
+	static void obtainTwoStates(FakeEffectRuntime& runtime, ReshadeStateSnapshot& startState, ReshadeStateSnapshot& endState)
+	{
+		addSyntheticPreset(runtime, 0.0f);
+		startState.obtainReshadeState(&runtime);
+		FakeEffectRuntime endRuntime;
+		addSyntheticPreset(endRuntime, 10.0f);
+		endState.obtainReshadeState(&endRuntime);
+	}
+
+
+	static void applyInterpolationPlan(benchmark::State& state)
+	{
+		FakeEffectRuntime runtime;
+		ReshadeStateSnapshot startState, endState;
+		obtainTwoStates(runtime, startState, endState);
+		StateInterpolationPlan plan;
+		startState.compileInterpolationPlan(endState, plan);
+		float interpolationFactor = 0.0f;
+		for(auto _ : state)
+		{
+			interpolationFactor = interpolationFactor >= 1.0f ? 0.0f : interpolationFactor + 0.01f;
+			plan.apply(&runtime, interpolationFactor, false);
+		}
+		state.SetLabel(IGCS::Utils::formatString("%d effects", startState.numberOfContainedEffects()));
+	}
+	BENCHMARK(applyInterpolationPlan)->Unit(benchmark::kMicrosecond);
+
+
+	/// <summary>
+	/// Arguments: the blur type and the quality.
+	/// </summary>
+	static void calculateShapePoints(benchmark::State& state)
+	{
+		CameraToolsConnector connector;
+		DepthOfFieldController controller(connector);
+		controller.setBlurType((DepthOfFieldBlurType)state.range(0));
+		controller.setQuality((int)state.range(1));
+		for(auto _ : state)
+		{
+			controller.calculateShapePoints();
+		}
+		state.SetLabel(IGCS::Utils::formatString("%d points", controller.getTotalNumberOfStepsToTake()));
+	}
+	BENCHMARK(calculateShapePoints)->ArgsProduct({ { (int)DepthOfFieldBlurType::Circular, (int)DepthOfFieldBlurType::ApertureShape }, { 1, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100 } })
+		->Unit(benchmark::kMicrosecond);
+
+
+	static void loadIniFile(benchmark::State& state)
+	{
+		// an ini file a lot larger than ours, so the parsing dominates and not the file open.
+		const std::string iniFilename = (std::filesystem::temp_directory_path() / "IgcsConnector_benchmark.ini").string();
+		{
+			CDataFile iniFile;
+			for(int section = 0; section < 20; section++)
+			{
+				for(int key = 0; key < 50; key++)
+				{
+					iniFile.SetValue(IGCS::Utils::formatString("Key%d", key), IGCS::Utils::formatString("%f", section * 0.5f + key), "", IGCS::Utils::formatString("Section%d", section));
+				}
+			}
+			iniFile.SetFileName(iniFilename);
+			if(!iniFile.Save())
+			{
+				state.SkipWithError("writing the ini file failed");
+				return;
+			}
+		}
+		for(auto _ : state)
+		{
+			CDataFile iniFile;
+			iniFile.Load(iniFilename);
+			// loading marks the file as changed, which would make the destructor try to save it.
+			iniFile.Clear();
+		}
+		state.SetLabel("20 sections, 50 keys each");
+		std::filesystem::remove(iniFilename);
+	}
+	BENCHMARK(loadIniFile)->Unit(benchmark::kMicrosecond);
+
+
+	/// <summary>
+	/// The work queue as it was before it was made lock-free: a std::queue guarded by a mutex. Used as the baseline for the ThreadSafeQueue benchmark.
+	/// </summary>
+	struct MutexGuardedQueue
+	{
+		std::mutex mutex;
+		std::queue<uint64_t> queue;
+
+		// unbounded, like the old queue was, so this never fails.
+		bool tryPush(uint64_t item)
+		{
+			std::scoped_lock lock(mutex);
+			queue.push(item);
+			return true;
+		}
+
+		template<typename TFunc>
+		size_t drain(TFunc&& elementFunc)
+		{
+			size_t numberOfElementsDrained = 0;
+			for(;;)
+			{
+				uint64_t item;
+				{
+					std::scoped_lock lock(mutex);
+					if(queue.empty())
+					{
+						return numberOfElementsDrained;
+					}
+					item = queue.front();
+					queue.pop();
+				}
+				numberOfElementsDrained++;
+				elementFunc(std::move(item));
+			}
+		}
+	};
+
+
+	template<typename TQueue>
+	void transferItemsThroughQueue(TQueue& queue)
+	{
+		// the producers push concurrently, like the camera tools and the UI do, while this thread consumes like the present thread does.
+		std::vector<std::thread> producers;
+		for(int producerIndex = 0; producerIndex < NUMBER_OF_QUEUE_PRODUCERS; producerIndex++)
+		{
+			producers.emplace_back([&queue, producerIndex]
+			{
+				for(int i = 0; i < NUMBER_OF_ITEMS_PER_QUEUE_PRODUCER; i++)
+				{
+					while(!queue.tryPush(((uint64_t)producerIndex << 32) | (uint32_t)i))
+					{
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+		uint64_t checksum = 0;
+		size_t numberOfItemsReceived = 0;
+		const size_t numberOfItemsToReceive = (size_t)NUMBER_OF_QUEUE_PRODUCERS * NUMBER_OF_ITEMS_PER_QUEUE_PRODUCER;
+		while(numberOfItemsReceived < numberOfItemsToReceive)
+		{
+			const size_t numberOfItemsDrained = queue.drain([&checksum](uint64_t&& item) { checksum += item; });
+			if(numberOfItemsDrained == 0)
+			{
+				// let the producers run, which matters when they share a core with this thread.
+				std::this_thread::yield();
+			}
+			numberOfItemsReceived += numberOfItemsDrained;
+		}
+		for(auto& producer : producers)
+		{
+			producer.join();
+		}
+		benchmark::DoNotOptimize(checksum);
+	}
+
+
+	template<size_t Capacity>
+	void workQueueLockFree(benchmark::State& state)
+	{
+		auto queue = std::make_unique<IGCS::ThreadSafeQueue<uint64_t, Capacity>>();
+		for(auto _ : state)
+		{
+			transferItemsThroughQueue(*queue);
+		}
+		state.SetItemsProcessed(state.iterations() * NUMBER_OF_QUEUE_PRODUCERS * NUMBER_OF_ITEMS_PER_QUEUE_PRODUCER);
+	}
+	// the default capacity, and a small one to see what producers waiting for room cost.
+	BENCHMARK_TEMPLATE(workQueueLockFree, 1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+	BENCHMARK_TEMPLATE(workQueueLockFree, 64)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+	static void workQueueMutexBaseline(benchmark::State& state)
+	{
+		MutexGuardedQueue queue;
+		for(auto _ : state)
+		{
+			transferItemsThroughQueue(queue);
+		}
+		state.SetItemsProcessed(state.iterations() * NUMBER_OF_QUEUE_PRODUCERS * NUMBER_OF_ITEMS_PER_QUEUE_PRODUCER);
+	}
+	BENCHMARK(workQueueMutexBaseline)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+
+	/// <summary>
+	/// Fills all fields of the camera data with values derived from the value specified.
+	/// </summary>
+	static void fillCameraToolsData(CameraToolsData& toFill, uint32_t value)
+	{
+		// floats represent integers exactly up to 2^24.
+		const float valueAsFloat = (float)(value & 0xFFFFFF);
+		toFill.cameraEnabled = (uint8_t)(value & 1);
+		toFill.cameraMovementLocked = (uint8_t)(value & 1);
+		toFill.fov = valueAsFloat;
+		toFill.coordinates.setValues(valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.lookQuaternion.setValues(valueAsFloat, valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.rotationMatrixUpVector.setValues(valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.rotationMatrixRightVector.setValues(valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.rotationMatrixForwardVector.setValues(valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.pitch = valueAsFloat;
+		toFill.yaw = valueAsFloat;
+		toFill.roll = valueAsFloat;
+	}
+
+
+	static void cameraToolsDataExchange(benchmark::State& state)
+	{
+		// the calling thread reads while the writer thread writes as fast as it can. Whether the copies read are consistent is tested in
+		// CameraToolsDataExchangeTests.
+		auto exchange = std::make_unique<CameraToolsDataExchange>();
+		memset(exchange.get(), 0, sizeof(CameraToolsDataExchange));
+		uint32_t valueWritten = 0;
+		size_t numberOfReads = 0;
+		for(auto _ : state)
+		{
+			std::atomic<bool> writerDone = false;
+			std::thread writer([&exchange, &writerDone, firstValue = valueWritten]
+			{
+				CameraToolsData toWrite;
+				for(uint32_t i = 1; i <= NUMBER_OF_CAMERA_DATA_WRITES; i++)
+				{
+					fillCameraToolsData(toWrite, firstValue + i);
+					exchange->write(toWrite);
+				}
+				writerDone.store(true, std::memory_order_release);
+			});
+			CameraToolsData snapshot;
+			while(!writerDone.load(std::memory_order_acquire))
+			{
+				if(exchange->read(snapshot))
+				{
+					numberOfReads++;
+				}
+			}
+			writer.join();
+			benchmark::DoNotOptimize(snapshot);
+			valueWritten += NUMBER_OF_CAMERA_DATA_WRITES;
+		}
+		state.SetItemsProcessed(state.iterations() * NUMBER_OF_CAMERA_DATA_WRITES);
+		state.counters["reads"] = (double)numberOfReads;
+	}
+	BENCHMARK(cameraToolsDataExchange)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
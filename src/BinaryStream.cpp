@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "BinaryStream.h"
+
+namespace IGCS
+{
+	void BinaryWriter::writeBytes(const void* source, size_t numberOfBytes)
+	{
+		const uint8_t* sourceBytes = static_cast<const uint8_t*>(source);
+		_data.insert(_data.end(), sourceBytes, sourceBytes + numberOfBytes);
+	}
+
+
+	void BinaryWriter::writeString(const std::string& toWrite)
+	{
+		write((uint32_t)toWrite.size());
+		writeBytes(toWrite.data(), toWrite.size());
+		const size_t padding = (4 - (toWrite.size() % 4)) % 4;
+		_data.insert(_data.end(), padding, 0);
+	}
+
+
+	void BinaryWriter::writeSymbol(SymbolTable::Symbol toWrite)
+	{
+		auto [it, isNew] = _nameIndexPerSymbol.try_emplace(toWrite, (uint32_t)_namesWritten.size());
+		if(isNew)
+		{
+			_namesWritten.push_back(toWrite);
+		}
+		write(it->second);
+	}
+
+
+	bool BinaryReader::readBytes(void* destination, size_t numberOfBytes)
+	{
+		if(!hasBytesLeft(numberOfBytes))
+		{
+			_failed = true;
+			return false;
+		}
+		memcpy(destination, _current, numberOfBytes);
+		_current += numberOfBytes;
+		return true;
+	}
+
+
+	bool BinaryReader::readString(std::string& toRead)
+	{
+		uint32_t length = 0;
+		if(!read(length))
+		{
+			return false;
+		}
+		const size_t paddedLength = ((size_t)length + 3) & ~(size_t)3;
+		if(!hasBytesLeft(paddedLength))
+		{
+			_failed = true;
+			return false;
+		}
+		toRead.assign(reinterpret_cast<const char*>(_current), length);
+		_current += paddedLength;
+		return true;
+	}
+
+
+	bool BinaryReader::readSymbol(SymbolTable::Symbol& toRead)
+	{
+		uint32_t nameIndex = 0;
+		if(!read(nameIndex))
+		{
+			return false;
+		}
+		if(nameIndex >= _symbolPerNameIndex.size())
+		{
+			_failed = true;
+			return false;
+		}
+		toRead = _symbolPerNameIndex[nameIndex];
+		return true;
+	}
+}
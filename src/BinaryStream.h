@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "SymbolTable.h"
+
+namespace IGCS
+{
+	/// <summary>
+	/// Writes values as raw little endian bytes into a growing buffer. Symbols are written as an index into a table of the names written, as symbols are only
+	/// valid during the current process. The table is obtained with namesWritten() and has to be stored with the data.
+	/// </summary>
+	class BinaryWriter
+	{
+	public:
+		template<typename T>
+		void write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as raw bytes");
+			writeBytes(&value, sizeof(T));
+		}
+		void writeBytes(const void* source, size_t numberOfBytes);
+		/// <summary>
+		/// Writes the length as uint32_t, followed by the characters, padded to a multiple of 4 bytes so the data after it stays aligned.
+		/// </summary>
+		void writeString(const std::string& toWrite);
+		void writeSymbol(SymbolTable::Symbol toWrite);
+		/// <summary>
+		/// Appends the data of the writer specified. Symbols written by toAppend are not remapped, so only append writers which don't write symbols.
+		/// </summary>
+		void append(const BinaryWriter& toAppend) { writeBytes(toAppend._data.data(), toAppend._data.size()); }
+
+		const std::vector<uint8_t>& data() const { return _data; }
+		/// <summary>
+		/// The symbols written with writeSymbol, in the order of their index.
+		/// </summary>
+		const std::vector<SymbolTable::Symbol>& namesWritten() const { return _namesWritten; }
+
+	private:
+		std::vector<uint8_t> _data;
+		std::vector<SymbolTable::Symbol> _namesWritten;
+		std::unordered_map<SymbolTable::Symbol, uint32_t> _nameIndexPerSymbol;
+	};
+
+
+	/// <summary>
+	/// Reads values written by BinaryWriter from a block of memory, e.g. a mapped file. Every read is bounds checked: if there's not enough data left, the read fails and 
+	/// the reader is marked as failed, so a corrupt file can't cause reads past the end of the data.
+	/// </summary>
+	class BinaryReader
+	{
+	public:
+		BinaryReader(const uint8_t* data, size_t size) : _current(data), _end(data + size) {}
+
+		template<typename T>
+		bool read(T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as raw bytes");
+			return readBytes(&value, sizeof(T));
+		}
+		bool readBytes(void* destination, size_t numberOfBytes);
+		bool readString(std::string& toRead);
+		/// <summary>
+		/// Reads a symbol written with BinaryWriter::writeSymbol. The names table has to be set with setNames first.
+		/// </summary>
+		bool readSymbol(SymbolTable::Symbol& toRead);
+		/// <summary>
+		/// Returns true if at least numberOfBytes bytes are left. Use it to validate counts read before allocating for them.
+		/// </summary>
+		bool hasBytesLeft(size_t numberOfBytes) const { return !_failed && (size_t)(_end - _current) >= numberOfBytes; }
+
+		void setNames(std::vector<SymbolTable::Symbol> symbolPerNameIndex) { _symbolPerNameIndex = std::move(symbolPerNameIndex); }
+		bool hasFailed() const { return _failed; }
+
+	private:
+		const uint8_t* _current;
+		const uint8_t* _end;
+		bool _failed = false;
+		std::vector<SymbolTable::Symbol> _symbolPerNameIndex;
+	};
+}
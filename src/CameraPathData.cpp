@@ -34,27 +34,13 @@
 #include "CameraPathData.h"
 #include "Utils.h"
 #include "ReshadeStateSnapshot.h"
-
-CameraPathData::CameraPathData() : CameraPathData(false)
-{
-}
-
-CameraPathData::CameraPathData(bool isNonExisting) : _isNonExisting(isNonExisting)
-{
-}
-
-
-CameraPathData& CameraPathData::getNonExisting()
-{
-	static CameraPathData nonExistingInstance(true);
-
-	return nonExistingInstance;
-}
-
+#include <algorithm>
+#include <unordered_set>
 
 void CameraPathData::appendStateSnapshot(const ReshadeStateSnapshot& toAppend)
 {
 	_snapshots.push_back(toAppend);
+	shareUnchangedStateWithPreviousSnapshots(_snapshots.size() - 1);
 }
 
 
@@ -69,6 +55,7 @@ void CameraPathData::insertStateSnapshotBeforeSnapshot(int indexToInsertBefore,
 	_snapshots.insert(_snapshots.begin() + indexToInsertBefore, reshadeStateSnapshot);
 	// propagate the effects which are enabled in the new node to the following nodes.
 	propagateNewlyEnabledEffects(indexToInsertBefore, onlyNewlyEnabledEffectsSnapshot);
+	shareUnchangedStateWithPreviousSnapshots(indexToInsertBefore);
 }
 
 
@@ -78,11 +65,11 @@ void CameraPathData::appendStateSnapshotAfterSnapshot(int indexToAppendAfter, co
 	{
 		return;
 	}
-
 	if(indexToAppendAfter==_snapshots.size()-1)
 	{
 		// last node, append
 		_snapshots.push_back(reshadeStateSnapshot);
+		shareUnchangedStateWithPreviousSnapshots(_snapshots.size() - 1);
 	}
 	else
 	{
@@ -92,6 +79,7 @@ void CameraPathData::appendStateSnapshotAfterSnapshot(int indexToAppendAfter, co
 		// propagate the effects which are enabled in the new node to the following nodes.
 		// pass + 2 as we've inserted a new entry!
 		propagateNewlyEnabledEffects(indexToAppendAfter + 2, onlyNewlyEnabledEffectsSnapshot);
+		shareUnchangedStateWithPreviousSnapshots(indexToAppendAfter + 1);
 	}
 }
 
@@ -112,12 +100,12 @@ void CameraPathData::updateStateSnapshot(const ReshadeStateSnapshot& snapshot, i
 	{
 		return;
 	}
-
 	// we first have to check which shaders are now enabled. These have to be copied to the nodes after this one so it's easy for the user to define effect states on an existing path.
 	const auto& currentSnapshot = _snapshots[stateIndex];
 	const auto onlyNewlyEnabledEffectsSnapshot = snapshot.getNewlyEnabledEffects(currentSnapshot);
 	_snapshots[stateIndex] = snapshot;
 	propagateNewlyEnabledEffects(stateIndex+1, onlyNewlyEnabledEffectsSnapshot);
+	shareUnchangedStateWithPreviousSnapshots(stateIndex);
 }
 
 
@@ -127,28 +115,47 @@ void CameraPathData::migratedContainedHandles(const ReshadeStateSnapshot& curren
 	{
 		snapshot.migrateState(currentState);
 	}
+	shareUnchangedStateWithPreviousSnapshots(0);
 }
 
 
-void CameraPathData::setReshadeState(int fromStateIndex, int toStateIndex, float interpolationFactor, reshade::api::effect_runtime* runtime)
+bool CameraPathData::isBoundTo(const ReshadeStateSnapshot& currentState) const
+{
+	return std::ranges::all_of(_snapshots, [&currentState](const ReshadeStateSnapshot& snapshot) { return snapshot.isBoundTo(currentState); });
+}
+
+
+bool CameraPathData::compileInterpolationPlan(int fromStateIndex, int toStateIndex, StateInterpolationMode interpolationMode, StateInterpolationPlan& plan) const
 {
 	if(fromStateIndex<0 || toStateIndex < 0 || fromStateIndex>=_snapshots.size() || toStateIndex >= _snapshots.size())
 	{
-		return;
+		return false;
 	}
-	ReshadeStateSnapshot& fromState = _snapshots[fromStateIndex];
-	const ReshadeStateSnapshot& toState = _snapshots[toStateIndex];
-	fromState.applyStateFromTo(toState, interpolationFactor, runtime);
+	if(interpolationMode == StateInterpolationMode::CatmullRom && fromStateIndex != toStateIndex)
+	{
+		// the path can be played in either direction, so the state before the segment is the one on the other side of fromStateIndex.
+		const int direction = toStateIndex > fromStateIndex ? 1 : -1;
+		const int previousStateIndex = fromStateIndex - direction;
+		const int nextStateIndex = toStateIndex + direction;
+		const ReshadeStateSnapshot* previousState = (previousStateIndex >= 0 && previousStateIndex < _snapshots.size()) ? &_snapshots[previousStateIndex] : nullptr;
+		const ReshadeStateSnapshot* nextState = (nextStateIndex >= 0 && nextStateIndex < _snapshots.size()) ? &_snapshots[nextStateIndex] : nullptr;
+		_snapshots[fromStateIndex].compileSplineInterpolationPlan(previousState, _snapshots[toStateIndex], nextState, plan);
+	}
+	else
+	{
+		_snapshots[fromStateIndex].compileInterpolationPlan(_snapshots[toStateIndex], plan);
+	}
+	return true;
 }
 
 
-void CameraPathData::setReshadeState(int stateIndex, reshade::api::effect_runtime* runtime)
+void CameraPathData::setReshadeState(int stateIndex, reshade::api::effect_runtime* runtime) const
 {
 	if(stateIndex < 0 || stateIndex >= _snapshots.size())
 	{
 		return;
 	}
-	ReshadeStateSnapshot& state = _snapshots[stateIndex];
+	const ReshadeStateSnapshot& state = _snapshots[stateIndex];
 	state.applyState(runtime);
 }
 
@@ -165,3 +172,56 @@ void CameraPathData::propagateNewlyEnabledEffects(int startIndex, const ReshadeS
 		snapshot.addNewlyEnabledEffects(snapShotWithNewlyEnabledEffectsToCopy);
 	}
 }
+
+
+void CameraPathData::shareUnchangedStateWithPreviousSnapshots(int startIndex)
+{
+	// a snapshot which is the same as the one before it shares all of that one's blocks, so a run of equal snapshots all share the blocks of the first.
+	for(int i = startIndex < 1 ? 1 : startIndex; i < _snapshots.size(); i++)
+	{
+		_snapshots[i].shareUnchangedStateWith(_snapshots[i - 1]);
+	}
+}
+
+
+size_t CameraPathData::memoryUsageInBytes() const
+{
+	std::unordered_set<const void*> blocksCounted;
+	size_t toReturn = _snapshots.capacity() * sizeof(ReshadeStateSnapshot);
+	for(const auto& snapshot : _snapshots)
+	{
+		toReturn += snapshot.memoryUsageInBytes(blocksCounted) - sizeof(ReshadeStateSnapshot);
+	}
+	return toReturn;
+}
+
+
+void CameraPathData::writeTo(IGCS::BinaryWriter& writer) const
+{
+	writer.write((uint32_t)_snapshots.size());
+	for(const auto& snapshot : _snapshots)
+	{
+		snapshot.writeTo(writer);
+	}
+}
+
+
+bool CameraPathData::readFrom(IGCS::BinaryReader& reader)
+{
+	uint32_t numberOfSnapshots = 0;
+	if(!reader.read(numberOfSnapshots) || !reader.hasBytesLeft((size_t)numberOfSnapshots * 2 * sizeof(uint32_t)))
+	{
+		return false;
+	}
+	_snapshots.clear();
+	_snapshots.resize(numberOfSnapshots);
+	for(auto& snapshot : _snapshots)
+	{
+		if(!snapshot.readFrom(reader))
+		{
+			return false;
+		}
+	}
+	shareUnchangedStateWithPreviousSnapshots(0);
+	return true;
+}
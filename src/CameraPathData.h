@@ -32,33 +32,50 @@
 /////////////////////////////////////////////////////////////////////////
 
 #pragma once
+#include "BinaryStream.h"
+#include "ConstantsEnums.h"
 #include "ReshadeStateSnapshot.h"
+#include "StateInterpolationPlan.h"
 
 /// <summary>
 /// Class which contains the reshade states for a path.
 /// </summary>
+/// <remarks>Once published by the ReshadeStateController a path is immutable, as other threads might read it. Changes are made to a copy, which is cheap as
+///	the snapshots share their data.</remarks>
 class CameraPathData
 {
 public:
-	CameraPathData();
-
-	static CameraPathData& getNonExisting();
-
 	void appendStateSnapshot(const ReshadeStateSnapshot& toAppend);
 	void removeStateSnapshot(int stateIndex);
 	void updateStateSnapshot(const ReshadeStateSnapshot& snapshot, int stateIndex);
 	void migratedContainedHandles(const ReshadeStateSnapshot& currentState);
-	void setReshadeState(int fromStateIndex, int toStateIndex, float interpolationFactor, reshade::api::effect_runtime* runtime);
-	void setReshadeState(int stateIndex, reshade::api::effect_runtime* runtime);
+	/// <summary>
+	/// Returns true if all snapshots already use the ids in currentState, so migratedContainedHandles wouldn't change anything.
+	/// </summary>
+	bool isBoundTo(const ReshadeStateSnapshot& currentState) const;
+	/// <summary>
+	/// Compiles the interpolation between the snapshots at fromStateIndex and toStateIndex into the plan specified. With StateInterpolationMode::CatmullRom the snapshots
+	///	before fromStateIndex and after toStateIndex are used as well. Returns false if the indices are invalid.
+	/// </summary>
+	bool compileInterpolationPlan(int fromStateIndex, int toStateIndex, StateInterpolationMode interpolationMode, StateInterpolationPlan& plan) const;
+	void setReshadeState(int stateIndex, reshade::api::effect_runtime* runtime) const;
 	void insertStateSnapshotBeforeSnapshot(int indexToInsertBefore, const ReshadeStateSnapshot& reshadeStateSnapshot);
 	void appendStateSnapshotAfterSnapshot(int indexToAppendAfter, const ReshadeStateSnapshot& reshadeStateSnapshot);
 
-	bool isNonExisting() { return _isNonExisting; }
-	int numberOfSnapshots() { return _snapshots.size(); }
+	void writeTo(IGCS::BinaryWriter& writer) const;
+	/// <summary>
+	/// Reads the snapshots written by writeTo. Returns false if the data is corrupt. The snapshots read don't have valid ids, call migratedContainedHandles afterwards.
+	/// </summary>
+	bool readFrom(IGCS::BinaryReader& reader);
+
+	/// <summary>
+	/// Returns the number of bytes used by the snapshots of this path. Data shared between snapshots is counted once.
+	/// </summary>
+	size_t memoryUsageInBytes() const;
 
-private:
-	CameraPathData(bool isNonExisting);
+	int numberOfSnapshots() const { return _snapshots.size(); }
 
+private:
 	/// <summary>
 	/// Copies the effects present in snapShotWithNewlyEnabledEffectsToCopy to the snapshots starting at index startIndex if they're not already
 	///	present. 
@@ -66,8 +83,11 @@ private:
 	/// <param name="startIndex"></param>
 	/// <param name="snapShotWithNewlyEnabledEffectsToCopy"></param>
 	void propagateNewlyEnabledEffects(int startIndex, const ReshadeStateSnapshot& snapShotWithNewlyEnabledEffectsToCopy);
-
-	bool _isNonExisting = false;
+	/// <summary>
+	/// Makes the snapshots from startIndex onwards share the data they have in common with the snapshot before them. Has to be called after every change to the
+	///	snapshots, as adjacent snapshots mostly differ in only a few uniforms.
+	/// </summary>
+	void shareUnchangedStateWithPreviousSnapshots(int startIndex);
 
 	std::vector<ReshadeStateSnapshot> _snapshots;
 };
@@ -33,36 +33,19 @@
 #include "stdafx.h"
 #include "CameraToolsConnector.h"
 #include "OverlayControl.h"
+#include "Platform.h"
 
 
 void CameraToolsConnector::connectToCameraTools()
 {
-	// Enumerate all modules in the process and check if they export a defined function (IGCS_StartScreenshotSession). If so, we map to the known functions. 
-	const HANDLE processHandle = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, GetCurrentProcessId());
-	if(nullptr == processHandle)
+	// Find the module in the process which exports a defined function (IGCS_StartScreenshotSession). If found, we map to the known functions. 
+	void* cameraToolsModule = IGCS::Platform::findModuleExportingFunction("IGCS_StartScreenshotSession");
+	if(nullptr != cameraToolsModule)
 	{
-		return;
-	}
-	HMODULE modules[512];
-	DWORD cbNeeded;
-	if(EnumProcessModules(processHandle, modules, sizeof(modules), &cbNeeded))
-	{
-		for(int i = 0; i < cbNeeded / sizeof(HMODULE); i++)
-		{
-			// check if this module exports the IGCS_StartScreenshotSession function.
-			const HMODULE moduleHandle = modules[i];
-			_igcs_StartScreenshotSessionFunc = (IGCS_StartScreenshotSession)GetProcAddress(moduleHandle, "IGCS_StartScreenshotSession");
-			if(nullptr == _igcs_StartScreenshotSessionFunc)
-			{
-				// doesn't export it, not an IGCS camera tools dll
-				continue;
-			}
-			// map the other functions
-			_igcs_EndScreenshotSessionFunc = (IGCS_EndScreenshotSession)GetProcAddress(moduleHandle, "IGCS_EndScreenshotSession");
-			_igcs_MoveCameraPanoramaFunc = (IGCS_MoveCameraPanorama)GetProcAddress(moduleHandle, "IGCS_MoveCameraPanorama");
-			_igcs_MoveCameraMultishotFunc = (IGCS_MoveCameraMultishot)GetProcAddress(moduleHandle, "IGCS_MoveCameraMultishot");
-			break;
-		}
+		_igcs_StartScreenshotSessionFunc = (IGCS_StartScreenshotSession)IGCS::Platform::getExportedFunction(cameraToolsModule, "IGCS_StartScreenshotSession");
+		_igcs_EndScreenshotSessionFunc = (IGCS_EndScreenshotSession)IGCS::Platform::getExportedFunction(cameraToolsModule, "IGCS_EndScreenshotSession");
+		_igcs_MoveCameraPanoramaFunc = (IGCS_MoveCameraPanorama)IGCS::Platform::getExportedFunction(cameraToolsModule, "IGCS_MoveCameraPanorama");
+		_igcs_MoveCameraMultishotFunc = (IGCS_MoveCameraMultishot)IGCS::Platform::getExportedFunction(cameraToolsModule, "IGCS_MoveCameraMultishot");
 	}
 	OverlayControl::addNotification(cameraToolsConnected() ? "Camera tools connected" : "No camera tools found");
 }
@@ -40,6 +40,8 @@ struct Vec3
 
 	//----------------------------------
 	// Methods below this line
+	Vec3() : values{ 0.0f, 0.0f, 0.0f } {}
+
 	explicit Vec3(float xyz[3])
 	{
 		values[0] = xyz[0];
@@ -71,6 +73,8 @@ struct Vec4
 
 	//----------------------------------
 	// Methods below this line
+	Vec4() : values{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+
 	explicit Vec4(float xyzw[4])
 	{
 		values[0] = xyzw[0];
@@ -101,17 +105,17 @@ struct Vec4
 
 struct CameraToolsData
 {
-	uint8_t cameraEnabled;					// 1 is enabled 0 is not enabled
-	uint8_t cameraMovementLocked;			// 1 is camera movement is locked, 0 is camera movement isn't locked.
-	uint8_t reserved1;
-	uint8_t reserved2;
-	float fov;								// in degrees
+	uint8_t cameraEnabled = 0;				// 1 is enabled 0 is not enabled
+	uint8_t cameraMovementLocked = 0;		// 1 is camera movement is locked, 0 is camera movement isn't locked.
+	uint8_t reserved1 = 0;
+	uint8_t reserved2 = 0;
+	float fov = 0.0f;						// in degrees
 	Vec3 coordinates;						// camera coordinates (x, y, z)
 	Vec4 lookQuaternion;					// camera look quaternion qx, qy, qz, qw
 	Vec3 rotationMatrixUpVector;			// up vector from the rotation matrix calculated from the look quaternion. 
 	Vec3 rotationMatrixRightVector;			// right vector from the rotation matrix calculated from the look quaternion. 
 	Vec3 rotationMatrixForwardVector;		// forward vector from the rotation matrix calculated from the look quaternion. 
-	float pitch;							// in radians
-	float yaw;
-	float roll;
+	float pitch = 0.0f;						// in radians
+	float yaw = 0.0f;
+	float roll = 0.0f;
 };
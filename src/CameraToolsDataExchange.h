@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include "CameraToolsData.h"
+
+// offset of the CameraToolsDataExchange in the buffer returned by getDataFromCameraToolsBuffer. The start of the buffer is still the plain CameraToolsData
+// written by camera tools which don't use the exchange.
+#define CAMERA_TOOLS_DATA_EXCHANGE_OFFSET	4096
+#define CAMERA_TOOLS_DATA_EXCHANGE_VERSION	1
+// the number of times a read is retried before it gives up. A write takes a few nanoseconds, so this is only reached if the writer stopped halfway, e.g.
+// because the game was suspended or crashed while writing.
+#define CAMERA_TOOLS_DATA_EXCHANGE_MAX_READ_ATTEMPTS	1000
+
+/// <summary>
+/// Seqlock protected CameraToolsData, written by the camera tools and read by the addon. The sequence number is odd while a write is in progress, so a reader
+/// which sees the same even sequence number before and after copying the data has a consistent copy. The writer never waits, readers retry instead, a
+/// bounded number of times.
+/// </summary>
+/// <remarks>The layout is shared with the camera tools, so fields can only be appended, together with a bump of the version. All fields are accessed
+///	through std::atomic_ref, as the other side of the exchange reads/writes them at the same time.</remarks>
+struct CameraToolsDataExchange
+{
+	uint32_t version;			// CAMERA_TOOLS_DATA_EXCHANGE_VERSION after the first write, 0 if the camera tools don't use the exchange.
+	uint32_t sequence;			// odd while a write is in progress.
+	uint32_t data[sizeof(CameraToolsData) / sizeof(uint32_t)];
+
+	//----------------------------------
+	// Methods below this line
+
+	/// <summary>
+	/// Writes the data specified. Has to be called from a single thread.
+	/// </summary>
+	void write(const CameraToolsData& toWrite)
+	{
+		uint32_t words[sizeof(data) / sizeof(uint32_t)];
+		memcpy(words, &toWrite, sizeof(words));
+		std::atomic_ref<uint32_t> sequenceRef(sequence);
+		// single writer, so the sequence number doesn't need a read-modify-write.
+		const uint32_t startSequence = sequenceRef.load(std::memory_order_relaxed);
+		sequenceRef.store(startSequence + 1, std::memory_order_relaxed);
+		// the odd sequence number has to be visible before any of the data is.
+		std::atomic_thread_fence(std::memory_order_release);
+		for(size_t i = 0; i < sizeof(words) / sizeof(uint32_t); i++)
+		{
+			std::atomic_ref<uint32_t>(data[i]).store(words[i], std::memory_order_relaxed);
+		}
+		std::atomic_ref<uint32_t>(version).store(CAMERA_TOOLS_DATA_EXCHANGE_VERSION, std::memory_order_relaxed);
+		sequenceRef.store(startSequence + 2, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Returns true if the camera tools wrote to the exchange at least once.
+	/// </summary>
+	bool isWrittenTo()
+	{
+		return std::atomic_ref<uint32_t>(version).load(std::memory_order_acquire) == CAMERA_TOOLS_DATA_EXCHANGE_VERSION;
+	}
+
+	/// <summary>
+	/// Copies the last written data into snapshot. Returns false if the camera tools never wrote to the exchange or if no consistent copy could be made
+	/// within CAMERA_TOOLS_DATA_EXCHANGE_MAX_READ_ATTEMPTS attempts. Snapshot is left untouched in both cases, use isWrittenTo to tell them apart.
+	/// </summary>
+	bool read(CameraToolsData& snapshot)
+	{
+		std::atomic_ref<uint32_t> sequenceRef(sequence);
+		uint32_t words[sizeof(data) / sizeof(uint32_t)];
+		for(int attempt = 0; attempt < CAMERA_TOOLS_DATA_EXCHANGE_MAX_READ_ATTEMPTS; attempt++)
+		{
+			const uint32_t startSequence = sequenceRef.load(std::memory_order_acquire);
+			if(startSequence & 1)
+			{
+				// a write is in progress, which takes a few nanoseconds.
+				std::this_thread::yield();
+				continue;
+			}
+			if(std::atomic_ref<uint32_t>(version).load(std::memory_order_relaxed) != CAMERA_TOOLS_DATA_EXCHANGE_VERSION)
+			{
+				return false;
+			}
+			for(size_t i = 0; i < sizeof(words) / sizeof(uint32_t); i++)
+			{
+				words[i] = std::atomic_ref<uint32_t>(data[i]).load(std::memory_order_relaxed);
+			}
+			// the data has to be read before the sequence number is read again.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(sequenceRef.load(std::memory_order_relaxed) == startSequence)
+			{
+				memcpy(&snapshot, words, sizeof(words));
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+static_assert(std::is_trivially_copyable_v<CameraToolsData>, "CameraToolsData is exchanged as raw words");
+static_assert(sizeof(CameraToolsData) % sizeof(uint32_t) == 0, "CameraToolsData has to consist of whole words to be exchanged atomically");
+static_assert(CAMERA_TOOLS_DATA_EXCHANGE_OFFSET >= sizeof(CameraToolsData) && CAMERA_TOOLS_DATA_EXCHANGE_OFFSET + sizeof(CameraToolsDataExchange) <= 8 * 1024, 
+			  "CameraToolsDataExchange has to fit in the buffer after the plain CameraToolsData");
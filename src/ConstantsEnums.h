@@ -91,6 +91,20 @@ enum class ScreenshotFiletype : int
 };
 
 
+enum class StateInterpolationMode : int
+{
+	Linear,			// lerp between the two states of a segment
+	CatmullRom,		// Catmull-Rom spline through the states around a segment, so values don't change speed abruptly at the states
+};
+
+
+enum class WorkItemCost : int
+{
+	Light,			// takes microseconds, e.g. setting an interpolated state
+	Heavy,			// enumerates or writes the complete reshade state, e.g. capturing a snapshot. Might be deferred to a later frame
+};
+
+
 enum class ScreenshotSessionStartReturnCode : int
 {
 	AllOk = 0,
@@ -32,42 +32,37 @@
 /////////////////////////////////////////////////////////////////////////
 
 #include "ReshadeStateSnapshot.h"
+#include <algorithm>
 #include "Utils.h"
 
-EffectState::EffectState(std::string name) : _name(name)
+EffectState::EffectState(IGCS::SymbolTable::Symbol name) : _name(name)
 {}
 
-void EffectState::addUniform(reshade::api::effect_uniform_variable id, std::string name, float* values)
-{
-	_uniformFloatValuePerName.emplace(name, DirectX::XMFLOAT4(values));
-	_uniformFloatVariableIdPerName.emplace(name, id.handle);
-}
-
 
-void EffectState::applyState(reshade::api::effect_runtime* runtime)
+void EffectState::applyState(reshade::api::effect_runtime* runtime) const
 {
-	for(auto& nameValuePair : _uniformFloatValuePerName)
+	for(const auto& uniformState : *_uniformFloatStates)
 	{
-		// grab the id so we can use it to set the variable.
-		const auto id = _uniformFloatVariableIdPerName[nameValuePair.first];
-		if(id==0)
+		if(uniformState.variableId==0)
 		{
 			continue;
 		}
-		runtime->set_uniform_value_float(reshade::api::effect_uniform_variable(id), nameValuePair.second.x, nameValuePair.second.y, nameValuePair.second.z, nameValuePair.second.w);
+		runtime->set_uniform_value_float(reshade::api::effect_uniform_variable(uniformState.variableId), uniformState.value.x, uniformState.value.y, uniformState.value.z, uniformState.value.w);
 	}
 }
 
 
 void EffectState::obtainEffectState(reshade::api::effect_runtime* runtime)
 {
-	runtime->enumerate_uniform_variables(_name.c_str(), [&](reshade::api::effect_runtime* sourceRuntime, reshade::api::effect_uniform_variable variable)
+	std::vector<UniformFloatState> uniformFloatStates;
+	std::vector<UniformVariableId> uniformVariableIds;
+	runtime->enumerate_uniform_variables(IGCS::SymbolTable::nameOf(_name).c_str(), [&](reshade::api::effect_runtime* sourceRuntime, reshade::api::effect_uniform_variable variable)
 	{
 		// get name
 		char nameBuffer[1024];
 		size_t nameBufferLength = 1024;
 		sourceRuntime->get_uniform_variable_name(variable, nameBuffer, &nameBufferLength);
-		const std::string uniformName(nameBuffer);
+		const IGCS::SymbolTable::Symbol uniformName = IGCS::SymbolTable::intern(nameBuffer);
 
 		// get type
 		reshade::api::format typeFormat;
@@ -82,115 +77,245 @@ void EffectState::obtainEffectState(reshade::api::effect_runtime* runtime)
 			// get value
 			float values[4] = {};
 			sourceRuntime->get_uniform_value_float(variable, values, 4);
-			addUniform(variable, uniformName, values);
+			uniformFloatStates.push_back({ uniformName, variable.handle, DirectX::XMFLOAT4(values) });
 		}
-		// Always store the id as well in the general map, so we can use it to set a value different from a float if we need to using another context than the paths/interpolation
-		_uniformVariableIdPerName.emplace(uniformName, variable.handle);
+		// Always store the id as well in the general list, so we can use it to set a value different from a float if we need to using another context than the paths/interpolation
+		uniformVariableIds.push_back({ uniformName, variable.handle });
 	});
+
+	// sort on name so lookups are a binary search and interpolation is a single pass over both states. If a name occurs more than once, the first one wins.
+	std::ranges::stable_sort(uniformFloatStates, {}, &UniformFloatState::name);
+	uniformFloatStates.erase(std::ranges::unique(uniformFloatStates, {}, &UniformFloatState::name).begin(), uniformFloatStates.end());
+	uniformFloatStates.shrink_to_fit();
+	std::ranges::stable_sort(uniformVariableIds, {}, &UniformVariableId::name);
+	uniformVariableIds.erase(std::ranges::unique(uniformVariableIds, {}, &UniformVariableId::name).begin(), uniformVariableIds.end());
+	uniformVariableIds.shrink_to_fit();
+	_uniformFloatStates = std::make_shared<const std::vector<UniformFloatState>>(std::move(uniformFloatStates));
+	_uniformVariableIds = std::make_shared<const std::vector<UniformVariableId>>(std::move(uniformVariableIds));
 }
 
 
 void EffectState::migrateIds(const EffectState& idSource)
 {
-	_uniformFloatVariableIdPerName.clear();
-	_uniformVariableIdPerName.clear();
-
-	for(auto& nameValuePair : idSource._uniformFloatValuePerName)
+	if(isBoundTo(idSource))
 	{
-		auto sourceIdsPerName = idSource._uniformFloatVariableIdPerName;
-		const auto id = sourceIdsPerName[nameValuePair.first];
-		if(!_uniformFloatValuePerName.contains(nameValuePair.first))
+		return;
+	}
+	// The migrated state has exactly the float variables of idSource, with their new ids. Values of variables we already had are kept, new variables
+	// get the value in idSource, and variables no longer in idSource are removed.
+	std::vector<UniformFloatState> migratedStates;
+	migratedStates.reserve(idSource._uniformFloatStates->size());
+	auto currentIt = _uniformFloatStates->begin();
+	for(const auto& sourceState : *idSource._uniformFloatStates)
+	{
+		while(currentIt != _uniformFloatStates->end() && currentIt->name < sourceState.name)
+		{
+			// no longer there
+			++currentIt;
+		}
+		if(currentIt != _uniformFloatStates->end() && currentIt->name == sourceState.name)
+		{
+			migratedStates.push_back({ sourceState.name, sourceState.variableId, currentIt->value });
+		}
+		else
 		{
 			// add it, it was not yet known
-			_uniformFloatValuePerName[nameValuePair.first] = nameValuePair.second;
+			migratedStates.push_back(sourceState);
 		}
-		_uniformFloatVariableIdPerName[nameValuePair.first] = id;
 	}
-	// it might be the new state has less variables than we had in the previous state. Check if there are left over variables.
-	std::vector<std::string> toRemove;
-	for(auto& nameValuePair : _uniformFloatValuePerName)
+	// if nothing changed, e.g. the ids are the same as before, the current block is kept so it stays shared with other snapshots.
+	if(migratedStates != *_uniformFloatStates)
 	{
-		if(!_uniformFloatVariableIdPerName.contains(nameValuePair.first))
+		_uniformFloatStates = std::make_shared<const std::vector<UniformFloatState>>(std::move(migratedStates));
+	}
+	// simply share the ids of the source
+	_uniformVariableIds = idSource._uniformVariableIds;
+}
+
+
+void EffectState::addToInterpolationPlan(const EffectState& destinationEffect, StateInterpolationPlan& plan) const
+{
+	// both lists are sorted on name, so we can walk them side by side and only interpolate the variables present in both.
+	auto destinationIt = destinationEffect._uniformFloatStates->begin();
+	const auto destinationEnd = destinationEffect._uniformFloatStates->end();
+	for(const auto& uniformState : *_uniformFloatStates)
+	{
+		while(destinationIt != destinationEnd && destinationIt->name < uniformState.name)
 		{
-			// no longer there
-			toRemove.push_back(nameValuePair.first);
+			++destinationIt;
+		}
+		if(destinationIt == destinationEnd)
+		{
+			break;
+		}
+		if(destinationIt->name != uniformState.name)
+		{
+			continue;
+		}
+		plan.addUniform(uniformState.variableId, uniformState.value, destinationIt->value);
+	}
+}
+
+
+void EffectState::addToSplineInterpolationPlan(const EffectState* previousEffect, const EffectState& destinationEffect, const EffectState* nextEffect, StateInterpolationPlan& plan) const
+{
+	auto destinationIt = destinationEffect._uniformFloatStates->begin();
+	const auto destinationEnd = destinationEffect._uniformFloatStates->end();
+	for(const auto& uniformState : *_uniformFloatStates)
+	{
+		while(destinationIt != destinationEnd && destinationIt->name < uniformState.name)
+		{
+			++destinationIt;
+		}
+		if(destinationIt == destinationEnd)
+		{
+			break;
 		}
+		if(destinationIt->name != uniformState.name)
+		{
+			continue;
+		}
+		// without a value before or after the segment, the spline is clamped at the start resp. the end of the segment.
+		const DirectX::XMFLOAT4* previousValue = nullptr == previousEffect ? nullptr : previousEffect->findUniformFloatValue(uniformState.name);
+		const DirectX::XMFLOAT4* nextValue = nullptr == nextEffect ? nullptr : nextEffect->findUniformFloatValue(uniformState.name);
+		plan.addUniform(uniformState.variableId, nullptr == previousValue ? uniformState.value : *previousValue, uniformState.value, destinationIt->value, 
+						nullptr == nextValue ? destinationIt->value : *nextValue);
 	}
+}
+
 
-	for(auto& nameValuePair : idSource._uniformVariableIdPerName)
+void EffectState::shareUnchangedStateWith(const EffectState& other)
+{
+	if(_name != other._name)
+	{
+		return;
+	}
+	if(_uniformFloatStates != other._uniformFloatStates && *_uniformFloatStates == *other._uniformFloatStates)
 	{
-		// simply copy over
-		_uniformVariableIdPerName[nameValuePair.first] = nameValuePair.second;
+		_uniformFloatStates = other._uniformFloatStates;
 	}
+	if(_uniformVariableIds != other._uniformVariableIds && *_uniformVariableIds == *other._uniformVariableIds)
+	{
+		_uniformVariableIds = other._uniformVariableIds;
+	}
+}
 
-	for(auto& it : toRemove)
+
+size_t EffectState::memoryUsageInBytes(std::unordered_set<const void*>& blocksCounted) const
+{
+	size_t toReturn = 0;
+	if(blocksCounted.insert(_uniformFloatStates.get()).second)
 	{
-		_uniformFloatValuePerName.erase(it);
+		toReturn += _uniformFloatStates->capacity() * sizeof(UniformFloatState);
 	}
+	if(blocksCounted.insert(_uniformVariableIds.get()).second)
+	{
+		toReturn += _uniformVariableIds->capacity() * sizeof(UniformVariableId);
+	}
+	return toReturn;
 }
 
 
-void EffectState::applyStateFromTo(reshade::api::effect_runtime* runtime, EffectState destinationEffect, float interpolationFactor)
+const DirectX::XMFLOAT4* EffectState::findUniformFloatValue(IGCS::SymbolTable::Symbol uniformName) const
 {
-	auto& destinationValuesPerName = destinationEffect._uniformFloatValuePerName;
+	const auto it = std::ranges::lower_bound(*_uniformFloatStates, uniformName, {}, &UniformFloatState::name);
+	if(it == _uniformFloatStates->end() || it->name != uniformName)
+	{
+		return nullptr;
+	}
+	return &it->value;
+}
+
 
-	for(auto& nameValuePair : _uniformFloatValuePerName)
+void EffectState::writeTo(IGCS::BinaryWriter& writer) const
+{
+	writer.writeSymbol(_name);
+	writer.write((uint32_t)_uniformFloatStates->size());
+	for(const auto& uniformState : *_uniformFloatStates)
+	{
+		writer.writeSymbol(uniformState.name);
+		writer.write(uniformState.value);
+	}
+}
+
+
+bool EffectState::readFrom(IGCS::BinaryReader& reader)
+{
+	uint32_t numberOfUniforms = 0;
+	if(!reader.readSymbol(_name) || !reader.read(numberOfUniforms) || !reader.hasBytesLeft((size_t)numberOfUniforms * (sizeof(uint32_t) + sizeof(DirectX::XMFLOAT4))))
 	{
-		if(!destinationValuesPerName.contains(nameValuePair.first))
+		return false;
+	}
+	std::vector<UniformFloatState> uniformFloatStates;
+	uniformFloatStates.reserve(numberOfUniforms);
+	for(uint32_t i = 0; i < numberOfUniforms; i++)
+	{
+		UniformFloatState toRead = { IGCS::SymbolTable::INVALID_SYMBOL, 0, DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f) };
+		if(!reader.readSymbol(toRead.name) || !reader.read(toRead.value))
 		{
-			continue;
+			return false;
 		}
-		const auto& destinationValues = destinationValuesPerName[nameValuePair.first];
-		const auto& id = _uniformFloatVariableIdPerName[nameValuePair.first];
+		uniformFloatStates.push_back(toRead);
+	}
+	// the symbols of this session are likely different from the ones of the session which wrote the data, so the order has to be restored.
+	std::ranges::sort(uniformFloatStates, {}, &UniformFloatState::name);
+	_uniformFloatStates = std::make_shared<const std::vector<UniformFloatState>>(std::move(uniformFloatStates));
+	_uniformVariableIds = std::make_shared<const std::vector<UniformVariableId>>();
+	return true;
+}
+
 
-		const float x = IGCS::Utils::lerp(nameValuePair.second.x, destinationValues.x, interpolationFactor);
-		const float y = IGCS::Utils::lerp(nameValuePair.second.y, destinationValues.y, interpolationFactor);
-		const float z = IGCS::Utils::lerp(nameValuePair.second.z, destinationValues.z, interpolationFactor);
-		const float w = IGCS::Utils::lerp(nameValuePair.second.w, destinationValues.w, interpolationFactor);
-		runtime->set_uniform_value_float(reshade::api::effect_uniform_variable(id), x, y, z, w);
+uint64_t EffectState::findUniformVariableId(const std::string& uniformName)
+{
+	const IGCS::SymbolTable::Symbol nameToFind = IGCS::SymbolTable::find(uniformName);
+	const auto it = std::ranges::lower_bound(*_uniformVariableIds, nameToFind, {}, &UniformVariableId::name);
+	if(it == _uniformVariableIds->end() || it->name != nameToFind)
+	{
+		return 0;
 	}
+	return it->variableId;
 }
 
 
 void EffectState::setUniformIntVariable(reshade::api::effect_runtime* runtime, const std::string& uniformName, int valueToWrite)
 {
-	if(!_uniformVariableIdPerName.contains(uniformName))
+	const uint64_t uniformId = findUniformVariableId(uniformName);
+	if(uniformId == 0)
 	{
 		return;
 	}
-	const uint64_t uniformId = _uniformVariableIdPerName[uniformName];
 	runtime->set_uniform_value_int(reshade::api::effect_uniform_variable(uniformId), valueToWrite);
 }
 
 
 void EffectState::setUniformFloatVariable(reshade::api::effect_runtime* runtime, const std::string& uniformName, float valueToWrite)
 {
-	if(!_uniformVariableIdPerName.contains(uniformName))
+	const uint64_t uniformId = findUniformVariableId(uniformName);
+	if(uniformId == 0)
 	{
 		return;
 	}
-	const uint64_t uniformId = _uniformVariableIdPerName[uniformName];
 	runtime->set_uniform_value_float(reshade::api::effect_uniform_variable(uniformId), valueToWrite);
 }
 
 
 void EffectState::setUniformFloat2Variable(reshade::api::effect_runtime* runtime, const std::string& uniformName, float value1ToWrite, float value2ToWrite)
 {
-	if(!_uniformVariableIdPerName.contains(uniformName))
+	const uint64_t uniformId = findUniformVariableId(uniformName);
+	if(uniformId == 0)
 	{
 		return;
 	}
-	const uint64_t uniformId = _uniformVariableIdPerName[uniformName];
 	runtime->set_uniform_value_float(reshade::api::effect_uniform_variable(uniformId), value1ToWrite, value2ToWrite);
 }
 
 
 void EffectState::setUniformBoolVariable(reshade::api::effect_runtime* runtime, const std::string& uniformName, bool valueToWrite)
 {
-	if(!_uniformVariableIdPerName.contains(uniformName))
+	const uint64_t uniformId = findUniformVariableId(uniformName);
+	if(uniformId == 0)
 	{
 		return;
 	}
-	const uint64_t uniformId = _uniformVariableIdPerName[uniformName];
 	runtime->set_uniform_value_bool(reshade::api::effect_uniform_variable(uniformId), valueToWrite);
 }
@@ -35,21 +35,58 @@
 
 #include <DirectXMath.h>
 #include <reshade.hpp>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "BinaryStream.h"
+#include "StateInterpolationPlan.h"
+#include "SymbolTable.h"
 
 
+/// <summary>
+/// The state of a single float uniform: its name, the id to set it with and its value. Floats are stored as float4.
+/// </summary>
+struct UniformFloatState
+{
+	IGCS::SymbolTable::Symbol name;
+	uint64_t variableId;
+	DirectX::XMFLOAT4 value;
+
+	bool operator==(const UniformFloatState& other) const
+	{
+		return name == other.name && variableId == other.variableId && value.x == other.value.x && value.y == other.value.y && value.z == other.value.z && value.w == other.value.w;
+	}
+};
+
+
+/// <summary>
+/// The id of a uniform, of any type, by name.
+/// </summary>
+struct UniformVariableId
+{
+	IGCS::SymbolTable::Symbol name;
+	uint64_t variableId;
+
+	bool operator==(const UniformVariableId& other) const = default;
+};
+
+
+/// <summary>
+/// The uniform values of a single effect. The uniforms are stored in immutable blocks which are shared by all copies of the effect state, so copying
+///	an effect state to every node of a path is cheap. Every change creates a new block, so changing a copy never affects the others.
+/// </summary>
 class EffectState
 {
 public:
 	EffectState() = default;
-	EffectState(std::string name);
+	EffectState(IGCS::SymbolTable::Symbol name);
 
 	/// <summary>
 	/// Applies the state contained by this effect state to the runtime specified
 	/// </summary>
 	/// <param name="runtime"></param>
-	void applyState(reshade::api::effect_runtime* runtime);
+	void applyState(reshade::api::effect_runtime* runtime) const;
 	/// <summary>
 	/// Obtains the effect state from the runtime specified and stors it inside this effectstate object
 	/// </summary>
@@ -60,22 +97,52 @@ public:
 	/// </summary>
 	/// <param name="idSource"></param>
 	void migrateIds(const EffectState& idSource);
-	void applyStateFromTo(reshade::api::effect_runtime* runtime, EffectState destinationEffect, float interpolationFactor);
+	/// <summary>
+	/// Returns true if this effect state uses the ids of idSource, so migrating it to idSource wouldn't change anything. The id blocks of effects whose handles
+	///	didn't change in a reload are shared with the previous ones, so this is a pointer compare.
+	/// </summary>
+	bool isBoundTo(const EffectState& idSource) const { return _uniformVariableIds == idSource._uniformVariableIds; }
+	/// <summary>
+	/// Adds the uniforms present in both this effect state and destinationEffect to the plan specified. 
+	/// </summary>
+	void addToInterpolationPlan(const EffectState& destinationEffect, StateInterpolationPlan& plan) const;
+	/// <summary>
+	/// Adds the uniforms present in both this effect state and destinationEffect to the plan specified, interpolated with a spline which also passes through
+	///	the values in previousEffect and nextEffect. If either is nullptr or lacks a uniform, the value of this effect state resp. destinationEffect is used instead.
+	/// </summary>
+	void addToSplineInterpolationPlan(const EffectState* previousEffect, const EffectState& destinationEffect, const EffectState* nextEffect, StateInterpolationPlan& plan) const;
 	void setUniformIntVariable(reshade::api::effect_runtime* runtime, const std::string& uniformName, int valueToWrite);
 	void setUniformFloatVariable(reshade::api::effect_runtime* runtime, const std::string& uniformName, float valueToWrite);
 	void setUniformFloat2Variable(reshade::api::effect_runtime* runtime, const std::string& uniformName, float value1ToWrite, float value2ToWrite);
 	void setUniformBoolVariable(reshade::api::effect_runtime* runtime, const std::string& uniformName, bool valueToWrite);
 
-	std::string name() { return _name; }
+	/// <summary>
+	/// Writes the float uniforms by name and value. Ids aren't written as they're only valid in the current session, use migrateIds after reading.
+	/// </summary>
+	void writeTo(IGCS::BinaryWriter& writer) const;
+	/// <summary>
+	/// Reads the data written by writeTo. Returns false if the data is corrupt.
+	/// </summary>
+	bool readFrom(IGCS::BinaryReader& reader);
+	/// <summary>
+	/// Makes this effect state share the blocks of other which contain the same data as the blocks of this effect state, so the duplicates can be freed.
+	/// </summary>
+	void shareUnchangedStateWith(const EffectState& other);
+	/// <summary>
+	/// Returns the number of bytes used by the blocks of this effect state which aren't in blocksCounted yet, and adds them to it.
+	/// </summary>
+	size_t memoryUsageInBytes(std::unordered_set<const void*>& blocksCounted) const;
+
+	IGCS::SymbolTable::Symbol nameSymbol() const { return _name; }
+	const std::string& name() const { return IGCS::SymbolTable::nameOf(_name); }
 
 private:
-	void addUniform(reshade::api::effect_uniform_variable id, std::string name, float* values);
+	uint64_t findUniformVariableId(const std::string& uniformName);
+	const DirectX::XMFLOAT4* findUniformFloatValue(IGCS::SymbolTable::Symbol uniformName) const;
 
-	std::string _name;
+	IGCS::SymbolTable::Symbol _name = IGCS::SymbolTable::INVALID_SYMBOL;
 	// Names are usable across reloads of a preset. It might still be names aren't present after a reload (e.g. a shader changed). But for our use case this isn't important. 
-	std::unordered_map<std::string, uint64_t> _uniformFloatVariableIdPerName;			// for Floats only
-	std::unordered_map<std::string, DirectX::XMFLOAT4> _uniformFloatValuePerName;		// stored with their uniform name for this effect. We store floats as float4.
-	std::unordered_map<std::string, uint64_t> _uniformVariableIdPerName;				// all variables of the effect, floats and others.
+	// Both vectors are sorted on name symbol, so two effect states can be walked side by side.
+	std::shared_ptr<const std::vector<UniformFloatState>> _uniformFloatStates = std::make_shared<const std::vector<UniformFloatState>>();		// for Floats only
+	std::shared_ptr<const std::vector<UniformVariableId>> _uniformVariableIds = std::make_shared<const std::vector<UniformVariableId>>();	// all variables of the effect, floats and others.
 };
-
-
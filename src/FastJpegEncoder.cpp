@@ -0,0 +1,573 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "FastJpegEncoder.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <immintrin.h>
+
+#include "ImageUtils.h"
+
+namespace IGCS::FastJpegEncoder
+{
+	struct HuffmanCode
+	{
+		uint16_t code;
+		uint8_t length;
+	};
+
+	struct HuffmanTable
+	{
+		HuffmanCode codes[256];
+	};
+
+	struct EncoderTables
+	{
+		uint8_t yQuantizationTable[64];		// zigzag order, as written in the DQT segment
+		uint8_t uvQuantizationTable[64];
+		alignas(16) float yScales[64];		// 1/(quantizer * dct scale) per coefficient, in the transposed order the dct produces.
+		alignas(16) float uvScales[64];
+		HuffmanTable yDC, yAC, uvDC, uvAC;
+	};
+
+	/// <summary>
+	/// Writes huffman coded bits to a buffer, with the 0xFF bytes stuffed with a 0x00 byte.
+	/// </summary>
+	class BitWriter
+	{
+	public:
+		BitWriter(std::vector<uint8_t>& destination) : _destination(destination) {}
+
+		void writeBits(uint32_t bits, int numberOfBits)
+		{
+			_bitBuffer = (_bitBuffer << numberOfBits) | bits;
+			_numberOfBits += numberOfBits;
+			if(_numberOfBits >= 32)
+			{
+				_numberOfBits -= 32;
+				writeWord((uint32_t)(_bitBuffer >> _numberOfBits));
+			}
+		}
+
+		/// <summary>
+		/// Pads the last byte with 1 bits and writes the bits which are still buffered.
+		/// </summary>
+		void flush()
+		{
+			const int numberOfPaddingBits = (8 - (_numberOfBits & 7)) & 7;
+			writeBits((1u << numberOfPaddingBits) - 1, numberOfPaddingBits);
+			while(_numberOfBits > 0)
+			{
+				_numberOfBits -= 8;
+				writeByte((uint8_t)(_bitBuffer >> _numberOfBits));
+			}
+		}
+
+	private:
+		void writeWord(uint32_t word)
+		{
+			// fast path: no byte in the word is 0xFF, so nothing has to be stuffed.
+			const uint32_t invertedWord = ~word;
+			if(0 == ((invertedWord - 0x01010101u) & ~invertedWord & 0x80808080u))
+			{
+				const uint8_t bytes[4] = { (uint8_t)(word >> 24), (uint8_t)(word >> 16), (uint8_t)(word >> 8), (uint8_t)word };
+				_destination.insert(_destination.end(), bytes, bytes + 4);
+				return;
+			}
+			writeByte((uint8_t)(word >> 24));
+			writeByte((uint8_t)(word >> 16));
+			writeByte((uint8_t)(word >> 8));
+			writeByte((uint8_t)word);
+		}
+
+		void writeByte(uint8_t value)
+		{
+			_destination.push_back(value);
+			if(value == 0xFF)
+			{
+				_destination.push_back(0);
+			}
+		}
+
+		std::vector<uint8_t>& _destination;
+		uint64_t _bitBuffer = 0;
+		int _numberOfBits = 0;
+	};
+
+	//-----------------------------------------------
+	// Tables. Same as the ones used by stb_image_write
+
+	static const uint8_t ZIGZAG[64] = { 0,1,5,6,14,15,27,28,2,4,7,13,16,26,29,42,3,8,12,17,25,30,41,43,9,11,18,24,31,40,44,53,10,19,23,32,39,45,52,54,
+										20,22,33,38,46,51,55,60,21,34,37,47,50,56,59,61,35,36,48,49,57,58,62,63 };
+	static const int Y_QUANTIZATION_TABLE[64] = { 16,11,10,16,24,40,51,61,12,12,14,19,26,58,60,55,14,13,16,24,40,57,69,56,14,17,22,29,51,87,80,62,18,22,
+												  37,56,68,109,103,77,24,35,55,64,81,104,113,92,49,64,78,87,103,121,120,101,72,92,95,98,112,100,103,99 };
+	static const int UV_QUANTIZATION_TABLE[64] = { 17,18,24,47,99,99,99,99,18,21,26,66,99,99,99,99,24,26,56,99,99,99,99,99,47,66,99,99,99,99,99,99,
+												   99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99,99 };
+	static const float AAN_SCALE_FACTORS[8] = { 1.0f * 2.828427125f, 1.387039845f * 2.828427125f, 1.306562965f * 2.828427125f, 1.175875602f * 2.828427125f,
+												1.0f * 2.828427125f, 0.785694958f * 2.828427125f, 0.541196100f * 2.828427125f, 0.275899379f * 2.828427125f };
+
+	// number of codes per code length 1-16, followed by the values.
+	static const uint8_t DC_LUMINANCE_NUMBER_OF_CODES[16] = { 0,1,5,1,1,1,1,1,1,0,0,0,0,0,0,0 };
+	static const uint8_t DC_LUMINANCE_VALUES[12] = { 0,1,2,3,4,5,6,7,8,9,10,11 };
+	static const uint8_t AC_LUMINANCE_NUMBER_OF_CODES[16] = { 0,2,1,3,3,2,4,3,5,5,4,4,0,0,1,0x7d };
+	static const uint8_t AC_LUMINANCE_VALUES[162] = {
+		0x01,0x02,0x03,0x00,0x04,0x11,0x05,0x12,0x21,0x31,0x41,0x06,0x13,0x51,0x61,0x07,0x22,0x71,0x14,0x32,0x81,0x91,0xa1,0x08,
+		0x23,0x42,0xb1,0xc1,0x15,0x52,0xd1,0xf0,0x24,0x33,0x62,0x72,0x82,0x09,0x0a,0x16,0x17,0x18,0x19,0x1a,0x25,0x26,0x27,0x28,
+		0x29,0x2a,0x34,0x35,0x36,0x37,0x38,0x39,0x3a,0x43,0x44,0x45,0x46,0x47,0x48,0x49,0x4a,0x53,0x54,0x55,0x56,0x57,0x58,0x59,
+		0x5a,0x63,0x64,0x65,0x66,0x67,0x68,0x69,0x6a,0x73,0x74,0x75,0x76,0x77,0x78,0x79,0x7a,0x83,0x84,0x85,0x86,0x87,0x88,0x89,
+		0x8a,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,0x9a,0xa2,0xa3,0xa4,0xa5,0xa6,0xa7,0xa8,0xa9,0xaa,0xb2,0xb3,0xb4,0xb5,0xb6,
+		0xb7,0xb8,0xb9,0xba,0xc2,0xc3,0xc4,0xc5,0xc6,0xc7,0xc8,0xc9,0xca,0xd2,0xd3,0xd4,0xd5,0xd6,0xd7,0xd8,0xd9,0xda,0xe1,0xe2,
+		0xe3,0xe4,0xe5,0xe6,0xe7,0xe8,0xe9,0xea,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,0xf9,0xfa
+	};
+	static const uint8_t DC_CHROMINANCE_NUMBER_OF_CODES[16] = { 0,3,1,1,1,1,1,1,1,1,1,0,0,0,0,0 };
+	static const uint8_t DC_CHROMINANCE_VALUES[12] = { 0,1,2,3,4,5,6,7,8,9,10,11 };
+	static const uint8_t AC_CHROMINANCE_NUMBER_OF_CODES[16] = { 0,2,1,2,4,4,3,4,7,5,4,4,0,1,2,0x77 };
+	static const uint8_t AC_CHROMINANCE_VALUES[162] = {
+		0x00,0x01,0x02,0x03,0x11,0x04,0x05,0x21,0x31,0x06,0x12,0x41,0x51,0x07,0x61,0x71,0x13,0x22,0x32,0x81,0x08,0x14,0x42,0x91,
+		0xa1,0xb1,0xc1,0x09,0x23,0x33,0x52,0xf0,0x15,0x62,0x72,0xd1,0x0a,0x16,0x24,0x34,0xe1,0x25,0xf1,0x17,0x18,0x19,0x1a,0x26,
+		0x27,0x28,0x29,0x2a,0x35,0x36,0x37,0x38,0x39,0x3a,0x43,0x44,0x45,0x46,0x47,0x48,0x49,0x4a,0x53,0x54,0x55,0x56,0x57,0x58,
+		0x59,0x5a,0x63,0x64,0x65,0x66,0x67,0x68,0x69,0x6a,0x73,0x74,0x75,0x76,0x77,0x78,0x79,0x7a,0x82,0x83,0x84,0x85,0x86,0x87,
+		0x88,0x89,0x8a,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,0x9a,0xa2,0xa3,0xa4,0xa5,0xa6,0xa7,0xa8,0xa9,0xaa,0xb2,0xb3,0xb4,
+		0xb5,0xb6,0xb7,0xb8,0xb9,0xba,0xc2,0xc3,0xc4,0xc5,0xc6,0xc7,0xc8,0xc9,0xca,0xd2,0xd3,0xd4,0xd5,0xd6,0xd7,0xd8,0xd9,0xda,
+		0xe2,0xe3,0xe4,0xe5,0xe6,0xe7,0xe8,0xe9,0xea,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,0xf9,0xfa
+	};
+
+	// A restart interval is stored in 16 bits.
+	static const uint32_t MAX_NUMBER_OF_MCUS_PER_BAND = 65535;
+
+	//-----------------------------------------------
+	// forward declarations
+	void buildEncoderTables(int quality, EncoderTables& tables);
+	void buildHuffmanTable(const uint8_t* numberOfCodesPerLength, const uint8_t* values, HuffmanTable& table);
+	void writeHeaders(const EncoderTables& tables, uint32_t width, uint32_t height, uint32_t restartInterval, std::vector<uint8_t>& destination);
+	void encodeBand(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t firstMcuRow, uint32_t numberOfMcuRows, const EncoderTables& tables,
+					std::vector<uint8_t>& destination);
+	void convertBlockToYUV(const uint8_t* blockPixels, size_t rowStride, __m128 y[8][2], __m128 u[8][2], __m128 v[8][2]);
+	int encodeBlock(BitWriter& writer, __m128 block[8][2], const float* scales, int previousDC, const HuffmanTable& dcTable, const HuffmanTable& acTable);
+
+	//-----------------------------------------------
+	// code
+
+	bool isSupported()
+	{
+		// every cpu with AVX2 has SSSE3 as well.
+		return IGCS::ImageUtils::bestSupportedPackKernel() != IGCS::ImageUtils::PackKernel::Scalar;
+	}
+
+
+	bool encodeImageToMemory(const uint8_t* pixels, uint32_t width, uint32_t height, int quality, std::vector<uint8_t>& encodedData, uint32_t numberOfThreads)
+	{
+		if(nullptr == pixels || 0 == width || 0 == height || width > 65535 || height > 65535 || !isSupported())
+		{
+			return false;
+		}
+		EncoderTables tables;
+		buildEncoderTables(quality, tables);
+
+		if(0 == numberOfThreads)
+		{
+			numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		const uint32_t numberOfMcusPerRow = (width + 7) / 8;
+		const uint32_t numberOfMcuRows = (height + 7) / 8;
+		// a couple of bands per thread so a thread which finishes early can pick up another band.
+		uint32_t numberOfBands = numberOfThreads > 1 ? std::min(numberOfMcuRows, numberOfThreads * 4) : 1;
+		uint32_t numberOfMcuRowsPerBand = (numberOfMcuRows + numberOfBands - 1) / numberOfBands;
+		if(numberOfBands > 1)
+		{
+			numberOfMcuRowsPerBand = std::min(numberOfMcuRowsPerBand, MAX_NUMBER_OF_MCUS_PER_BAND / numberOfMcusPerRow);
+			numberOfBands = (numberOfMcuRows + numberOfMcuRowsPerBand - 1) / numberOfMcuRowsPerBand;
+		}
+
+		std::vector<std::vector<uint8_t>> encodedBands(numberOfBands);
+		std::atomic<uint32_t> nextBandToEncode = 0;
+		auto encodeBands = [&]()
+		{
+			for(uint32_t bandIndex = nextBandToEncode++; bandIndex < numberOfBands; bandIndex = nextBandToEncode++)
+			{
+				const uint32_t firstMcuRow = bandIndex * numberOfMcuRowsPerBand;
+				encodeBand(pixels, width, height, firstMcuRow, std::min(numberOfMcuRowsPerBand, numberOfMcuRows - firstMcuRow), tables, encodedBands[bandIndex]);
+			}
+		};
+		// the calling thread encodes bands as well.
+		std::vector<std::future<void>> workers;
+		for(uint32_t i = 1; i < std::min(numberOfThreads, numberOfBands); i++)
+		{
+			workers.push_back(std::async(std::launch::async, encodeBands));
+		}
+		encodeBands();
+		size_t totalSize = 0;
+		for(auto& worker : workers)
+		{
+			worker.get();
+		}
+		for(const auto& band : encodedBands)
+		{
+			totalSize += band.size() + 2;
+		}
+
+		encodedData.clear();
+		encodedData.reserve(totalSize + 1024);
+		writeHeaders(tables, width, height, numberOfBands > 1 ? numberOfMcusPerRow * numberOfMcuRowsPerBand : 0, encodedData);
+		for(uint32_t i = 0; i < numberOfBands; i++)
+		{
+			if(i > 0)
+			{
+				// RSTn marker, n cycles through 0-7.
+				encodedData.push_back(0xFF);
+				encodedData.push_back((uint8_t)(0xD0 + ((i - 1) & 7)));
+			}
+			encodedData.insert(encodedData.end(), encodedBands[i].begin(), encodedBands[i].end());
+		}
+		// EOI
+		encodedData.push_back(0xFF);
+		encodedData.push_back(0xD9);
+		return true;
+	}
+
+
+	void buildEncoderTables(int quality, EncoderTables& tables)
+	{
+		quality = quality ? quality : 90;
+		quality = std::clamp(quality, 1, 100);
+		quality = quality < 50 ? 5000 / quality : 200 - quality * 2;
+
+		for(int i = 0; i < 64; ++i)
+		{
+			tables.yQuantizationTable[ZIGZAG[i]] = (uint8_t)std::clamp((Y_QUANTIZATION_TABLE[i] * quality + 50) / 100, 1, 255);
+			tables.uvQuantizationTable[ZIGZAG[i]] = (uint8_t)std::clamp((UV_QUANTIZATION_TABLE[i] * quality + 50) / 100, 1, 255);
+		}
+		// The dct produces the coefficient of row 'row', column 'column' at index column * 8 + row, so the scales are stored transposed.
+		for(int row = 0; row < 8; ++row)
+		{
+			for(int column = 0; column < 8; ++column)
+			{
+				const int naturalIndex = row * 8 + column;
+				const float aanScale = AAN_SCALE_FACTORS[row] * AAN_SCALE_FACTORS[column];
+				tables.yScales[column * 8 + row] = 1.0f / (tables.yQuantizationTable[ZIGZAG[naturalIndex]] * aanScale);
+				tables.uvScales[column * 8 + row] = 1.0f / (tables.uvQuantizationTable[ZIGZAG[naturalIndex]] * aanScale);
+			}
+		}
+		buildHuffmanTable(DC_LUMINANCE_NUMBER_OF_CODES, DC_LUMINANCE_VALUES, tables.yDC);
+		buildHuffmanTable(AC_LUMINANCE_NUMBER_OF_CODES, AC_LUMINANCE_VALUES, tables.yAC);
+		buildHuffmanTable(DC_CHROMINANCE_NUMBER_OF_CODES, DC_CHROMINANCE_VALUES, tables.uvDC);
+		buildHuffmanTable(AC_CHROMINANCE_NUMBER_OF_CODES, AC_CHROMINANCE_VALUES, tables.uvAC);
+	}
+
+
+	void buildHuffmanTable(const uint8_t* numberOfCodesPerLength, const uint8_t* values, HuffmanTable& table)
+	{
+		// canonical huffman codes, see JPEG spec Annex C.
+		memset(&table, 0, sizeof(HuffmanTable));
+		uint16_t code = 0;
+		int valueIndex = 0;
+		for(int length = 1; length <= 16; length++)
+		{
+			for(int i = 0; i < numberOfCodesPerLength[length - 1]; i++)
+			{
+				table.codes[values[valueIndex++]] = { code++, (uint8_t)length };
+			}
+			code <<= 1;
+		}
+	}
+
+
+	void writeHeaders(const EncoderTables& tables, uint32_t width, uint32_t height, uint32_t restartInterval, std::vector<uint8_t>& destination)
+	{
+		auto append = [&](const uint8_t* bytes, size_t numberOfBytes) { destination.insert(destination.end(), bytes, bytes + numberOfBytes); };
+
+		// SOI, JFIF APP0, start of DQT
+		static const uint8_t head0[] = { 0xFF,0xD8,0xFF,0xE0,0,0x10,'J','F','I','F',0,1,1,0,0,1,0,1,0,0,0xFF,0xDB,0,0x84,0 };
+		append(head0, sizeof(head0));
+		append(tables.yQuantizationTable, 64);
+		destination.push_back(1);
+		append(tables.uvQuantizationTable, 64);
+		// SOF0, 3 components, no subsampling, start of DHT
+		const uint8_t head1[] = { 0xFF,0xC0,0,0x11,8,(uint8_t)(height >> 8),(uint8_t)height,(uint8_t)(width >> 8),(uint8_t)width,
+								  3,1,0x11,0,2,0x11,1,3,0x11,1,0xFF,0xC4,0x01,0xA2,0 };
+		append(head1, sizeof(head1));
+		append(DC_LUMINANCE_NUMBER_OF_CODES, sizeof(DC_LUMINANCE_NUMBER_OF_CODES));
+		append(DC_LUMINANCE_VALUES, sizeof(DC_LUMINANCE_VALUES));
+		destination.push_back(0x10);
+		append(AC_LUMINANCE_NUMBER_OF_CODES, sizeof(AC_LUMINANCE_NUMBER_OF_CODES));
+		append(AC_LUMINANCE_VALUES, sizeof(AC_LUMINANCE_VALUES));
+		destination.push_back(1);
+		append(DC_CHROMINANCE_NUMBER_OF_CODES, sizeof(DC_CHROMINANCE_NUMBER_OF_CODES));
+		append(DC_CHROMINANCE_VALUES, sizeof(DC_CHROMINANCE_VALUES));
+		destination.push_back(0x11);
+		append(AC_CHROMINANCE_NUMBER_OF_CODES, sizeof(AC_CHROMINANCE_NUMBER_OF_CODES));
+		append(AC_CHROMINANCE_VALUES, sizeof(AC_CHROMINANCE_VALUES));
+		if(restartInterval > 0)
+		{
+			// DRI
+			const uint8_t dri[] = { 0xFF,0xDD,0,4,(uint8_t)(restartInterval >> 8),(uint8_t)restartInterval };
+			append(dri, sizeof(dri));
+		}
+		// SOS
+		static const uint8_t head2[] = { 0xFF,0xDA,0,0xC,3,1,0,2,0x11,3,0x11,0,0x3F,0 };
+		append(head2, sizeof(head2));
+	}
+
+
+	void encodeBand(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t firstMcuRow, uint32_t numberOfMcuRows, const EncoderTables& tables,
+					std::vector<uint8_t>& destination)
+	{
+		const size_t rowStride = (size_t)width * 3;
+		// compressed size is usually well below a third of the raw size at high quality settings.
+		destination.reserve(rowStride * numberOfMcuRows * 8 / 3);
+		BitWriter writer(destination);
+		int previousYDC = 0;
+		int previousUDC = 0;
+		int previousVDC = 0;
+		uint8_t edgeBlock[8 * 8 * 3];
+		__m128 y[8][2], u[8][2], v[8][2];
+		for(uint32_t mcuRow = firstMcuRow; mcuRow < firstMcuRow + numberOfMcuRows; mcuRow++)
+		{
+			const uint32_t blockY = mcuRow * 8;
+			for(uint32_t blockX = 0; blockX < width; blockX += 8)
+			{
+				if(blockX + 8 <= width && blockY + 8 <= height)
+				{
+					convertBlockToYUV(pixels + blockY * rowStride + blockX * 3, rowStride, y, u, v);
+				}
+				else
+				{
+					// block on the right or bottom edge: repeat the last column / row, like stb does.
+					for(uint32_t row = 0; row < 8; row++)
+					{
+						const uint32_t clampedRow = std::min(blockY + row, height - 1);
+						for(uint32_t column = 0; column < 8; column++)
+						{
+							const uint32_t clampedColumn = std::min(blockX + column, width - 1);
+							memcpy(edgeBlock + (row * 8 + column) * 3, pixels + clampedRow * rowStride + clampedColumn * 3, 3);
+						}
+					}
+					convertBlockToYUV(edgeBlock, 8 * 3, y, u, v);
+				}
+				previousYDC = encodeBlock(writer, y, tables.yScales, previousYDC, tables.yDC, tables.yAC);
+				previousUDC = encodeBlock(writer, u, tables.uvScales, previousUDC, tables.uvDC, tables.uvAC);
+				previousVDC = encodeBlock(writer, v, tables.uvScales, previousVDC, tables.uvDC, tables.uvAC);
+			}
+		}
+		writer.flush();
+	}
+
+
+	TARGET_INSTRUCTION_SET("ssse3") void convertBlockToYUV(const uint8_t* blockPixels, size_t rowStride, __m128 y[8][2], __m128 u[8][2], __m128 v[8][2])
+	{
+		// 8 RGB pixels are 24 bytes: bytes 0-15 hold pixels 0-4 (and a part of 5), bytes 8-23 hold pixels 5-7.
+		const __m128i redFromFirst = _mm_setr_epi8(0, 3, 6, 9, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+		const __m128i redFromSecond = _mm_setr_epi8(-1, -1, -1, -1, -1, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+		const __m128i greenFromFirst = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+		const __m128i greenFromSecond = _mm_setr_epi8(-1, -1, -1, -1, -1, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+		const __m128i blueFromFirst = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+		const __m128i blueFromSecond = _mm_setr_epi8(-1, -1, -1, -1, -1, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+		const __m128i zero = _mm_setzero_si128();
+		auto toFloats = [&zero](__m128i bytes, __m128& low, __m128& high)
+		{
+			const __m128i words = _mm_unpacklo_epi8(bytes, zero);
+			low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+			high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero));
+		};
+
+		for(int row = 0; row < 8; row++)
+		{
+			const uint8_t* rowPixels = blockPixels + row * rowStride;
+			const __m128i first = _mm_loadu_si128((const __m128i*)rowPixels);
+			const __m128i second = _mm_loadu_si128((const __m128i*)(rowPixels + 8));
+			__m128 r[2], g[2], b[2];
+			toFloats(_mm_or_si128(_mm_shuffle_epi8(first, redFromFirst), _mm_shuffle_epi8(second, redFromSecond)), r[0], r[1]);
+			toFloats(_mm_or_si128(_mm_shuffle_epi8(first, greenFromFirst), _mm_shuffle_epi8(second, greenFromSecond)), g[0], g[1]);
+			toFloats(_mm_or_si128(_mm_shuffle_epi8(first, blueFromFirst), _mm_shuffle_epi8(second, blueFromSecond)), b[0], b[1]);
+			for(int half = 0; half < 2; half++)
+			{
+				y[row][half] = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[half], _mm_set1_ps(0.29900f)), _mm_mul_ps(g[half], _mm_set1_ps(0.58700f))), 
+													 _mm_mul_ps(b[half], _mm_set1_ps(0.11400f))), _mm_set1_ps(128.0f));
+				u[row][half] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(r[half], _mm_set1_ps(-0.16874f)), _mm_mul_ps(g[half], _mm_set1_ps(0.33126f))), 
+										  _mm_mul_ps(b[half], _mm_set1_ps(0.50000f)));
+				v[row][half] = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(r[half], _mm_set1_ps(0.50000f)), _mm_mul_ps(g[half], _mm_set1_ps(0.41869f))), 
+										  _mm_mul_ps(b[half], _mm_set1_ps(0.08131f)));
+			}
+		}
+	}
+
+
+	/// <summary>
+	/// AAN forward DCT of 8 values, same as stb's, but on 4 columns at once: d0-d7 are 8 rows of 4 values.
+	/// </summary>
+	static inline void dct8(__m128& d0, __m128& d1, __m128& d2, __m128& d3, __m128& d4, __m128& d5, __m128& d6, __m128& d7)
+	{
+		const __m128 tmp0 = _mm_add_ps(d0, d7);
+		const __m128 tmp7 = _mm_sub_ps(d0, d7);
+		const __m128 tmp1 = _mm_add_ps(d1, d6);
+		const __m128 tmp6 = _mm_sub_ps(d1, d6);
+		const __m128 tmp2 = _mm_add_ps(d2, d5);
+		const __m128 tmp5 = _mm_sub_ps(d2, d5);
+		const __m128 tmp3 = _mm_add_ps(d3, d4);
+		const __m128 tmp4 = _mm_sub_ps(d3, d4);
+
+		// even part
+		const __m128 tmp10 = _mm_add_ps(tmp0, tmp3);
+		const __m128 tmp13 = _mm_sub_ps(tmp0, tmp3);
+		const __m128 tmp11 = _mm_add_ps(tmp1, tmp2);
+		const __m128 tmp12 = _mm_sub_ps(tmp1, tmp2);
+		d0 = _mm_add_ps(tmp10, tmp11);
+		d4 = _mm_sub_ps(tmp10, tmp11);
+		const __m128 z1 = _mm_mul_ps(_mm_add_ps(tmp12, tmp13), _mm_set1_ps(0.707106781f));
+		d2 = _mm_add_ps(tmp13, z1);
+		d6 = _mm_sub_ps(tmp13, z1);
+
+		// odd part
+		const __m128 oddTmp10 = _mm_add_ps(tmp4, tmp5);
+		const __m128 oddTmp11 = _mm_add_ps(tmp5, tmp6);
+		const __m128 oddTmp12 = _mm_add_ps(tmp6, tmp7);
+		const __m128 z5 = _mm_mul_ps(_mm_sub_ps(oddTmp10, oddTmp12), _mm_set1_ps(0.382683433f));
+		const __m128 z2 = _mm_add_ps(_mm_mul_ps(oddTmp10, _mm_set1_ps(0.541196100f)), z5);
+		const __m128 z4 = _mm_add_ps(_mm_mul_ps(oddTmp12, _mm_set1_ps(1.306562965f)), z5);
+		const __m128 z3 = _mm_mul_ps(oddTmp11, _mm_set1_ps(0.707106781f));
+		const __m128 z11 = _mm_add_ps(tmp7, z3);
+		const __m128 z13 = _mm_sub_ps(tmp7, z3);
+		d5 = _mm_add_ps(z13, z2);
+		d3 = _mm_sub_ps(z13, z2);
+		d1 = _mm_add_ps(z11, z4);
+		d7 = _mm_sub_ps(z11, z4);
+	}
+
+
+	static inline void transpose8x8(__m128 block[8][2])
+	{
+		_MM_TRANSPOSE4_PS(block[0][0], block[1][0], block[2][0], block[3][0]);
+		_MM_TRANSPOSE4_PS(block[0][1], block[1][1], block[2][1], block[3][1]);
+		_MM_TRANSPOSE4_PS(block[4][0], block[5][0], block[6][0], block[7][0]);
+		_MM_TRANSPOSE4_PS(block[4][1], block[5][1], block[6][1], block[7][1]);
+		// swap the top right and bottom left 4x4 blocks
+		for(int i = 0; i < 4; i++)
+		{
+			std::swap(block[i][1], block[i + 4][0]);
+		}
+	}
+
+
+	int encodeBlock(BitWriter& writer, __m128 block[8][2], const float* scales, int previousDC, const HuffmanTable& dcTable, const HuffmanTable& acTable)
+	{
+		// column dcts (each row is a vector), then the row dcts on the transposed block. The result is transposed: coefficient (row, column) is at
+		// block[column][row], which the scales and the zigzag order below take into account.
+		for(int half = 0; half < 2; half++)
+		{
+			dct8(block[0][half], block[1][half], block[2][half], block[3][half], block[4][half], block[5][half], block[6][half], block[7][half]);
+		}
+		transpose8x8(block);
+		for(int half = 0; half < 2; half++)
+		{
+			dct8(block[0][half], block[1][half], block[2][half], block[3][half], block[4][half], block[5][half], block[6][half], block[7][half]);
+		}
+
+		// quantize, rounding half away from zero like stb does.
+		alignas(16) int16_t quantized[64];
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		for(int row = 0; row < 8; row++)
+		{
+			__m128i values[2];
+			for(int i = 0; i < 2; i++)
+			{
+				const __m128 scaled = _mm_mul_ps(block[row][i], _mm_load_ps(scales + row * 8 + i * 4));
+				values[i] = _mm_cvttps_epi32(_mm_add_ps(scaled, _mm_or_ps(half, _mm_and_ps(scaled, signMask))));
+			}
+			_mm_store_si128((__m128i*)(quantized + row * 8), _mm_packs_epi32(values[0], values[1]));
+		}
+		alignas(16) int16_t coefficients[64];
+		for(int row = 0; row < 8; row++)
+		{
+			for(int column = 0; column < 8; column++)
+			{
+				// quantized is transposed, see above
+				coefficients[ZIGZAG[row * 8 + column]] = quantized[column * 8 + row];
+			}
+		}
+
+		// bitmask of the non-zero coefficients in zigzag order, so runs of zeros can be skipped in one go.
+		uint64_t zeroMask = 0;
+		const __m128i zero = _mm_setzero_si128();
+		for(int i = 0; i < 4; i++)
+		{
+			const __m128i low = _mm_cmpeq_epi16(_mm_load_si128((const __m128i*)(coefficients + i * 16)), zero);
+			const __m128i high = _mm_cmpeq_epi16(_mm_load_si128((const __m128i*)(coefficients + i * 16 + 8)), zero);
+			zeroMask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_packs_epi16(low, high)) << (i * 16);
+		}
+		uint64_t nonZeroMask = ~zeroMask;
+
+		auto writeValue = [&writer](const HuffmanCode& huffmanCode, int value, int numberOfValueBits)
+		{
+			// negative values are written as value - 1 in numberOfValueBits bits.
+			const uint32_t valueBits = (uint32_t)(value < 0 ? value - 1 : value) & ((1u << numberOfValueBits) - 1);
+			writer.writeBits(((uint32_t)huffmanCode.code << numberOfValueBits) | valueBits, huffmanCode.length + numberOfValueBits);
+		};
+
+		// DC
+		const int dc = coefficients[0];
+		const int dcDifference = dc - previousDC;
+		const int numberOfDCBits = std::bit_width((uint32_t)(dcDifference < 0 ? -dcDifference : dcDifference));
+		writeValue(dcTable.codes[numberOfDCBits], dcDifference, numberOfDCBits);
+
+		// AC
+		nonZeroMask &= ~1ull;
+		int lastIndex = 0;
+		while(nonZeroMask != 0)
+		{
+			const int index = std::countr_zero(nonZeroMask);
+			int numberOfZeros = index - lastIndex - 1;
+			while(numberOfZeros >= 16)
+			{
+				// ZRL, 16 zeros
+				writer.writeBits(acTable.codes[0xF0].code, acTable.codes[0xF0].length);
+				numberOfZeros -= 16;
+			}
+			const int value = coefficients[index];
+			const int numberOfValueBits = std::bit_width((uint32_t)(value < 0 ? -value : value));
+			writeValue(acTable.codes[(numberOfZeros << 4) + numberOfValueBits], value, numberOfValueBits);
+			lastIndex = index;
+			nonZeroMask &= nonZeroMask - 1;
+		}
+		if(lastIndex != 63)
+		{
+			// EOB
+			writer.writeBits(acTable.codes[0x00].code, acTable.codes[0x00].length);
+		}
+		return dc;
+	}
+}
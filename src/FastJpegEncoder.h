@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace IGCS::FastJpegEncoder
+{
+	/// <summary>
+	/// Returns true if the CPU supports the instructions the encoder needs (SSSE3). 
+	/// </summary>
+	bool isSupported();
+	/// <summary>
+	/// Encodes the RGB image specified as a baseline JPEG. The quantization and Huffman tables are the same as the ones stbi_write_jpg uses, color
+	/// conversion, DCT and quantization are vectorized with SSE. Chroma is never subsampled. If more than one thread is used, the image is split into
+	/// bands of MCU rows which are encoded in parallel and separated by restart markers.
+	/// </summary>
+	/// <param name="pixels">width * height * 3 bytes of RGB data, no padding between rows</param>
+	/// <param name="width"></param>
+	/// <param name="height"></param>
+	/// <param name="quality">1-100, maps to the same quantization tables as stbi_write_jpg. Below 90 stbi_write_jpg subsamples chroma 2x2 and this
+	/// encoder doesn't, so at those settings the files are larger than stb's and keep more color detail. At 90 and up the output matches stb's in size
+	/// and quality</param>
+	/// <param name="encodedData">receives the jpg file contents</param>
+	/// <param name="numberOfThreads">the number of threads to use. If 0, the number of cores is used</param>
+	/// <returns>true if the encoding succeeded, false otherwise</returns>
+	bool encodeImageToMemory(const uint8_t* pixels, uint32_t width, uint32_t height, int quality, std::vector<uint8_t>& encodedData, uint32_t numberOfThreads = 1);
+}
@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "FrameBufferPool.h"
+
+
+FrameBuffer::FrameBuffer(FrameBufferSource* owner, uint8_t* bytes, size_t capacity, size_t size)
+	: _owner(owner), _bytes(bytes), _capacity(capacity), _size(size)
+{
+}
+
+
+FrameBuffer::~FrameBuffer()
+{
+	release();
+}
+
+
+FrameBuffer::FrameBuffer(FrameBuffer&& other) noexcept
+	: _owner(other._owner), _bytes(other._bytes), _capacity(other._capacity), _size(other._size)
+{
+	other._owner = nullptr;
+	other._bytes = nullptr;
+	other._capacity = 0;
+	other._size = 0;
+}
+
+
+FrameBuffer& FrameBuffer::operator=(FrameBuffer&& other) noexcept
+{
+	if(this != &other)
+	{
+		release();
+		_owner = other._owner;
+		_bytes = other._bytes;
+		_capacity = other._capacity;
+		_size = other._size;
+		other._owner = nullptr;
+		other._bytes = nullptr;
+		other._capacity = 0;
+		other._size = 0;
+	}
+	return *this;
+}
+
+
+void FrameBuffer::release()
+{
+	if(nullptr != _owner && nullptr != _bytes)
+	{
+		_owner->returnBuffer(_bytes, _capacity);
+	}
+	_owner = nullptr;
+	_bytes = nullptr;
+	_capacity = 0;
+	_size = 0;
+}
+
+
+FrameBuffer FrameBufferPool::tryAcquire(size_t sizeInBytes)
+{
+	std::scoped_lock lock(_poolMutex);
+	// a free buffer which is too small is replaced, so the budget is checked with the size of the buffer which is actually handed out.
+	const bool reuseFreeBuffer = !_freeBuffers.empty() && _freeBuffers.back().capacity >= sizeInBytes;
+	const size_t capacityToHandOut = reuseFreeBuffer ? _freeBuffers.back().capacity : sizeInBytes;
+	if(_numberOfBuffersInUse > 0 && _numberOfBytesInUse + capacityToHandOut > _memoryBudgetInBytes)
+	{
+		return {};
+	}
+
+	PooledBuffer toReturn;
+	if(!_freeBuffers.empty())
+	{
+		toReturn = std::move(_freeBuffers.back());
+		_freeBuffers.pop_back();
+	}
+	if(!reuseFreeBuffer)
+	{
+		// either no free buffer or the resolution went up. Not initialized, as the frame data is always written over it completely.
+		toReturn.bytes.reset(new uint8_t[sizeInBytes]);
+		toReturn.capacity = sizeInBytes;
+	}
+	_numberOfBuffersInUse++;
+	_numberOfBytesInUse += toReturn.capacity;
+	return FrameBuffer(this, toReturn.bytes.release(), toReturn.capacity, sizeInBytes);
+}
+
+
+void FrameBufferPool::clear()
+{
+	std::scoped_lock lock(_poolMutex);
+	_freeBuffers.clear();
+}
+
+
+void FrameBufferPool::setMemoryBudget(size_t budgetInBytes)
+{
+	std::scoped_lock lock(_poolMutex);
+	_memoryBudgetInBytes = budgetInBytes;
+}
+
+
+int FrameBufferPool::numberOfBuffersInUse()
+{
+	std::scoped_lock lock(_poolMutex);
+	return _numberOfBuffersInUse;
+}
+
+
+void FrameBufferPool::returnBuffer(uint8_t* bytes, size_t capacity)
+{
+	PooledBuffer toStore;
+	toStore.bytes.reset(bytes);
+	toStore.capacity = capacity;
+
+	std::scoped_lock lock(_poolMutex);
+	_numberOfBuffersInUse--;
+	_numberOfBytesInUse -= capacity;
+	size_t numberOfBytesPooled = _numberOfBytesInUse;
+	for(const auto& freeBuffer : _freeBuffers)
+	{
+		numberOfBytesPooled += freeBuffer.capacity;
+	}
+	if(numberOfBytesPooled + capacity > _memoryBudgetInBytes)
+	{
+		// the budget was lowered while this buffer was in use, don't keep it around. 
+		return;
+	}
+	_freeBuffers.push_back(std::move(toStore));
+}
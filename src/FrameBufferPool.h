@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// Interface for objects which hand out FrameBuffers and get the memory back when the buffer is released.
+/// </summary>
+class FrameBufferSource
+{
+public:
+	virtual ~FrameBufferSource() = default;
+	virtual void returnBuffer(uint8_t* bytes, size_t capacity) = 0;
+};
+
+
+/// <summary>
+/// Move-only owner of a buffer obtained from a FrameBufferSource. The buffer is returned to the source it came from when this object is destroyed, so
+/// ownership can be passed from the capture code to the writer without copying the frame data. 
+/// </summary>
+class FrameBuffer
+{
+public:
+	FrameBuffer() = default;
+	FrameBuffer(FrameBufferSource* owner, uint8_t* bytes, size_t capacity, size_t size);
+	~FrameBuffer();
+	FrameBuffer(const FrameBuffer&) = delete;
+	FrameBuffer& operator=(const FrameBuffer&) = delete;
+	FrameBuffer(FrameBuffer&& other) noexcept;
+	FrameBuffer& operator=(FrameBuffer&& other) noexcept;
+
+	/// <summary>
+	/// Returns the buffer to its source. After this call the buffer is empty. 
+	/// </summary>
+	void release();
+
+	uint8_t* data() { return _bytes; }
+	const uint8_t* data() const { return _bytes; }
+	size_t size() const { return _size; }
+	bool isEmpty() const { return nullptr == _bytes; }
+
+private:
+	FrameBufferSource* _owner = nullptr;
+	uint8_t* _bytes = nullptr;
+	size_t _capacity = 0;		// allocated size of _bytes
+	size_t _size = 0;			// size requested when the buffer was acquired
+};
+
+
+/// <summary>
+/// Pool of recycled frame buffers in memory. The total size of the buffers handed out at the same time is capped by a memory budget, which caps
+/// the memory used by the frames which are grabbed but not yet written to disk. 
+/// </summary>
+class FrameBufferPool : public FrameBufferSource
+{
+	struct PooledBuffer
+	{
+		std::unique_ptr<uint8_t[]> bytes;
+		size_t capacity = 0;
+	};
+
+public:
+	FrameBufferPool() = default;
+	~FrameBufferPool() override = default;
+	FrameBufferPool(const FrameBufferPool&) = delete;
+	FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+	/// <summary>
+	/// Returns a buffer of at least sizeInBytes bytes. If handing out the buffer would exceed the memory budget, an empty buffer is returned. A single
+	/// buffer is always handed out, even if it's larger than the budget. Never blocks.
+	/// </summary>
+	/// <param name="sizeInBytes"></param>
+	FrameBuffer tryAcquire(size_t sizeInBytes);
+	/// <summary>
+	/// Frees the memory of all buffers which are currently not in use.
+	/// </summary>
+	void clear();
+	void setMemoryBudget(size_t budgetInBytes);
+	int numberOfBuffersInUse();
+	void returnBuffer(uint8_t* bytes, size_t capacity) override;
+
+private:
+	std::vector<PooledBuffer> _freeBuffers;
+	int _numberOfBuffersInUse = 0;
+	size_t _numberOfBytesInUse = 0;
+	size_t _memoryBudgetInBytes = 1024ULL * 1024 * 1024;
+	std::mutex _poolMutex;
+};
@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "FrameSpillFile.h"
+#include "Utils.h"
+
+
+FrameSpillFile::~FrameSpillFile()
+{
+	close();
+}
+
+
+bool FrameSpillFile::open(const std::string& folder)
+{
+	close();
+	std::scoped_lock lock(_spillMutex);
+	const std::string filename = IGCS::Utils::formatString("%s%cIgcsConnector_spill.tmp", folder.c_str(), IGCS::Platform::PATH_SEPARATOR);
+	// removed when it's closed, so we never leave the (large) file behind, also not when the game crashes.
+	_file = IGCS::Platform::createScratchFile(filename);
+	_numberOfFramesSpilled = 0;
+	return nullptr != _file;
+}
+
+
+void FrameSpillFile::close()
+{
+	std::scoped_lock lock(_spillMutex);
+	for(auto& viewSlotPair : _slotPerView)
+	{
+		IGCS::Platform::unmapScratchFileView(viewSlotPair.first, viewSlotPair.second.sizeInBytes);
+	}
+	_slotPerView.clear();
+	IGCS::Platform::closeScratchFile(_file);
+	_file = nullptr;
+	_freeSlots.clear();
+	_numberOfSlots = 0;
+	_slotSize = 0;
+}
+
+
+FrameBuffer FrameSpillFile::tryAcquire(size_t sizeInBytes)
+{
+	std::scoped_lock lock(_spillMutex);
+	if(nullptr == _file)
+	{
+		return {};
+	}
+
+	if(sizeInBytes > _slotSize)
+	{
+		if(!_slotPerView.empty())
+		{
+			// the resolution went up while frames are still spilled. We can't resize the slots, so let the caller wait. 
+			return {};
+		}
+		// (re)start with larger slots
+		_freeSlots.clear();
+		_numberOfSlots = 0;
+		const size_t granularity = IGCS::Platform::mappingGranularity();
+		_slotSize = ((sizeInBytes + granularity - 1) / granularity) * granularity;
+	}
+	if(_freeSlots.empty() && !grow(_slotSize))
+	{
+		return {};
+	}
+
+	const int slot = _freeSlots.back();
+	const uint64_t offset = (uint64_t)slot * _slotSize;
+	uint8_t* view = IGCS::Platform::mapScratchFileView(_file, offset, sizeInBytes);
+	if(nullptr == view)
+	{
+		return {};
+	}
+	_freeSlots.pop_back();
+	_slotPerView[view] = { slot, sizeInBytes };
+	_numberOfFramesSpilled++;
+	return FrameBuffer(this, view, sizeInBytes, sizeInBytes);
+}
+
+
+void FrameSpillFile::returnBuffer(uint8_t* bytes, size_t capacity)
+{
+	std::scoped_lock lock(_spillMutex);
+	const auto it = _slotPerView.find(bytes);
+	if(it == _slotPerView.end())
+	{
+		return;
+	}
+	IGCS::Platform::unmapScratchFileView(bytes, it->second.sizeInBytes);
+	_freeSlots.push_back(it->second.slot);
+	_slotPerView.erase(it);
+}
+
+
+bool FrameSpillFile::grow(size_t slotSize)
+{
+	// the file grows with the number of frames waiting to be written at the same time, not with the number of frames in the session. 
+	const int newNumberOfSlots = _numberOfSlots <= 0 ? 4 : _numberOfSlots * 2;
+	const uint64_t newFileSize = (uint64_t)newNumberOfSlots * slotSize;
+	if(!IGCS::Platform::resizeScratchFile(_file, newFileSize))
+	{
+		// likely out of disk space.
+		return false;
+	}
+	for(int i = newNumberOfSlots - 1; i >= _numberOfSlots; i--)
+	{
+		_freeSlots.push_back(i);
+	}
+	_numberOfSlots = newNumberOfSlots;
+	return true;
+}
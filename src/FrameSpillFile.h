@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "stdafx.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FrameBufferPool.h"
+#include "Platform.h"
+
+
+/// <summary>
+/// Scratch file on disk which stores grabbed frames raw and uncompressed when the memory budget for grabbed frames has been reached. The frames are
+/// memory mapped views on the file, so they're handed out as FrameBuffers like in-memory frames. The file is removed when it's closed.
+/// </summary>
+class FrameSpillFile : public FrameBufferSource
+{
+public:
+	FrameSpillFile() = default;
+	~FrameSpillFile() override;
+	FrameSpillFile(const FrameSpillFile&) = delete;
+	FrameSpillFile& operator=(const FrameSpillFile&) = delete;
+
+	/// <summary>
+	/// Creates the scratch file in the folder specified. Returns false if the file couldn't be created.
+	/// </summary>
+	bool open(const std::string& folder);
+	/// <summary>
+	/// Closes and removes the scratch file. All buffers handed out have to be released before this call.
+	/// </summary>
+	void close();
+	/// <summary>
+	/// Returns a buffer of sizeInBytes bytes which is backed by the scratch file. The file grows if there's no free slot. Returns an empty
+	/// buffer if the file isn't open or couldn't grow.
+	/// </summary>
+	FrameBuffer tryAcquire(size_t sizeInBytes);
+	int numberOfFramesSpilled() { return _numberOfFramesSpilled; }
+	void returnBuffer(uint8_t* bytes, size_t capacity) override;
+
+private:
+	bool grow(size_t slotSize);
+
+	IGCS::Platform::ScratchFile* _file = nullptr;
+	size_t _slotSize = 0;				// size of a slot in the file, aligned to the mapping granularity
+	std::vector<int> _freeSlots;
+	int _numberOfSlots = 0;
+	struct MappedSlot
+	{
+		int slot;
+		size_t sizeInBytes;
+	};
+	std::unordered_map<uint8_t*, MappedSlot> _slotPerView;
+	int _numberOfFramesSpilled = 0;
+	std::mutex _spillMutex;
+};
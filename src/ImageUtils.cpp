@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "ImageUtils.h"
+#include <intrin.h>
+#include <immintrin.h>
+
+namespace IGCS::ImageUtils
+{
+	//-----------------------------------------------
+	// forward declarations
+	void packRGBAToRGBScalar(const uint8_t* source, uint8_t* destination, size_t numberOfPixels);
+	void packRGBAToRGBSSSE3(const uint8_t* source, uint8_t* destination, size_t numberOfPixels);
+	void packRGBAToRGBAVX2(const uint8_t* source, uint8_t* destination, size_t numberOfPixels);
+	PackKernel detectBestSupportedPackKernel();
+
+	//-----------------------------------------------
+	// code
+
+	void packRGBAToRGB(const uint8_t* source, uint8_t* destination, size_t numberOfPixels)
+	{
+		static const PackKernel kernelToUse = bestSupportedPackKernel();
+		packRGBAToRGB(source, destination, numberOfPixels, kernelToUse);
+	}
+
+
+	void packRGBAToRGB(const uint8_t* source, uint8_t* destination, size_t numberOfPixels, PackKernel kernelToUse)
+	{
+		switch(kernelToUse)
+		{
+		case PackKernel::AVX2:
+			packRGBAToRGBAVX2(source, destination, numberOfPixels);
+			break;
+		case PackKernel::SSSE3:
+			packRGBAToRGBSSSE3(source, destination, numberOfPixels);
+			break;
+		default:
+			packRGBAToRGBScalar(source, destination, numberOfPixels);
+			break;
+		}
+	}
+
+
+	PackKernel bestSupportedPackKernel()
+	{
+		static const PackKernel bestKernel = detectBestSupportedPackKernel();
+		return bestKernel;
+	}
+
+
+	const char* packKernelName(PackKernel kernel)
+	{
+		switch(kernel)
+		{
+		case PackKernel::AVX2:
+			return "AVX2";
+		case PackKernel::SSSE3:
+			return "SSSE3";
+		default:
+			return "Scalar";
+		}
+	}
+
+
+	bool benefitsFromParallelEncoding(uint32_t width, uint32_t height)
+	{
+		// anything larger than a 4K frame.
+		return (uint64_t)width * height > 3840ull * 2160ull;
+	}
+
+
+	PackKernel detectBestSupportedPackKernel()
+	{
+		int registers[4] = { 0 };
+		__cpuid(registers, 0);
+		const int maxLeaf = registers[0];
+		if(maxLeaf < 1)
+		{
+			return PackKernel::Scalar;
+		}
+		__cpuid(registers, 1);
+		const bool hasSSSE3 = (registers[2] & (1 << 9)) != 0;
+		const bool hasOSXSave = (registers[2] & (1 << 27)) != 0;
+		const bool hasAVX = (registers[2] & (1 << 28)) != 0;
+		bool hasAVX2 = false;
+		// AVX2 is only usable if the OS saves the YMM registers as well.
+		if(maxLeaf >= 7 && hasOSXSave && hasAVX && (_xgetbv(0) & 0x6) == 0x6)
+		{
+			__cpuidex(registers, 7, 0);
+			hasAVX2 = (registers[1] & (1 << 5)) != 0;
+		}
+		if(hasAVX2)
+		{
+			return PackKernel::AVX2;
+		}
+		return hasSSSE3 ? PackKernel::SSSE3 : PackKernel::Scalar;
+	}
+
+
+	void packRGBAToRGBScalar(const uint8_t* source, uint8_t* destination, size_t numberOfPixels)
+	{
+		// byte copies so we never write past the last pixel in destination.
+		for(size_t i = 0; i < numberOfPixels; ++i)
+		{
+			destination[3 * i] = source[4 * i];
+			destination[3 * i + 1] = source[4 * i + 1];
+			destination[3 * i + 2] = source[4 * i + 2];
+		}
+	}
+
+
+	TARGET_INSTRUCTION_SET("ssse3") void packRGBAToRGBSSSE3(const uint8_t* source, uint8_t* destination, size_t numberOfPixels)
+	{
+		// Per 16 pixels: 4 loads, each shuffled to 12 RGB bytes, which are then merged into 3 full stores. All loads of a block are done before
+		// its stores, and the stores never pass the source offset of the next block, so this is safe to do in place.
+		const __m128i shuffleMask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+		size_t i = 0;
+		for(; i + 16 <= numberOfPixels; i += 16)
+		{
+			const uint8_t* sourceBlock = source + 4 * i;
+			const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBlock)), shuffleMask);
+			const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBlock + 16)), shuffleMask);
+			const __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBlock + 32)), shuffleMask);
+			const __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBlock + 48)), shuffleMask);
+
+			uint8_t* destinationBlock = destination + 3 * i;
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destinationBlock), _mm_or_si128(a, _mm_slli_si128(b, 12)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destinationBlock + 16), _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destinationBlock + 32), _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+		}
+		packRGBAToRGBScalar(source + 4 * i, destination + 3 * i, numberOfPixels - i);
+	}
+
+
+	TARGET_INSTRUCTION_SET("avx2") void packRGBAToRGBAVX2(const uint8_t* source, uint8_t* destination, size_t numberOfPixels)
+	{
+		// Per 32 pixels: 4 loads of 8 pixels. The shuffle packs each 128-bit lane to 12 bytes, the permute moves these to the low 24 bytes. The first 3
+		// stores write 32 bytes of which the last 8 are overwritten by the next store, the last store writes exactly 24 bytes. As with the SSSE3
+		// kernel, all loads of a block are done before its stores so this is safe to do in place.
+		const __m256i shuffleMask = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+													 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+		const __m256i permuteMask = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+		size_t i = 0;
+		for(; i + 32 <= numberOfPixels; i += 32)
+		{
+			const uint8_t* sourceBlock = source + 4 * i;
+			const __m256i a = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceBlock)), shuffleMask), permuteMask);
+			const __m256i b = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceBlock + 32)), shuffleMask), permuteMask);
+			const __m256i c = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceBlock + 64)), shuffleMask), permuteMask);
+			const __m256i d = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceBlock + 96)), shuffleMask), permuteMask);
+
+			uint8_t* destinationBlock = destination + 3 * i;
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(destinationBlock), a);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(destinationBlock + 24), b);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(destinationBlock + 48), c);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destinationBlock + 72), _mm256_castsi256_si128(d));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(destinationBlock + 88), _mm256_extracti128_si256(d, 1));
+		}
+		packRGBAToRGBSSSE3(source + 4 * i, destination + 3 * i, numberOfPixels - i);
+	}
+}
@@ -0,0 +1,66 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+
+namespace IGCS::ImageUtils
+{
+	enum class PackKernel : int
+	{
+		Scalar,
+		SSSE3,
+		AVX2,
+	};
+
+	/// <summary>
+	/// Packs RGBA pixels as RGB pixels by dropping the alpha channel. The best kernel supported by the CPU is selected the first time this is called.
+	/// </summary>
+	/// <param name="source">numberOfPixels * 4 bytes of RGBA data</param>
+	/// <param name="destination">receives numberOfPixels * 3 bytes of RGB data. Can be the same buffer as source, so the data is packed in place</param>
+	/// <param name="numberOfPixels"></param>
+	void packRGBAToRGB(const uint8_t* source, uint8_t* destination, size_t numberOfPixels);
+	/// <summary>
+	/// Same as packRGBAToRGB but with the kernel to use specified. The kernel has to be supported by the CPU.
+	/// </summary>
+	void packRGBAToRGB(const uint8_t* source, uint8_t* destination, size_t numberOfPixels, PackKernel kernelToUse);
+	/// <summary>
+	/// Returns the fastest pack kernel the CPU supports.
+	/// </summary>
+	PackKernel bestSupportedPackKernel();
+	const char* packKernelName(PackKernel kernel);
+	/// <summary>
+	/// Returns true if an image of the dimensions specified is large enough to be encoded using multiple threads. Smaller images are encoded faster
+	/// on a single thread, as the screenshot writer encodes several of them in parallel already.
+	/// </summary>
+	bool benefitsFromParallelEncoding(uint32_t width, uint32_t height);
+}
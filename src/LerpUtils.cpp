@@ -0,0 +1,226 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "LerpUtils.h"
+#include <intrin.h>
+#include <immintrin.h>
+
+namespace IGCS::LerpUtils
+{
+	//-----------------------------------------------
+	// forward declarations
+	void lerpFloatsScalar(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats);
+	void lerpFloatsSSE(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats);
+	void lerpFloatsAVX(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats);
+	void evaluateCubicFloatsScalar(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats);
+	void evaluateCubicFloatsSSE(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats);
+	void evaluateCubicFloatsAVX(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats);
+	LerpKernel detectBestSupportedLerpKernel();
+
+	//-----------------------------------------------
+	// code
+
+	void lerpFloats(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats)
+	{
+		static const LerpKernel kernelToUse = bestSupportedLerpKernel();
+		lerpFloats(start, delta, interpolationFactor, destination, numberOfFloats, kernelToUse);
+	}
+
+
+	void lerpFloats(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats, LerpKernel kernelToUse)
+	{
+		switch(kernelToUse)
+		{
+		case LerpKernel::AVX:
+			lerpFloatsAVX(start, delta, interpolationFactor, destination, numberOfFloats);
+			break;
+		case LerpKernel::SSE:
+			lerpFloatsSSE(start, delta, interpolationFactor, destination, numberOfFloats);
+			break;
+		default:
+			lerpFloatsScalar(start, delta, interpolationFactor, destination, numberOfFloats);
+			break;
+		}
+	}
+
+
+	void evaluateCubicFloats(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats)
+	{
+		static const LerpKernel kernelToUse = bestSupportedLerpKernel();
+		evaluateCubicFloats(a, b, c, d, t, destination, numberOfFloats, kernelToUse);
+	}
+
+
+	void evaluateCubicFloats(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats, LerpKernel kernelToUse)
+	{
+		switch(kernelToUse)
+		{
+		case LerpKernel::AVX:
+			evaluateCubicFloatsAVX(a, b, c, d, t, destination, numberOfFloats);
+			break;
+		case LerpKernel::SSE:
+			evaluateCubicFloatsSSE(a, b, c, d, t, destination, numberOfFloats);
+			break;
+		default:
+			evaluateCubicFloatsScalar(a, b, c, d, t, destination, numberOfFloats);
+			break;
+		}
+	}
+
+
+	LerpKernel bestSupportedLerpKernel()
+	{
+		static const LerpKernel bestKernel = detectBestSupportedLerpKernel();
+		return bestKernel;
+	}
+
+
+	const char* lerpKernelName(LerpKernel kernel)
+	{
+		switch(kernel)
+		{
+		case LerpKernel::AVX:
+			return "AVX";
+		case LerpKernel::SSE:
+			return "SSE";
+		default:
+			return "Scalar";
+		}
+	}
+
+
+	LerpKernel detectBestSupportedLerpKernel()
+	{
+		// SSE2 is part of x64, so only AVX has to be checked.
+		int registers[4] = { 0 };
+		__cpuid(registers, 0);
+		if(registers[0] < 1)
+		{
+			return LerpKernel::SSE;
+		}
+		__cpuid(registers, 1);
+		const bool hasOSXSave = (registers[2] & (1 << 27)) != 0;
+		const bool hasAVX = (registers[2] & (1 << 28)) != 0;
+		// AVX is only usable if the OS saves the YMM registers as well.
+		if(hasOSXSave && hasAVX && (_xgetbv(0) & 0x6) == 0x6)
+		{
+			return LerpKernel::AVX;
+		}
+		return LerpKernel::SSE;
+	}
+
+
+	void lerpFloatsScalar(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats)
+	{
+		for(size_t i = 0; i < numberOfFloats; ++i)
+		{
+			destination[i] = start[i] + (delta[i] * interpolationFactor);
+		}
+	}
+
+
+	void lerpFloatsSSE(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats)
+	{
+		// Per 8 floats (2 float4 uniforms): 2 independent multiply-adds, so the loop isn't bound by the latency of a single one.
+		const __m128 factor = _mm_set1_ps(interpolationFactor);
+		size_t i = 0;
+		for(; i + 8 <= numberOfFloats; i += 8)
+		{
+			const __m128 a = _mm_add_ps(_mm_loadu_ps(start + i), _mm_mul_ps(_mm_loadu_ps(delta + i), factor));
+			const __m128 b = _mm_add_ps(_mm_loadu_ps(start + i + 4), _mm_mul_ps(_mm_loadu_ps(delta + i + 4), factor));
+			_mm_storeu_ps(destination + i, a);
+			_mm_storeu_ps(destination + i + 4, b);
+		}
+		lerpFloatsScalar(start + i, delta + i, interpolationFactor, destination + i, numberOfFloats - i);
+	}
+
+
+	TARGET_INSTRUCTION_SET("avx") void lerpFloatsAVX(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats)
+	{
+		// Per 16 floats (4 float4 uniforms). No FMA, so the results are bit identical to the other kernels.
+		const __m256 factor = _mm256_set1_ps(interpolationFactor);
+		size_t i = 0;
+		for(; i + 16 <= numberOfFloats; i += 16)
+		{
+			const __m256 a = _mm256_add_ps(_mm256_loadu_ps(start + i), _mm256_mul_ps(_mm256_loadu_ps(delta + i), factor));
+			const __m256 b = _mm256_add_ps(_mm256_loadu_ps(start + i + 8), _mm256_mul_ps(_mm256_loadu_ps(delta + i + 8), factor));
+			_mm256_storeu_ps(destination + i, a);
+			_mm256_storeu_ps(destination + i + 8, b);
+		}
+		// avoid AVX-SSE transition penalties in the code after this.
+		_mm256_zeroupper();
+		lerpFloatsSSE(start + i, delta + i, interpolationFactor, destination + i, numberOfFloats - i);
+	}
+
+
+	void evaluateCubicFloatsScalar(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats)
+	{
+		for(size_t i = 0; i < numberOfFloats; ++i)
+		{
+			destination[i] = ((((d[i] * t) + c[i]) * t) + b[i]) * t + a[i];
+		}
+	}
+
+
+	void evaluateCubicFloatsSSE(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats)
+	{
+		// Per 4 floats (1 float4 uniform). Same order of operations as the scalar kernel so the results are identical.
+		const __m128 tVector = _mm_set1_ps(t);
+		size_t i = 0;
+		for(; i + 4 <= numberOfFloats; i += 4)
+		{
+			__m128 result = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(d + i), tVector), _mm_loadu_ps(c + i));
+			result = _mm_add_ps(_mm_mul_ps(result, tVector), _mm_loadu_ps(b + i));
+			result = _mm_add_ps(_mm_mul_ps(result, tVector), _mm_loadu_ps(a + i));
+			_mm_storeu_ps(destination + i, result);
+		}
+		evaluateCubicFloatsScalar(a + i, b + i, c + i, d + i, t, destination + i, numberOfFloats - i);
+	}
+
+
+	TARGET_INSTRUCTION_SET("avx") void evaluateCubicFloatsAVX(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats)
+	{
+		// Per 8 floats (2 float4 uniforms). No FMA, see lerpFloatsAVX.
+		const __m256 tVector = _mm256_set1_ps(t);
+		size_t i = 0;
+		for(; i + 8 <= numberOfFloats; i += 8)
+		{
+			__m256 result = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(d + i), tVector), _mm256_loadu_ps(c + i));
+			result = _mm256_add_ps(_mm256_mul_ps(result, tVector), _mm256_loadu_ps(b + i));
+			result = _mm256_add_ps(_mm256_mul_ps(result, tVector), _mm256_loadu_ps(a + i));
+			_mm256_storeu_ps(destination + i, result);
+		}
+		_mm256_zeroupper();
+		evaluateCubicFloatsSSE(a + i, b + i, c + i, d + i, t, destination + i, numberOfFloats - i);
+	}
+}
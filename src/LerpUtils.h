@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstddef>
+
+namespace IGCS::LerpUtils
+{
+	enum class LerpKernel : int
+	{
+		Scalar,
+		SSE,
+		AVX,
+	};
+
+	/// <summary>
+	/// Interpolates a batch of floats: destination[i] = start[i] + (delta[i] * interpolationFactor). The best kernel supported by the CPU is selected the
+	/// first time this is called. Float4 uniforms are passed as 4 consecutive floats each, so all uniforms of a snapshot pair are done in one pass.
+	/// </summary>
+	/// <param name="start">the values at interpolation factor 0</param>
+	/// <param name="delta">the value at interpolation factor 1 minus the value in start</param>
+	/// <param name="interpolationFactor"></param>
+	/// <param name="destination">receives numberOfFloats floats</param>
+	/// <param name="numberOfFloats"></param>
+	void lerpFloats(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats);
+	/// <summary>
+	/// Same as lerpFloats but with the kernel to use specified. The kernel has to be supported by the CPU.
+	/// </summary>
+	void lerpFloats(const float* start, const float* delta, float interpolationFactor, float* destination, size_t numberOfFloats, LerpKernel kernelToUse);
+	/// <summary>
+	/// Evaluates a batch of cubic polynomials: destination[i] = a[i] + (b[i] * t) + (c[i] * t^2) + (d[i] * t^3), using Horner's scheme. Uses the same kernel
+	/// as lerpFloats.
+	/// </summary>
+	void evaluateCubicFloats(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats);
+	/// <summary>
+	/// Same as evaluateCubicFloats but with the kernel to use specified. The kernel has to be supported by the CPU.
+	/// </summary>
+	void evaluateCubicFloats(const float* a, const float* b, const float* c, const float* d, float t, float* destination, size_t numberOfFloats, LerpKernel kernelToUse);
+	/// <summary>
+	/// Returns the fastest lerp kernel the CPU supports.
+	/// </summary>
+	LerpKernel bestSupportedLerpKernel();
+	const char* lerpKernelName(LerpKernel kernel);
+}
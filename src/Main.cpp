@@ -37,20 +37,27 @@
 #include "stdafx.h"
 #include <imgui.h>
 #include <reshade.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iomanip>
 #include <ios>
 #include <Psapi.h>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "CameraToolsData.h"
+#include "CameraToolsDataExchange.h"
 #include "CDataFile.h"
 #include "DepthOfFieldController.h"
+#include "fpng.h"
 #include "ScreenshotController.h"
 #include "ScreenshotSettings.h"
 #include "OverlayControl.h"
 #include "ReshadeStateController.h"
 #include "ThreadSafeQueue.h"
+#include "Utils.h"
 #include "WorkItem.h"
 
 using namespace reshade::api;
@@ -62,6 +69,7 @@ extern "C" __declspec(dllexport) const char *DESCRIPTION = "Add-on which allows
 // externs for IGCS
 extern "C" __declspec(dllexport) bool connectFromCameraTools();
 extern "C" __declspec(dllexport) LPBYTE getDataFromCameraToolsBuffer();
+extern "C" __declspec(dllexport) void writeCameraToolsData(const CameraToolsData* toWrite);
 extern "C" __declspec(dllexport) void addCameraPath();
 extern "C" __declspec(dllexport) void appendStateSnapshotAfterSnapshotOnPath(int pathIndex, int indexToAppendAfter);
 extern "C" __declspec(dllexport) void appendStateSnapshotToPath(int pathIndex);
@@ -74,15 +82,61 @@ extern "C" __declspec(dllexport) void setReshadeState(int pathIndex, int stateIn
 extern "C" __declspec(dllexport) void updateStateSnapshotOnPath(int pathIndex, int stateIndex);
 
 #define SETTINGS_FILE_NAME "IgcsConnector.ini"
+#define PATH_STATES_FILE_NAME "IgcsConnector_paths.bin"		// stored next to ReShade's config, see pathInReshadeBaseFolder
 
 static LPBYTE g_dataFromCameraToolsBuffer = nullptr;		// 8192 bytes buffer
+static CameraToolsData g_lastCameraToolsDataRead;			// the last consistent copy read from the exchange, used if a read gives up
 static CameraToolsConnector g_cameraToolsConnector;
 static ScreenshotSettings g_screenshotSettings;
 static ScreenshotController g_screenshotController(g_cameraToolsConnector);
 static DepthOfFieldController g_depthOfFieldController(g_cameraToolsConnector);
 static ReshadeStateController g_reshadeStateController;
-static IGCS::ThreadSafeQueue<WorkItem> g_presentWorkQueue;
+// the work queue holds the work for the next present, and together with the work deferred in earlier frames there's never more pending than it can hold.
+static const size_t PRESENT_WORK_QUEUE_CAPACITY = 1024;
+static IGCS::ThreadSafeQueue<WorkItem, PRESENT_WORK_QUEUE_CAPACITY> g_presentWorkQueue;
 static bool g_recordReshadeState = true;
+static int g_numberOfSupersededWorkItemsLastPresent = 0;
+// the time handleWorkQueue may spend per frame before it defers work to the next frame, see performWorkItems, and how often that happened.
+static const int MIN_WORK_BUDGET_PER_FRAME_IN_MICROSECONDS = 100;
+static const int MAX_WORK_BUDGET_PER_FRAME_IN_MICROSECONDS = 100000;
+static int g_workBudgetPerFrameInMicroseconds = 2000;
+static WorkBudget g_workBudget;
+static int g_numberOfWorkItemsDeferred = 0;
+static int g_numberOfFramesOverWorkBudget = 0;
+// work dropped because the work queue was full, and whether the user has been told since the last present.
+static std::atomic<int> g_numberOfWorkItemsDropped = 0;
+static std::atomic<bool> g_workDroppedNotified = false;
+
+// kinds of work which set the reshade state of a path. A later work item of the same kind for the same path supersedes an earlier one.
+static const uint64_t INTERPOLATED_STATE_WORK = 1;
+static const uint64_t SINGLE_STATE_WORK = 2;
+
+static uint64_t stateWorkCoalescingKey(uint64_t kindOfWork, int pathIndex)
+{
+	return (kindOfWork << 32) | (uint32_t)pathIndex;
+}
+
+/// <summary>
+/// Queues the work item for the next present. Never blocks: the present thread, which empties the queue, queues work too, and the camera tools mustn't
+/// stall on a game which doesn't present. If the queue is full the work item is dropped and the user is notified, once per present.
+/// </summary>
+/// <param name="workItem"></param>
+/// <param name="workDescription">what the work does, for the notification</param>
+/// <returns>true if the work item was queued, false if it was dropped</returns>
+static bool queuePresentWork(WorkItem&& workItem, const char* workDescription)
+{
+	if(g_presentWorkQueue.tryPush(std::move(workItem)))
+	{
+		return true;
+	}
+	g_numberOfWorkItemsDropped++;
+	if(!g_workDroppedNotified.exchange(true))
+	{
+		IGCS::Utils::logLineToReshade(reshade::log_level::warning, "Work queue is full, dropped: %s", workDescription);
+		OverlayControl::addNotification(IGCS::Utils::formatString("Too much work queued, dropped: %s", workDescription));
+	}
+	return false;
+}
 
 /// <summary>
 /// Entry point for IGCS camera tools. Call this to initialize the buffers. Obtain the buffers using the getDataFrom/ToCameraToolsBuffer functions
@@ -115,6 +169,49 @@ LPBYTE getDataFromCameraToolsBuffer()
 }
 
 
+/// <summary>
+/// Writes the camera data specified to the seqlock protected part of the buffer for data from the camera tools, so the addon never reads a half written
+/// state. Wait-free, so it can be called from the camera tools' update loop, but it has to be called from a single thread.
+/// </summary>
+void writeCameraToolsData(const CameraToolsData* toWrite)
+{
+	if(nullptr == g_dataFromCameraToolsBuffer || nullptr == toWrite)
+	{
+		return;
+	}
+	((CameraToolsDataExchange*)(g_dataFromCameraToolsBuffer + CAMERA_TOOLS_DATA_EXCHANGE_OFFSET))->write(*toWrite);
+}
+
+
+/// <summary>
+/// Copies the data the camera tools wrote to the buffer into the snapshot specified. Camera tools which write the plain CameraToolsData at the start of the
+/// buffer instead of calling writeCameraToolsData aren't synchronized with, so their data is copied as-is. If the camera tools use the exchange but no
+/// consistent copy could be read, e.g. because they stopped halfway a write, the last consistent copy is used instead.
+/// </summary>
+/// <returns>the snapshot, or nullptr if the camera tools haven't connected yet</returns>
+static CameraToolsData* obtainCameraToolsData(CameraToolsData& snapshot)
+{
+	if(nullptr == g_dataFromCameraToolsBuffer)
+	{
+		return nullptr;
+	}
+	auto exchange = (CameraToolsDataExchange*)(g_dataFromCameraToolsBuffer + CAMERA_TOOLS_DATA_EXCHANGE_OFFSET);
+	if(exchange->read(snapshot))
+	{
+		g_lastCameraToolsDataRead = snapshot;
+	}
+	else if(exchange->isWrittenTo())
+	{
+		snapshot = g_lastCameraToolsDataRead;
+	}
+	else
+	{
+		memcpy(&snapshot, g_dataFromCameraToolsBuffer, sizeof(CameraToolsData));
+	}
+	return &snapshot;
+}
+
+
 /// <summary>
 /// Clears all contained camera paths
 /// </summary>
@@ -159,7 +256,8 @@ void appendStateSnapshotToPath(int pathIndex)
 	}
 
 	// done deferred.
-	g_presentWorkQueue.push({ [pathIndex](effect_runtime* lambdaRuntime) {g_reshadeStateController.appendStateSnapshotToPath(pathIndex, lambdaRuntime); } });
+	queuePresentWork({ WorkItemCost::Heavy, [pathIndex](effect_runtime* lambdaRuntime) {g_reshadeStateController.appendStateSnapshotToPath(pathIndex, lambdaRuntime); } }, 
+					 "append state to path");
 }
 
 
@@ -175,7 +273,8 @@ void insertStateSnapshotBeforeSnapshotOnPath(int pathIndex, int indexToInsertBef
 		return;
 	}
 	// done deferred
-	g_presentWorkQueue.push({ [pathIndex, indexToInsertBefore](effect_runtime* lambdaRuntime) {g_reshadeStateController.insertStateSnapshotBeforeSnapshotOnPath(pathIndex, indexToInsertBefore, lambdaRuntime); } });
+	queuePresentWork({ WorkItemCost::Heavy, [pathIndex, indexToInsertBefore](effect_runtime* lambdaRuntime) {g_reshadeStateController.insertStateSnapshotBeforeSnapshotOnPath(pathIndex, indexToInsertBefore, lambdaRuntime); } }, 
+					 "insert state on path");
 }
 
 
@@ -191,7 +290,8 @@ void appendStateSnapshotAfterSnapshotOnPath(int pathIndex, int indexToAppendAfte
 		return;
 	}
 	// done deferred
-	g_presentWorkQueue.push({ [pathIndex, indexToAppendAfter](effect_runtime* lambdaRuntime) {g_reshadeStateController.appendStateSnapshotAfterSnapshotOnPath(pathIndex, indexToAppendAfter, lambdaRuntime); } });
+	queuePresentWork({ WorkItemCost::Heavy, [pathIndex, indexToAppendAfter](effect_runtime* lambdaRuntime) {g_reshadeStateController.appendStateSnapshotAfterSnapshotOnPath(pathIndex, indexToAppendAfter, lambdaRuntime); } }, 
+					 "append state on path");
 }
 
 /// <summary>
@@ -206,7 +306,8 @@ void updateStateSnapshotOnPath(int pathIndex, int stateIndex)
 		return;
 	}
 	// done deferred.
-	g_presentWorkQueue.push({ [pathIndex, stateIndex](effect_runtime* lambdaRuntime) {g_reshadeStateController.updateStateSnapshotOnPath(pathIndex, stateIndex, lambdaRuntime); } });
+	queuePresentWork({ WorkItemCost::Heavy, [pathIndex, stateIndex](effect_runtime* lambdaRuntime) {g_reshadeStateController.updateStateSnapshotOnPath(pathIndex, stateIndex, lambdaRuntime); } }, 
+					 "update state on path");
 }
 
 
@@ -235,11 +336,12 @@ void setReshadeStateInterpolated(int pathIndex, int fromStateIndex, int toStateI
 		return;
 	}
 
-	// done deferred
-	g_presentWorkQueue.push({ [pathIndex, fromStateIndex, toStateIndex, interpolationFactor](effect_runtime* lambdaRuntime)
+	// done deferred. If the tools call this more than once before the next present, only the last call is performed, see handleWorkQueue. The tools call
+	// this every frame, so a call dropped because the queue is full is made up for by the next one.
+	queuePresentWork({ stateWorkCoalescingKey(INTERPOLATED_STATE_WORK, pathIndex), [pathIndex, fromStateIndex, toStateIndex, interpolationFactor](effect_runtime* lambdaRuntime)
 	{
 		g_reshadeStateController.setReshadeState(pathIndex, fromStateIndex, toStateIndex, interpolationFactor, lambdaRuntime);
-	} });
+	} }, "set interpolated state");
 }
 
 
@@ -255,23 +357,46 @@ void setReshadeState(int pathIndex, int stateIndex)
 		return;
 	}
 
-	// done deferred
-	g_presentWorkQueue.push({ [pathIndex, stateIndex](effect_runtime* lambdaRuntime) {g_reshadeStateController.setReshadeState(pathIndex, stateIndex, lambdaRuntime); } });
+	// done deferred. If the tools call this more than once before the next present, only the last call is performed, see handleWorkQueue.
+	queuePresentWork({ stateWorkCoalescingKey(SINGLE_STATE_WORK, pathIndex), [pathIndex, stateIndex](effect_runtime* lambdaRuntime) 
+	{
+		g_reshadeStateController.setReshadeState(pathIndex, stateIndex, lambdaRuntime);
+	} }, "set state");
 }
 
 
 
 void handleWorkQueue(effect_runtime* runtime)
 {
-	for(;;)
+	// Grab the work queued since the last present, behind the work deferred in earlier frames. Only as much is taken from the queue as fits next to the
+	// deferred work, the rest stays queued till there's room. That way the pending work is bounded by the capacity of the queue: when heavy work keeps
+	// coming in faster than the budget allows, the queue fills up and new work is dropped, see queuePresentWork. The buffers are allocated once at that size.
+	static std::vector<WorkItem> workItemsToPerform;
+	static std::vector<uint64_t> supersedingKeys;
+	static std::vector<bool> isSuperseded;
+	if(workItemsToPerform.capacity() < PRESENT_WORK_QUEUE_CAPACITY)
 	{
-		auto topElement = g_presentWorkQueue.pop();
-		if(!topElement.has_value())
-		{
-			break;
-		}
-		auto workItem = topElement.value();
-		workItem.perform(runtime);
+		workItemsToPerform.reserve(PRESENT_WORK_QUEUE_CAPACITY);
+		supersedingKeys.reserve(PRESENT_WORK_QUEUE_CAPACITY);
+		isSuperseded.reserve(PRESENT_WORK_QUEUE_CAPACITY);
+	}
+	const size_t roomForWorkItems = PRESENT_WORK_QUEUE_CAPACITY - workItemsToPerform.size();
+	if(g_presentWorkQueue.drain([](WorkItem&& workItem) { workItemsToPerform.push_back(std::move(workItem)); }, roomForWorkItems) < roomForWorkItems)
+	{
+		// the queue has been emptied, so the next dropped work is worth a notification.
+		g_workDroppedNotified = false;
+	}
+
+	// state setting work which is overwritten before the frame is rendered is skipped.
+	g_numberOfSupersededWorkItemsLastPresent = (int)markSupersededWorkItems(workItemsToPerform, isSuperseded, supersedingKeys);
+
+	// perform what fits in the budget, the rest is left in workItemsToPerform for the next frame.
+	const auto frameWorkStart = std::chrono::steady_clock::now();
+	g_workBudget.budgetPerFrame = std::chrono::microseconds(g_workBudgetPerFrameInMicroseconds);
+	g_numberOfWorkItemsDeferred += (int)performWorkItems(workItemsToPerform, isSuperseded, runtime, g_workBudget);
+	if(std::chrono::steady_clock::now() - frameWorkStart > g_workBudget.budgetPerFrame)
+	{
+		g_numberOfFramesOverWorkBudget++;
 	}
 }
 
@@ -312,8 +437,10 @@ static void showHelpMarker(const char* desc)
 
 static void startScreenshotSession(bool isTestRun)
 {
-	g_screenshotController.configure(g_screenshotSettings.screenshotFolder, g_screenshotSettings.numberOfFramesToWaitBetweenSteps, (ScreenshotFiletype)g_screenshotSettings.screenshotFileType);
-	const auto cameraData = (CameraToolsData*)g_dataFromCameraToolsBuffer;
+	g_screenshotController.configure(g_screenshotSettings.screenshotFolder, g_screenshotSettings.numberOfFramesToWaitBetweenSteps, (ScreenshotFiletype)g_screenshotSettings.screenshotFileType, 
+									g_screenshotSettings.useFastJpegEncoder, g_screenshotSettings.shotMemoryBudgetInMB, g_screenshotSettings.spillShotsToDisk);
+	CameraToolsData cameraDataSnapshot;
+	const auto cameraData = obtainCameraToolsData(cameraDataSnapshot);
 	switch(g_screenshotSettings.typeOfScreenshot)
 	{
 	case (int)ScreenshotType::HorizontalPanorama:
@@ -341,6 +468,11 @@ void loadIniFile()
 	}
 
 	g_depthOfFieldController.loadIniFileData(iniFile);
+	const int workBudgetPerFrameInMicroseconds = iniFile.GetInt("WorkBudgetPerFrameInMicroseconds", "StatePaths");
+	if(workBudgetPerFrameInMicroseconds != INT_MIN)
+	{
+		g_workBudgetPerFrameInMicroseconds = std::clamp(workBudgetPerFrameInMicroseconds, MIN_WORK_BUDGET_PER_FRAME_IN_MICROSECONDS, MAX_WORK_BUDGET_PER_FRAME_IN_MICROSECONDS);
+	}
 }
 
 
@@ -348,6 +480,7 @@ void saveIniFile()
 {
 	CDataFile iniFile;
 	g_depthOfFieldController.saveIniFileData(iniFile);
+	iniFile.SetInt("WorkBudgetPerFrameInMicroseconds", g_workBudgetPerFrameInMicroseconds, "", "StatePaths");
 
 	iniFile.SetFileName(SETTINGS_FILE_NAME);
 	iniFile.Save();
@@ -369,7 +502,8 @@ bool requiredTechniqueEnabled(const std::string& effectName, const std::string&
 static void displaySettings(reshade::api::effect_runtime* runtime)
 {
 	ImGui::AlignTextToFramePadding();
-	const auto cameraData = (CameraToolsData*)g_dataFromCameraToolsBuffer;
+	CameraToolsData cameraDataSnapshot;
+	const auto cameraData = obtainCameraToolsData(cameraDataSnapshot);
 	if(ImGui::CollapsingHeader("Screenshot features"))
 	{
 		if(g_cameraToolsConnector.cameraToolsConnected() && nullptr != cameraData)
@@ -382,12 +516,34 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 						ImGui::AlignTextToFramePadding();
 						ImGui::InputText("Screenshot output directory", g_screenshotSettings.screenshotFolder, 256);
 						ImGui::SliderInt("Number of frames to wait between steps", &g_screenshotSettings.numberOfFramesToWaitBetweenSteps, 1, 100);
+						ImGui::SliderInt("Memory budget for shots (MB)", &g_screenshotSettings.shotMemoryBudgetInMB, 128, 16384);
+						if(ImGui::IsItemHovered(ImGuiHoveredFlags_DelayShort))
+						{
+							ImGui::SetTooltip("The maximum amount of memory used by grabbed shots which are waiting to be written to disk.\nIf this budget is reached, the next shot is taken after a shot has been written,\nunless shots are stored in a scratch file.");
+						}
+						ImGui::Checkbox("Store shots in a scratch file when the memory budget is reached", &g_screenshotSettings.spillShotsToDisk);
+						if(ImGui::IsItemHovered(ImGuiHoveredFlags_DelayShort))
+						{
+							ImGui::SetTooltip("If checked, shots which don't fit in the memory budget are stored uncompressed in a temporary file\nin the screenshot folder, so the session doesn't have to wait for the shots to be written.");
+						}
 #ifdef _DEBUG
 						ImGui::Combo("Multi-screenshot type", &g_screenshotSettings.typeOfScreenshot, "Horizontal panorama\0Lightfield\0DEBUG: Grid\0");
 #else
 						ImGui::Combo("Multi-screenshot type", &g_screenshotSettings.typeOfScreenshot, "Horizontal panorama\0Lightfield\0\0");
 #endif
 						ImGui::Combo("File type", &g_screenshotSettings.screenshotFileType, "Bmp\0Jpeg\0Png\0\0");
+						if(g_screenshotSettings.screenshotFileType == (int)ScreenshotFiletype::Jpeg)
+						{
+							ImGui::Checkbox("Use fast jpeg encoder", &g_screenshotSettings.useFastJpegEncoder);
+							if(ImGui::IsItemHovered(ImGuiHoveredFlags_DelayShort))
+							{
+								ImGui::SetTooltip("If checked, jpg files are written with a vectorized encoder which is several times faster.\nIf unchecked, or if your cpu doesn't support SSSE3, the reference encoder is used.");
+							}
+						}
+						if(g_screenshotSettings.screenshotFileType == (int)ScreenshotFiletype::Png)
+						{
+							ImGui::TextDisabled(fpng::fpng_cpu_supports_sse41() ? "Png encoder uses the SSE4.1/PCLMUL fast path" : "Png encoder uses the scalar path");
+						}
 						switch(g_screenshotSettings.typeOfScreenshot)
 						{
 							case (int)ScreenshotType::HorizontalPanorama:
@@ -425,13 +581,19 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 						{
 							g_screenshotController.cancelSession();
 						}
+						const int numberOfShotsToWrite = g_screenshotController.numberOfShotsToWrite();
+						if(numberOfShotsToWrite > 0)
+						{
+							ImGui::SameLine();
+							ImGui::Text("Shots waiting to be written: %d", numberOfShotsToWrite);
+						}
 					}
 					break;
 				case ScreenshotControllerState::Canceling:
 					ImGui::Text("Cancelling session...");
 					break;
 				case ScreenshotControllerState::SavingShots:
-					ImGui::Text("Saving shots...");
+					ImGui::Text("Saving shots... %d left", g_screenshotController.numberOfShotsToWrite());
 					break;
 			}
 		}
@@ -786,6 +948,28 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 		else
 		{
 			ImGui::Checkbox("Record ReShade state with camera nodes", &g_recordReshadeState);
+			int interpolationMode = (int)g_reshadeStateController.getInterpolationMode();
+			if(ImGui::Combo("Interpolation between states", &interpolationMode, "Linear\0Smooth (Catmull-Rom spline)\0\0"))
+			{
+				g_reshadeStateController.setInterpolationMode((StateInterpolationMode)interpolationMode);
+			}
+			float uniformWriteEpsilon = g_reshadeStateController.getUniformWriteEpsilon();
+			if(ImGui::DragFloat("Minimum change to set a value", &uniformWriteEpsilon, 0.0001f, 0.0f, 1.0f, "%.4f"))
+			{
+				g_reshadeStateController.setUniformWriteEpsilon(uniformWriteEpsilon);
+			}
+			ImGui::Text("Runtime calls last interpolated frame: %d made, %d saved.", g_reshadeStateController.numberOfRuntimeCallsMadeLastInterpolation(), 
+						g_reshadeStateController.numberOfRuntimeCallsSkippedLastInterpolation());
+			ImGui::Text("Superseded state changes skipped last frame: %d.", g_numberOfSupersededWorkItemsLastPresent);
+			ImGui::DragInt("Time budget per frame for path work (us)", &g_workBudgetPerFrameInMicroseconds, 100, MIN_WORK_BUDGET_PER_FRAME_IN_MICROSECONDS, MAX_WORK_BUDGET_PER_FRAME_IN_MICROSECONDS);
+			if(ImGui::IsItemDeactivatedAfterEdit())
+			{
+				saveIniFile();
+			}
+			ImGui::SameLine();
+			showHelpMarker("State captures which don't fit in the remaining budget of a frame are postponed to the next frame, so capturing many states doesn't stall the game. Work queued after a postponed capture, like setting a state for playback, is postponed with it, so it doesn't end up in the capture.");
+			ImGui::Text("Work items postponed: %d. Frames over budget: %d. Dropped as the queue was full: %d.", g_numberOfWorkItemsDeferred, g_numberOfFramesOverWorkBudget, 
+						g_numberOfWorkItemsDropped.load());
 			ImGui::Text("Number of saved ReShade states per path:");
 
 			const auto numberOfPaths = g_reshadeStateController.numberOfPaths();
@@ -798,9 +982,27 @@ static void displaySettings(reshade::api::effect_runtime* runtime)
 				for(int i = 0; i < numberOfPaths; i++)
 				{
 					// path no's are starting at 0 but for display purposes we start at 1.
-					ImGui::Text("Path: %d. # of saved Reshade states: %d.", (i + 1), g_reshadeStateController.numberOfSnapshotsOnPath(i));
+					ImGui::Text("Path: %d. # of saved Reshade states: %d. Memory used: %.1f KB.", (i + 1), g_reshadeStateController.numberOfSnapshotsOnPath(i), 
+								(float)g_reshadeStateController.memoryUsageOfPathInBytes(i) / 1024.0f);
 				}
 			}
+			if(ImGui::Button("Save path states"))
+			{
+				queuePresentWork({ WorkItemCost::Heavy, [](effect_runtime* lambdaRuntime)
+				{
+					const bool saved = g_reshadeStateController.savePaths(IGCS::Utils::pathInReshadeBaseFolder(PATH_STATES_FILE_NAME));
+					OverlayControl::addNotification(saved ? "Path states saved" : "Saving path states failed");
+				} }, "save path states");
+			}
+			ImGui::SameLine();
+			if(ImGui::Button("Load path states"))
+			{
+				queuePresentWork({ WorkItemCost::Heavy, [](effect_runtime* lambdaRuntime)
+				{
+					const bool loaded = g_reshadeStateController.loadPaths(IGCS::Utils::pathInReshadeBaseFolder(PATH_STATES_FILE_NAME), lambdaRuntime);
+					OverlayControl::addNotification(loaded ? "Path states loaded" : "Loading path states failed");
+				} }, "load path states");
+			}
 		}
 	}
 }
@@ -843,6 +1045,9 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)
 		reshade::register_event<reshade::addon_event::reshade_begin_effects>(onReshadeFinishEffects);
 		reshade::register_event<reshade::addon_event::reshade_reloaded_effects>(onReshadeReloadEffects);
 		reshade::register_overlay(nullptr, &displaySettings);
+		// fpng has to detect the cpu features once, otherwise it'll always use its scalar crc/adler code.
+		fpng::fpng_init();
+		IGCS::Utils::logLineToReshade(reshade::log_level::info, "Png encoder uses the %s path.", fpng::fpng_cpu_supports_sse41() ? "SSE4.1/PCLMUL" : "scalar");
 		loadIniFile();
 		break;
 	case DLL_PROCESS_DETACH:
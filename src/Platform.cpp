@@ -0,0 +1,391 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "Platform.h"
+#include <errno.h>
+#ifdef _WIN32
+#include <direct.h>
+#include "ShlObj_core.h"
+
+#pragma comment(lib, "shell32.lib")
+#else
+#include <cstdlib>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace IGCS::Platform
+{
+#ifdef _WIN32
+	struct ScratchFile
+	{
+		HANDLE fileHandle = INVALID_HANDLE_VALUE;
+		HANDLE mappingHandle = nullptr;
+	};
+
+
+	bool createDirectory(const std::string& path)
+	{
+		return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+	}
+
+
+	bool removeEmptyDirectory(const std::string& path)
+	{
+		// fails if the directory isn't empty.
+		return _rmdir(path.c_str()) == 0;
+	}
+
+
+	tm currentLocalTime()
+	{
+		const time_t now = time(nullptr);
+		tm toReturn;
+		localtime_s(&toReturn, &now);
+		return toReturn;
+	}
+
+
+	std::string picturesFolder()
+	{
+		char folder[_MAX_PATH + 1] = { 0 };
+		if(FAILED(SHGetFolderPathA(nullptr, CSIDL_MYPICTURES, nullptr, SHGFP_TYPE_CURRENT, folder)))
+		{
+			return "";
+		}
+		return folder;
+	}
+
+
+	void* findModuleExportingFunction(const char* functionName)
+	{
+		const HANDLE processHandle = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, GetCurrentProcessId());
+		if(nullptr == processHandle)
+		{
+			return nullptr;
+		}
+		HMODULE modules[512];
+		DWORD cbNeeded;
+		HMODULE moduleFound = nullptr;
+		if(EnumProcessModules(processHandle, modules, sizeof(modules), &cbNeeded))
+		{
+			// cbNeeded can be larger than the array if there are more modules than fit in it.
+			const DWORD numberOfModules = (cbNeeded < sizeof(modules) ? cbNeeded : sizeof(modules)) / sizeof(HMODULE);
+			for(DWORD i = 0; i < numberOfModules; i++)
+			{
+				if(nullptr != GetProcAddress(modules[i], functionName))
+				{
+					moduleFound = modules[i];
+					break;
+				}
+			}
+		}
+		CloseHandle(processHandle);
+		return moduleFound;
+	}
+
+
+	void* getExportedFunction(void* moduleHandle, const char* functionName)
+	{
+		if(nullptr == moduleHandle)
+		{
+			return nullptr;
+		}
+		return (void*)GetProcAddress((HMODULE)moduleHandle, functionName);
+	}
+
+
+	const uint8_t* mapFileForReading(const std::string& filename, size_t& fileSize)
+	{
+		fileSize = 0;
+		const HANDLE fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if(INVALID_HANDLE_VALUE == fileHandle)
+		{
+			return nullptr;
+		}
+		LARGE_INTEGER size;
+		// an empty file can't be mapped.
+		if(!GetFileSizeEx(fileHandle, &size) || size.QuadPart <= 0)
+		{
+			CloseHandle(fileHandle);
+			return nullptr;
+		}
+		const HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const uint8_t* view = nullptr == mappingHandle ? nullptr : (const uint8_t*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		// the view keeps the file and the mapping alive, so the handles can be closed right away.
+		if(nullptr != mappingHandle)
+		{
+			CloseHandle(mappingHandle);
+		}
+		CloseHandle(fileHandle);
+		if(nullptr != view)
+		{
+			fileSize = (size_t)size.QuadPart;
+		}
+		return view;
+	}
+
+
+	void unmapFile(const uint8_t* view, size_t fileSize)
+	{
+		UNREFERENCED_PARAMETER(fileSize);
+		if(nullptr != view)
+		{
+			UnmapViewOfFile(view);
+		}
+	}
+
+
+	ScratchFile* createScratchFile(const std::string& filename)
+	{
+		// delete on close so we never leave the (large) file behind, also not when the game crashes.
+		const HANDLE fileHandle = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+		if(INVALID_HANDLE_VALUE == fileHandle)
+		{
+			return nullptr;
+		}
+		ScratchFile* toReturn = new ScratchFile();
+		toReturn->fileHandle = fileHandle;
+		return toReturn;
+	}
+
+
+	bool resizeScratchFile(ScratchFile* file, uint64_t newSize)
+	{
+		const HANDLE newMappingHandle = CreateFileMappingA(file->fileHandle, nullptr, PAGE_READWRITE, (DWORD)(newSize >> 32), (DWORD)(newSize & 0xFFFFFFFF), nullptr);
+		if(nullptr == newMappingHandle)
+		{
+			return false;
+		}
+		// views mapped through the old mapping object stay valid after the handle has been closed.
+		if(nullptr != file->mappingHandle)
+		{
+			CloseHandle(file->mappingHandle);
+		}
+		file->mappingHandle = newMappingHandle;
+		return true;
+	}
+
+
+	uint8_t* mapScratchFileView(ScratchFile* file, uint64_t offset, size_t sizeInBytes)
+	{
+		if(nullptr == file->mappingHandle)
+		{
+			return nullptr;
+		}
+		return (uint8_t*)MapViewOfFile(file->mappingHandle, FILE_MAP_ALL_ACCESS, (DWORD)(offset >> 32), (DWORD)(offset & 0xFFFFFFFF), sizeInBytes);
+	}
+
+
+	void unmapScratchFileView(uint8_t* view, size_t sizeInBytes)
+	{
+		UNREFERENCED_PARAMETER(sizeInBytes);
+		UnmapViewOfFile(view);
+	}
+
+
+	void closeScratchFile(ScratchFile* file)
+	{
+		if(nullptr == file)
+		{
+			return;
+		}
+		if(nullptr != file->mappingHandle)
+		{
+			CloseHandle(file->mappingHandle);
+		}
+		CloseHandle(file->fileHandle);
+		delete file;
+	}
+
+
+	size_t mappingGranularity()
+	{
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		return systemInfo.dwAllocationGranularity;
+	}
+#else
+	struct ScratchFile
+	{
+		int fileDescriptor = -1;
+	};
+
+
+	bool createDirectory(const std::string& path)
+	{
+		return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+	}
+
+
+	bool removeEmptyDirectory(const std::string& path)
+	{
+		// fails if the directory isn't empty.
+		return rmdir(path.c_str()) == 0;
+	}
+
+
+	tm currentLocalTime()
+	{
+		const time_t now = time(nullptr);
+		tm toReturn;
+		localtime_r(&now, &toReturn);
+		return toReturn;
+	}
+
+
+	std::string picturesFolder()
+	{
+		const char* homeFolder = getenv("HOME");
+		if(nullptr == homeFolder)
+		{
+			return "";
+		}
+		return std::string(homeFolder) + "/Pictures";
+	}
+
+
+	void* findModuleExportingFunction(const char* functionName)
+	{
+		void* function = dlsym(RTLD_DEFAULT, functionName);
+		Dl_info moduleInfo;
+		if(nullptr == function || 0 == dladdr(function, &moduleInfo))
+		{
+			return nullptr;
+		}
+		// the module is loaded already, so this only obtains its handle.
+		return dlopen(moduleInfo.dli_fname, RTLD_LAZY | RTLD_NOLOAD);
+	}
+
+
+	void* getExportedFunction(void* moduleHandle, const char* functionName)
+	{
+		if(nullptr == moduleHandle)
+		{
+			return nullptr;
+		}
+		return dlsym(moduleHandle, functionName);
+	}
+
+
+	const uint8_t* mapFileForReading(const std::string& filename, size_t& fileSize)
+	{
+		fileSize = 0;
+		const int fileDescriptor = open(filename.c_str(), O_RDONLY);
+		if(fileDescriptor < 0)
+		{
+			return nullptr;
+		}
+		struct stat fileStatus;
+		// an empty file can't be mapped.
+		if(fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size <= 0)
+		{
+			close(fileDescriptor);
+			return nullptr;
+		}
+		void* view = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		// the view keeps the file alive, so it can be closed right away.
+		close(fileDescriptor);
+		if(MAP_FAILED == view)
+		{
+			return nullptr;
+		}
+		fileSize = (size_t)fileStatus.st_size;
+		return (const uint8_t*)view;
+	}
+
+
+	void unmapFile(const uint8_t* view, size_t fileSize)
+	{
+		if(nullptr != view)
+		{
+			munmap((void*)view, fileSize);
+		}
+	}
+
+
+	ScratchFile* createScratchFile(const std::string& filename)
+	{
+		const int fileDescriptor = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+		if(fileDescriptor < 0)
+		{
+			return nullptr;
+		}
+		// without a name the file is removed when it's closed, also when the process ends without closing it.
+		unlink(filename.c_str());
+		ScratchFile* toReturn = new ScratchFile();
+		toReturn->fileDescriptor = fileDescriptor;
+		return toReturn;
+	}
+
+
+	bool resizeScratchFile(ScratchFile* file, uint64_t newSize)
+	{
+		// allocate the blocks right away, so a full disk is reported here and not as a crash when a view is written to.
+		return posix_fallocate(file->fileDescriptor, 0, (off_t)newSize) == 0;
+	}
+
+
+	uint8_t* mapScratchFileView(ScratchFile* file, uint64_t offset, size_t sizeInBytes)
+	{
+		void* view = mmap(nullptr, sizeInBytes, PROT_READ | PROT_WRITE, MAP_SHARED, file->fileDescriptor, (off_t)offset);
+		return MAP_FAILED == view ? nullptr : (uint8_t*)view;
+	}
+
+
+	void unmapScratchFileView(uint8_t* view, size_t sizeInBytes)
+	{
+		munmap(view, sizeInBytes);
+	}
+
+
+	void closeScratchFile(ScratchFile* file)
+	{
+		if(nullptr == file)
+		{
+			return;
+		}
+		close(file->fileDescriptor);
+		delete file;
+	}
+
+
+	size_t mappingGranularity()
+	{
+		return (size_t)sysconf(_SC_PAGESIZE);
+	}
+#endif
+}
@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+/// <summary>
+/// The OS specific functionality the controllers use. Keep OS calls out of the controllers and add them here instead.
+/// </summary>
+namespace IGCS::Platform
+{
+#ifdef _WIN32
+	constexpr char PATH_SEPARATOR = '\\';
+#else
+	constexpr char PATH_SEPARATOR = '/';
+#endif
+
+	/// <summary>
+	/// File on disk which is removed when it's closed, also when the process ends without closing it. Views on it are mapped with mapScratchFileView.
+	/// </summary>
+	struct ScratchFile;
+
+	/// <summary>
+	/// Creates the directory specified. Returns true if the directory was created or already exists.
+	/// </summary>
+	bool createDirectory(const std::string& path);
+	/// <summary>
+	/// Removes the directory specified if it's empty. Returns true if the directory was removed.
+	/// </summary>
+	bool removeEmptyDirectory(const std::string& path);
+	/// <summary>
+	/// Returns the current local time.
+	/// </summary>
+	tm currentLocalTime();
+	/// <summary>
+	/// Returns the folder of the user's pictures, or an empty string if it can't be determined.
+	/// </summary>
+	std::string picturesFolder();
+	/// <summary>
+	/// Searches the modules loaded in the current process for a module which exports the function specified. Returns the handle of the first module
+	/// found, or nullptr if there's no such module.
+	/// </summary>
+	void* findModuleExportingFunction(const char* functionName);
+	/// <summary>
+	/// Returns the address of the function exported by the module specified, or nullptr if the module doesn't export the function.
+	/// </summary>
+	void* getExportedFunction(void* moduleHandle, const char* functionName);
+	/// <summary>
+	/// Maps the file specified into memory, read-only. Returns nullptr if the file doesn't exist, is empty or can't be mapped. Release the view with unmapFile.
+	/// </summary>
+	/// <param name="filename"></param>
+	/// <param name="fileSize">receives the size of the file in bytes</param>
+	const uint8_t* mapFileForReading(const std::string& filename, size_t& fileSize);
+	void unmapFile(const uint8_t* view, size_t fileSize);
+	/// <summary>
+	/// Creates the scratch file specified, overwriting an existing file. Returns nullptr if the file couldn't be created. Close it with closeScratchFile.
+	/// </summary>
+	ScratchFile* createScratchFile(const std::string& filename);
+	/// <summary>
+	/// Grows the scratch file to the size specified. Views mapped before stay valid. Returns false if the file couldn't grow, e.g. as the disk is full.
+	/// </summary>
+	bool resizeScratchFile(ScratchFile* file, uint64_t newSize);
+	/// <summary>
+	/// Maps sizeInBytes bytes of the scratch file, starting at offset, read/write into memory. The offset has to be a multiple of
+	/// mappingGranularity(). Returns nullptr if the view couldn't be mapped. Release the view with unmapScratchFileView.
+	/// </summary>
+	uint8_t* mapScratchFileView(ScratchFile* file, uint64_t offset, size_t sizeInBytes);
+	void unmapScratchFileView(uint8_t* view, size_t sizeInBytes);
+	/// <summary>
+	/// Closes and removes the scratch file. All views have to be unmapped before this call.
+	/// </summary>
+	void closeScratchFile(ScratchFile* file);
+	/// <summary>
+	/// Returns the granularity of the offsets of mapped views.
+	/// </summary>
+	size_t mappingGranularity();
+}
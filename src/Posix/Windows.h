@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+// Stand-in for the parts of the Windows headers the core and the ReShade SDK headers use, so the core builds on other platforms for the tests and
+// benchmarks. Only on the include path of the non-Windows CMake build. The ReShade SDK is used in RESHADE_API_LIBRARY mode there, with the ReShade
+// exports implemented by the fake runtime of the tests.
+#include <cerrno>
+#include <climits>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <strings.h>
+
+#define WINAPI
+#define __stdcall
+#define __uuidof(type) type::__uuid
+#define __declspec(attribute)
+#define UNREFERENCED_PARAMETER(parameter) (void)(parameter)
+#define MAX_PATH 260
+#define _MAX_PATH 260
+
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef BYTE* LPBYTE;
+typedef unsigned long DWORD;
+typedef DWORD* LPDWORD;
+typedef void* HANDLE;
+typedef void* HMODULE;
+
+// the secure CRT functions the core uses. The _snprintf_s and _vsnprintf_s variants used are the ones which take the buffer as an array.
+#define sscanf_s sscanf
+#define _snprintf_s(buffer, count, ...) snprintf(buffer, sizeof(buffer), __VA_ARGS__)
+#define _vsnprintf_s(buffer, count, format, arguments) vsnprintf(buffer, sizeof(buffer), format, arguments)
+
+inline int fopen_s(FILE** file, const char* filename, const char* mode)
+{
+	*file = fopen(filename, mode);
+	return nullptr == *file ? errno : 0;
+}
+
+inline int _stricmp(const char* string1, const char* string2)
+{
+	return strcasecmp(string1, string2);
+}
@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+// Stand-in for the MSVC cpuid intrinsics the core uses, see Windows.h in this folder.
+#include <cpuid.h>
+#include <cstdint>
+#include <immintrin.h>
+
+// cpuid.h defines a macro with the same name as MSVC's intrinsic. Its __cpuidex has the MSVC signature already.
+#undef __cpuid
+
+inline void __cpuid(int registers[4], int leaf)
+{
+	__cpuidex(registers, leaf, 0);
+}
+
+// GCC's _xgetbv is only available in functions compiled for XSAVE, which the cpu detection can't assume.
+inline uint64_t readExtendedControlRegister(uint32_t registerIndex)
+{
+	uint32_t low;
+	uint32_t high;
+	__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(registerIndex));
+	return ((uint64_t)high << 32) | low;
+}
+#define _xgetbv(registerIndex) readExtendedControlRegister(registerIndex)
@@ -32,149 +32,320 @@
 /////////////////////////////////////////////////////////////////////////
 
 #include "ReshadeStateController.h"
+#include "BinaryStream.h"
+#include "Platform.h"
 #include "CameraPathData.h"
 
 
 void ReshadeStateController::removeCameraPath(int pathIndex)
 {
-	std::scoped_lock lock(_apiMutex);
-	if(pathIndex<0 || pathIndex>=_cameraPathsData.size())
+	std::scoped_lock lock(_writerMutex);
+	const auto currentPaths = _cameraPaths.load();
+	if(pathIndex<0 || pathIndex>=currentPaths->size())
 	{
 		return;
 	}
-	_cameraPathsData.erase(_cameraPathsData.begin() + pathIndex);
+	auto newPaths = std::make_shared<CameraPathSet>(*currentPaths);
+	newPaths->erase(newPaths->begin() + pathIndex);
+	_cameraPaths = std::move(newPaths);
 }
 
 
 void ReshadeStateController::addCameraPath()
 {
-	std::scoped_lock lock(_apiMutex);
-	_cameraPathsData.push_back(CameraPathData());
+	std::scoped_lock lock(_writerMutex);
+	auto newPaths = std::make_shared<CameraPathSet>(*_cameraPaths.load());
+	newPaths->push_back(std::make_shared<const CameraPathData>());
+	_cameraPaths = std::move(newPaths);
 }
 
 
 void ReshadeStateController::appendStateSnapshotToPath(int pathIndex, reshade::api::effect_runtime* runtime)
 {
-	std::scoped_lock lock(_apiMutex);
-	CameraPathData& path = getCameraPath(pathIndex);
-	if(path.isNonExisting())
-	{
-		return;
-	}
-	path.appendStateSnapshot(getCurrentReshadeStateSnapshot(runtime));
+	std::scoped_lock lock(_writerMutex);
+	modifyCameraPath(pathIndex, [&](CameraPathData& path) { path.appendStateSnapshot(getCurrentReshadeStateSnapshot(runtime)); });
 }
 
 
 void ReshadeStateController::insertStateSnapshotBeforeSnapshotOnPath(int pathIndex, int indexToInsertBefore, reshade::api::effect_runtime* runtime)
 {
-	std::scoped_lock lock(_apiMutex);
-	CameraPathData& path = getCameraPath(pathIndex);
-	if(path.isNonExisting())
-	{
-		return;
-	}
-	path.insertStateSnapshotBeforeSnapshot(indexToInsertBefore, getCurrentReshadeStateSnapshot(runtime));
+	std::scoped_lock lock(_writerMutex);
+	modifyCameraPath(pathIndex, [&](CameraPathData& path) { path.insertStateSnapshotBeforeSnapshot(indexToInsertBefore, getCurrentReshadeStateSnapshot(runtime)); });
 }
 
 
 void ReshadeStateController::appendStateSnapshotAfterSnapshotOnPath(int pathIndex, int indexToAppendAfter, reshade::api::effect_runtime* runtime)
 {
-	std::scoped_lock lock(_apiMutex);
-	CameraPathData& path = getCameraPath(pathIndex);
-	if(path.isNonExisting())
-	{
-		return;
-	}
-	path.appendStateSnapshotAfterSnapshot(indexToAppendAfter, getCurrentReshadeStateSnapshot(runtime));
+	std::scoped_lock lock(_writerMutex);
+	modifyCameraPath(pathIndex, [&](CameraPathData& path) { path.appendStateSnapshotAfterSnapshot(indexToAppendAfter, getCurrentReshadeStateSnapshot(runtime)); });
 }
 
 
 void ReshadeStateController::removeStateSnapshotFromPath(int pathIndex, int stateIndex)
 {
-	std::scoped_lock lock(_apiMutex);
-	CameraPathData& path = getCameraPath(pathIndex);
-	if(path.isNonExisting())
-	{
-		return;
-	}
-	path.removeStateSnapshot(stateIndex);
+	std::scoped_lock lock(_writerMutex);
+	modifyCameraPath(pathIndex, [&](CameraPathData& path) { path.removeStateSnapshot(stateIndex); });
 }
 
 
 void ReshadeStateController::updateStateSnapshotOnPath(int pathIndex, int stateIndex, reshade::api::effect_runtime* runtime)
 {
-	std::scoped_lock lock(_apiMutex);
-	CameraPathData& path = getCameraPath(pathIndex);
-	if(path.isNonExisting())
-	{
-		return;
-	}
-	path.updateStateSnapshot(getCurrentReshadeStateSnapshot(runtime), stateIndex);
+	std::scoped_lock lock(_writerMutex);
+	modifyCameraPath(pathIndex, [&](CameraPathData& path) { path.updateStateSnapshot(getCurrentReshadeStateSnapshot(runtime), stateIndex); });
 }
 
 
 void ReshadeStateController::migrateContainedHandles(reshade::api::effect_runtime* runtime)
 {
-	std::scoped_lock lock(_apiMutex);
+	std::scoped_lock lock(_writerMutex);
+	// the new state shares the id blocks of the effects whose handles didn't change with the previous state, so only the effects which did change are migrated.
 	const ReshadeStateSnapshot currentState = getCurrentReshadeStateSnapshot(runtime);
-
-	for(auto& path : _cameraPathsData)
+	const auto currentPaths = _cameraPaths.load();
+	auto newPaths = std::make_shared<CameraPathSet>();
+	newPaths->reserve(currentPaths->size());
+	bool pathsChanged = false;
+	for(const auto& path : *currentPaths)
 	{
-		path.migratedContainedHandles(currentState);
+		if(path->isBoundTo(currentState))
+		{
+			// keep it, so the plans compiled for it stay valid too.
+			newPaths->push_back(path);
+			continue;
+		}
+		auto migratedPath = std::make_shared<CameraPathData>(*path);
+		migratedPath->migratedContainedHandles(currentState);
+		newPaths->push_back(std::move(migratedPath));
+		pathsChanged = true;
+	}
+	if(pathsChanged)
+	{
+		_cameraPaths = std::move(newPaths);
 	}
 }
 
 
 void ReshadeStateController::setReshadeState(int pathIndex, int fromStateIndex, int toStateIndex, float interpolationFactor, reshade::api::effect_runtime* runtime)
 {
-	std::scoped_lock lock(_apiMutex);
-	CameraPathData& path = getCameraPath(pathIndex);
-	if(path.isNonExisting())
+	const auto path = getCameraPath(*_cameraPaths.load(), pathIndex);
+	std::scoped_lock lock(_playbackMutex);
+	if(nullptr == path)
 	{
+		resetLastInterpolatedSegment();
 		return;
 	}
-	path.setReshadeState(fromStateIndex, toStateIndex, interpolationFactor, runtime);
+	const StateInterpolationMode interpolationMode = _interpolationMode;
+	if(path != _pathOfInterpolationPlans || interpolationMode != _interpolationModeOfPlans)
+	{
+		// another path is played, the path was changed or the mode was changed: the plans we have are of no use anymore. Their memory is reused.
+		_currentSegmentPlan.invalidate();
+		_nextSegmentPlan.invalidate();
+		_pathOfInterpolationPlans = path;
+		_interpolationModeOfPlans = interpolationMode;
+		resetLastInterpolatedSegment();
+	}
+	if(!_currentSegmentPlan.isFor(fromStateIndex, toStateIndex))
+	{
+		if(_nextSegmentPlan.isFor(fromStateIndex, toStateIndex))
+		{
+			// the playback moved on to the segment compiled ahead.
+			std::swap(_currentSegmentPlan, _nextSegmentPlan);
+		}
+		else if(!compileSegmentPlan(*path, fromStateIndex, toStateIndex, interpolationMode, _currentSegmentPlan))
+		{
+			resetLastInterpolatedSegment();
+			return;
+		}
+	}
+	// a plan of another segment than the one set last hasn't set its constant state yet.
+	const bool applyConstantState = _lastInterpolatedFromStateIndex != fromStateIndex || _lastInterpolatedToStateIndex != toStateIndex;
+	StateInterpolationPlan& plan = _currentSegmentPlan.plan;
+	plan.apply(runtime, interpolationFactor, applyConstantState, _uniformWriteEpsilon);
+	_numberOfRuntimeCallsMadeLastInterpolation = plan.numberOfRuntimeCallsMade();
+	_numberOfRuntimeCallsSkippedLastInterpolation = plan.numberOfRuntimeCallsSkipped();
+	_lastInterpolatedFromStateIndex = fromStateIndex;
+	_lastInterpolatedToStateIndex = toStateIndex;
+
+	// compile the plan of the segment after this one ahead, so the frame the playback moves on to it only has to apply it.
+	const int direction = toStateIndex >= fromStateIndex ? 1 : -1;
+	const int nextToStateIndex = toStateIndex + direction;
+	if(nextToStateIndex >= 0 && nextToStateIndex < path->numberOfSnapshots() && !_nextSegmentPlan.isFor(toStateIndex, nextToStateIndex))
+	{
+		compileSegmentPlan(*path, toStateIndex, nextToStateIndex, interpolationMode, _nextSegmentPlan);
+	}
 }
 
 
 void ReshadeStateController::setReshadeState(int pathIndex, int stateIndex, reshade::api::effect_runtime* runtime)
 {
-	std::scoped_lock lock(_apiMutex);
-	CameraPathData& path = getCameraPath(pathIndex);
-
-	if(path.isNonExisting())
+	const auto path = getCameraPath(*_cameraPaths.load(), pathIndex);
+	std::scoped_lock lock(_playbackMutex);
+	resetLastInterpolatedSegment();
+	if(nullptr == path)
 	{
 		return;
 	}
-	path.setReshadeState(stateIndex, runtime);
+	path->setReshadeState(stateIndex, runtime);
 }
 
 
 void ReshadeStateController::clearPaths()
 {
-	_cameraPathsData.clear(); 
+	std::scoped_lock lock(_writerMutex);
+	_cameraPaths = std::make_shared<const CameraPathSet>();
+}
+
+
+// The file starts with a header: the magic, the format version, the number of names followed by the names and the number of paths. Then per path its snapshots follow,
+// see CameraPathData::writeTo. Names are stored once and referred to by index. All values are 4 byte aligned little endian, so the file can be read straight from a mapped view.
+static const uint32_t PATHS_FILE_MAGIC = 0x50534749;		// 'IGSP'
+static const uint32_t PATHS_FILE_VERSION = 1;
+
+
+bool ReshadeStateController::savePaths(const std::string& filename)
+{
+	const auto paths = _cameraPaths.load();
+	IGCS::BinaryWriter pathsWriter;
+	for(const auto& path : *paths)
+	{
+		path->writeTo(pathsWriter);
+	}
+
+	IGCS::BinaryWriter fileWriter;
+	fileWriter.write(PATHS_FILE_MAGIC);
+	fileWriter.write(PATHS_FILE_VERSION);
+	fileWriter.write((uint32_t)pathsWriter.namesWritten().size());
+	for(const auto symbol : pathsWriter.namesWritten())
+	{
+		fileWriter.writeString(IGCS::SymbolTable::nameOf(symbol));
+	}
+	fileWriter.write((uint32_t)paths->size());
+	fileWriter.append(pathsWriter);
+
+	FILE* file = nullptr;
+	if(fopen_s(&file, filename.c_str(), "wb") != 0 || nullptr == file)
+	{
+		return false;
+	}
+	const auto& data = fileWriter.data();
+	const bool allWritten = fwrite(data.data(), 1, data.size(), file) == data.size();
+	fclose(file);
+	return allWritten;
+}
+
+
+bool ReshadeStateController::loadPaths(const std::string& filename, reshade::api::effect_runtime* runtime)
+{
+	size_t fileSize = 0;
+	const uint8_t* fileView = IGCS::Platform::mapFileForReading(filename, fileSize);
+	if(nullptr == fileView)
+	{
+		return false;
+	}
+	IGCS::BinaryReader reader(fileView, fileSize);
+	std::vector<CameraPathData> pathsRead;
+	bool succeeded = false;
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t numberOfNames = 0;
+	if(reader.read(magic) && magic == PATHS_FILE_MAGIC && reader.read(version) && version == PATHS_FILE_VERSION && reader.read(numberOfNames) && 
+	   reader.hasBytesLeft((size_t)numberOfNames * sizeof(uint32_t)))
+	{
+		std::vector<IGCS::SymbolTable::Symbol> symbolPerNameIndex;
+		symbolPerNameIndex.reserve(numberOfNames);
+		std::string name;
+		for(uint32_t i = 0; i < numberOfNames && reader.readString(name); i++)
+		{
+			symbolPerNameIndex.push_back(IGCS::SymbolTable::intern(name));
+		}
+		reader.setNames(std::move(symbolPerNameIndex));
+		uint32_t numberOfPaths = 0;
+		if(!reader.hasFailed() && reader.read(numberOfPaths) && reader.hasBytesLeft((size_t)numberOfPaths * sizeof(uint32_t)))
+		{
+			pathsRead.resize(numberOfPaths);
+			succeeded = true;
+			for(auto& path : pathsRead)
+			{
+				if(!path.readFrom(reader))
+				{
+					succeeded = false;
+					break;
+				}
+			}
+		}
+	}
+	IGCS::Platform::unmapFile(fileView, fileSize);
+	if(!succeeded)
+	{
+		return false;
+	}
+
+	// bind the names read to the ids of the current session.
+	std::scoped_lock lock(_writerMutex);
+	const ReshadeStateSnapshot currentState = getCurrentReshadeStateSnapshot(runtime);
+	auto newPaths = std::make_shared<CameraPathSet>();
+	newPaths->reserve(pathsRead.size());
+	for(auto& path : pathsRead)
+	{
+		path.migratedContainedHandles(currentState);
+		newPaths->push_back(std::make_shared<const CameraPathData>(std::move(path)));
+	}
+	_cameraPaths = std::move(newPaths);
+	return true;
 }
 
 
 int ReshadeStateController::numberOfSnapshotsOnPath(int pathIndex)
 {
-	auto& path = getCameraPath(pathIndex);
-	if(path.isNonExisting())
+	const auto path = getCameraPath(*_cameraPaths.load(), pathIndex);
+	return nullptr == path ? 0 : path->numberOfSnapshots();
+}
+
+
+size_t ReshadeStateController::memoryUsageOfPathInBytes(int pathIndex)
+{
+	const auto path = getCameraPath(*_cameraPaths.load(), pathIndex);
+	return nullptr == path ? 0 : path->memoryUsageInBytes();
+}
+
+
+void ReshadeStateController::modifyCameraPath(int pathIndex, const std::function<void(CameraPathData&)>& modifyFunc)
+{
+	const auto currentPaths = _cameraPaths.load();
+	const auto currentPath = getCameraPath(*currentPaths, pathIndex);
+	if(nullptr == currentPath)
 	{
-		return 0;
+		return;
 	}
-	return path.numberOfSnapshots();
+	// readers might still use the current set and path, so the change is made to copies. Copying the path is cheap as its snapshots share their data.
+	auto newPath = std::make_shared<CameraPathData>(*currentPath);
+	modifyFunc(*newPath);
+	auto newPaths = std::make_shared<CameraPathSet>(*currentPaths);
+	(*newPaths)[pathIndex] = std::move(newPath);
+	_cameraPaths = std::move(newPaths);
 }
 
 
-CameraPathData& ReshadeStateController::getCameraPath(int index)
+std::shared_ptr<const CameraPathData> ReshadeStateController::getCameraPath(const CameraPathSet& paths, int pathIndex)
 {
-	if(index<0 || index >= _cameraPathsData.size())
+	if(pathIndex<0 || pathIndex >= paths.size())
 	{
-		return CameraPathData::getNonExisting();
+		return nullptr;
 	}
+	return paths[pathIndex];
+}
 
-	return _cameraPathsData[index];
+
+bool ReshadeStateController::compileSegmentPlan(const CameraPathData& path, int fromStateIndex, int toStateIndex, StateInterpolationMode interpolationMode, 
+												SegmentInterpolationPlan& toCompile)
+{
+	if(!path.compileInterpolationPlan(fromStateIndex, toStateIndex, interpolationMode, toCompile.plan))
+	{
+		toCompile.invalidate();
+		return false;
+	}
+	toCompile.fromStateIndex = fromStateIndex;
+	toCompile.toStateIndex = toStateIndex;
+	return true;
 }
 
 
@@ -183,5 +354,12 @@ ReshadeStateSnapshot ReshadeStateController::getCurrentReshadeStateSnapshot(resh
 	ReshadeStateSnapshot currentState;
 
 	currentState.obtainReshadeState(runtime);
+	// share the blocks which are the same as in the last known runtime state, so effects whose ids didn't change are recognized as bound to the same ids.
+	currentState.shareUnchangedStateWith(_currentRuntimeState);
+	if(!currentState.isEmpty())
+	{
+		// the snapshots captured from now on share their blocks with this one, so the next migration finds them bound if their ids didn't change.
+		_currentRuntimeState = currentState;
+	}
 	return currentState;
 }
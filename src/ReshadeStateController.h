@@ -32,15 +32,26 @@
 /////////////////////////////////////////////////////////////////////////
 
 #pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 #include <reshade.hpp>
 #include "CameraPathData.h"
+#include "ConstantsEnums.h"
 #include "ReshadeStateSnapshot.h"
 
 
 /// <summary>
 /// Class which maintains reshade state snapshots for various paths.
 /// </summary>
+/// <remarks>The paths are published as an immutable set in a std::atomic&lt;std::shared_ptr&gt;. Readers, like playback and the UI, don't take the lock writers 
+///	take. That atomic isn't lock-free with MSVC's or GCC's standard library: loading and storing it take a short internal spinlock, which is only held while 
+///	the pointer is copied. Writers are serialized, change a copy of the path they modify and publish a new set with it, so a reader always sees a complete 
+///	set and never waits while a writer changes a path.
+///	The plans used for playback are kept per published path and are recompiled when the path played is replaced.</remarks>
 class ReshadeStateController
 {
 public:
@@ -55,15 +66,93 @@ public:
 	void setReshadeState(int pathIndex, int fromStateIndex, int toStateIndex, float interpolationFactor, reshade::api::effect_runtime* runtime);
 	void setReshadeState(int pathIndex, int stateIndex, reshade::api::effect_runtime* runtime);
 	void clearPaths();
+	/// <summary>
+	/// Writes the states of all paths to the file specified. Returns false if the file couldn't be written.
+	/// </summary>
+	bool savePaths(const std::string& filename);
+	/// <summary>
+	/// Replaces the paths with the ones in the file specified, written by savePaths, and binds the states read to the effects currently loaded in the runtime.
+	/// Returns false if the file doesn't exist or isn't valid. The current paths are kept in that case.
+	/// </summary>
+	bool loadPaths(const std::string& filename, reshade::api::effect_runtime* runtime);
 	int numberOfSnapshotsOnPath(int pathIndex);
+	/// <summary>
+	/// Returns the number of bytes used by the states of the path specified. Data shared between states is counted once.
+	/// </summary>
+	size_t memoryUsageOfPathInBytes(int pathIndex);
 
-	int numberOfPaths() { return _cameraPathsData.size(); }
+	int numberOfPaths() { return _cameraPaths.load()->size(); }
+	/// <summary>
+	/// Sets the amount a uniform value has to change during path playback before it's set again. 0 means any change is set.
+	/// </summary>
+	void setUniformWriteEpsilon(float newValue) { _uniformWriteEpsilon = newValue < 0.0f ? 0.0f : newValue; }
+	float getUniformWriteEpsilon() { return _uniformWriteEpsilon; }
+	/// <summary>
+	/// Sets how values are interpolated between the states on a path during playback. The plans are recompiled with the new mode when they're used next.
+	/// </summary>
+	void setInterpolationMode(StateInterpolationMode newValue) { _interpolationMode = newValue; }
+	StateInterpolationMode getInterpolationMode() { return _interpolationMode; }
+	// statistics of the last interpolated setReshadeState call: the number of runtime calls made and the number of calls saved by only setting what changed.
+	int numberOfRuntimeCallsMadeLastInterpolation() { return _numberOfRuntimeCallsMadeLastInterpolation; }
+	int numberOfRuntimeCallsSkippedLastInterpolation() { return _numberOfRuntimeCallsSkippedLastInterpolation; }
 
 private:
-	std::vector<CameraPathData> _cameraPathsData;
-	std::mutex _apiMutex;
+	using CameraPathSet = std::vector<std::shared_ptr<const CameraPathData>>;
 
-	CameraPathData& getCameraPath(int pathIndex);
+	/// <summary>
+	/// The compiled plan of a single path segment.
+	/// </summary>
+	struct SegmentInterpolationPlan
+	{
+		int fromStateIndex = -1;
+		int toStateIndex = -1;		// -1 if no plan has been compiled
+		StateInterpolationPlan plan;
+
+		bool isFor(int from, int to) const { return toStateIndex >= 0 && fromStateIndex == from && toStateIndex == to; }
+		void invalidate() { fromStateIndex = -1; toStateIndex = -1; }
+	};
+
+	/// <summary>
+	/// Replaces the path at pathIndex with a copy which has been changed by modifyFunc and publishes the set with the new path. Does nothing if the path doesn't exist.
+	/// </summary>
+	void modifyCameraPath(int pathIndex, const std::function<void(CameraPathData&)>& modifyFunc);
+	/// <summary>
+	/// Resets the interpolated segment, so the next interpolation sets the complete state again. The caller has to own _playbackMutex.
+	/// </summary>
+	void resetLastInterpolatedSegment() { _lastInterpolatedFromStateIndex = -1; }
+	static std::shared_ptr<const CameraPathData> getCameraPath(const CameraPathSet& paths, int pathIndex);
+	/// <summary>
+	/// Compiles the plan of the segment specified of the path specified into toCompile, reusing its memory. Returns false if the segment doesn't exist, 
+	/// toCompile is invalidated in that case.
+	/// </summary>
+	static bool compileSegmentPlan(const CameraPathData& path, int fromStateIndex, int toStateIndex, StateInterpolationMode interpolationMode, 
+								   SegmentInterpolationPlan& toCompile);
+	/// <summary>
+	/// Obtains the current state from the runtime and makes it the last known runtime state. The caller has to own _writerMutex.
+	/// </summary>
 	ReshadeStateSnapshot getCurrentReshadeStateSnapshot(reshade::api::effect_runtime* runtime);
+
+	std::atomic<std::shared_ptr<const CameraPathSet>> _cameraPaths = std::make_shared<const CameraPathSet>();
+	std::mutex _writerMutex;		// serializes writers of _cameraPaths, readers don't take it.
+	// the state of the runtime at the last capture or migration: the index of the current ids per name. Captured states share its blocks where their ids are the same, so
+	// on a reload only the effects whose ids changed get new blocks, and only snapshots which aren't bound to the new blocks have to be migrated. Guarded by _writerMutex.
+	ReshadeStateSnapshot _currentRuntimeState;
+	std::mutex _playbackMutex;		// guards the playback state below. Only the setReshadeState calls take it.
+
+	// the plan of the segment of the path played last and the plan of the segment after it in the direction it's played, compiled ahead so moving on to
+	// the next segment doesn't have to compile it. Only these two are kept, as a long path with many effects would otherwise keep a plan per segment
+	// around. They're tied to the published path they were compiled for, so if that path is replaced by a writer, they're recompiled.
+	std::shared_ptr<const CameraPathData> _pathOfInterpolationPlans;
+	StateInterpolationMode _interpolationModeOfPlans = StateInterpolationMode::Linear;
+	SegmentInterpolationPlan _currentSegmentPlan;
+	SegmentInterpolationPlan _nextSegmentPlan;
+	// the path segment set by the last interpolated setReshadeState call. While the same segment is interpolated, only the uniforms which change have to be set.
+	int _lastInterpolatedFromStateIndex = -1;
+	int _lastInterpolatedToStateIndex = -1;
+
+	std::atomic<float> _uniformWriteEpsilon = 0.0f;
+	std::atomic<StateInterpolationMode> _interpolationMode = StateInterpolationMode::Linear;
+	std::atomic<int> _numberOfRuntimeCallsMadeLastInterpolation = 0;
+	std::atomic<int> _numberOfRuntimeCallsSkippedLastInterpolation = 0;
 };
 
@@ -33,9 +33,8 @@
 
 #include "ReshadeStateSnapshot.h"
 
-#include <ranges>
+#include <algorithm>
 #include <unordered_set>
-#include <unordered_map>
 
 #include "EffectState.h"
 #include "Utils.h"
@@ -44,81 +43,98 @@
 void ReshadeStateSnapshot::logContents()
 {
 	reshade::log_message(reshade::log_level::info, "\tTechniques: ");
-	for(auto& kvp : _techniqueEnabledPerName)
+	for(const auto& techniqueState : *_techniqueStates)
 	{
-		reshade::log_message(reshade::log_level::info, IGCS::Utils::formatString("\t\t%s. Enabled: %s", kvp.first.c_str(), kvp.second ? "true" : "false").c_str());
+		reshade::log_message(reshade::log_level::info, IGCS::Utils::formatString("\t\t%s. Enabled: %s", IGCS::SymbolTable::nameOf(techniqueState.name).c_str(), techniqueState.isEnabled ? "true" : "false").c_str());
 	}
 
 	reshade::log_message(reshade::log_level::info, "\tEffects: ");
-	for(const auto& effectName : _effectStatePerEffectName | std::views::keys)
+	for(const auto& effectState : _effectStates)
 	{
-		reshade::log_message(reshade::log_level::info, IGCS::Utils::formatString("\t\t%s", effectName.c_str()).c_str());
+		reshade::log_message(reshade::log_level::info, IGCS::Utils::formatString("\t\t%s", effectState.name().c_str()).c_str());
 	}
 }
 
 
+EffectState* ReshadeStateSnapshot::findEffectState(const std::string& effectName)
+{
+	const IGCS::SymbolTable::Symbol nameToFind = IGCS::SymbolTable::find(effectName);
+	const auto it = std::ranges::lower_bound(_effectStates, nameToFind, {}, &EffectState::nameSymbol);
+	if(it == _effectStates.end() || it->nameSymbol() != nameToFind)
+	{
+		return nullptr;
+	}
+	return &(*it);
+}
+
+
+const EffectState* ReshadeStateSnapshot::findEffectState(IGCS::SymbolTable::Symbol effectName) const
+{
+	const auto it = std::ranges::lower_bound(_effectStates, effectName, {}, &EffectState::nameSymbol);
+	if(it == _effectStates.end() || it->nameSymbol() != effectName)
+	{
+		return nullptr;
+	}
+	return &(*it);
+}
+
+
 void ReshadeStateSnapshot::setUniformIntVariable(reshade::api::effect_runtime* runtime, const std::string& effectName, const std::string& uniformName, int valueToWrite)
 {
-	if(isEmpty() || !_effectStatePerEffectName.contains(effectName))
+	EffectState* effectState = findEffectState(effectName);
+	if(nullptr == effectState)
 	{
 		return;
 	}
-	auto& effectState = _effectStatePerEffectName[effectName];
-	effectState.setUniformIntVariable(runtime, uniformName, valueToWrite);
+	effectState->setUniformIntVariable(runtime, uniformName, valueToWrite);
 }
 
 
 void ReshadeStateSnapshot::setUniformFloatVariable(reshade::api::effect_runtime* runtime, const std::string& effectName, const std::string& uniformName, float valueToWrite)
 {
-	if(isEmpty() || !_effectStatePerEffectName.contains(effectName))
+	EffectState* effectState = findEffectState(effectName);
+	if(nullptr == effectState)
 	{
 		return;
 	}
-	auto& effectState = _effectStatePerEffectName[effectName];
-	effectState.setUniformFloatVariable(runtime, uniformName, valueToWrite);
+	effectState->setUniformFloatVariable(runtime, uniformName, valueToWrite);
 }
 
 
 void ReshadeStateSnapshot::setUniformFloat2Variable(reshade::api::effect_runtime* runtime, const std::string& effectName, const std::string& uniformName, float value1ToWrite, float value2ToWrite)
 {
-	if(isEmpty() || !_effectStatePerEffectName.contains(effectName))
+	EffectState* effectState = findEffectState(effectName);
+	if(nullptr == effectState)
 	{
 		return;
 	}
-	auto& effectState = _effectStatePerEffectName[effectName];
-	effectState.setUniformFloat2Variable(runtime, uniformName, value1ToWrite, value2ToWrite);
+	effectState->setUniformFloat2Variable(runtime, uniformName, value1ToWrite, value2ToWrite);
 }
 
 
 void ReshadeStateSnapshot::setUniformBoolVariable(reshade::api::effect_runtime* runtime, const std::string& effectName, const std::string& uniformName, bool valueToWrite)
 {
-	if(isEmpty() || !_effectStatePerEffectName.contains(effectName))
+	EffectState* effectState = findEffectState(effectName);
+	if(nullptr == effectState)
 	{
 		return;
 	}
-	auto& effectState = _effectStatePerEffectName[effectName];
-	effectState.setUniformBoolVariable(runtime, uniformName, valueToWrite);
-}
-
-
-void ReshadeStateSnapshot::addEffectState(EffectState toAdd)
-{
-	_effectStatePerEffectName.emplace(toAdd.name(), toAdd);
+	effectState->setUniformBoolVariable(runtime, uniformName, valueToWrite);
 }
 
 
-void ReshadeStateSnapshot::applyState(reshade::api::effect_runtime* runtime)
+void ReshadeStateSnapshot::applyState(reshade::api::effect_runtime* runtime) const
 {
 	// Apply uniform value state
-	for(auto& it : _effectStatePerEffectName)
+	for(auto& effectState : _effectStates)
 	{
-		it.second.applyState(runtime);
+		effectState.applyState(runtime);
 	}
 
 	// Apply technique state
-	for(auto& nameIdPair : _techniqueIdPerName)
+	for(const auto& techniqueState : *_techniqueStates)
 	{
-		runtime->set_technique_state(reshade::api::effect_technique(nameIdPair.second), _techniqueEnabledPerName[nameIdPair.first]);
+		runtime->set_technique_state(reshade::api::effect_technique(techniqueState.techniqueId), techniqueState.isEnabled);
 	}
 }
 
@@ -137,56 +153,99 @@ void ReshadeStateSnapshot::migrateState(const ReshadeStateSnapshot& currentState
 		return;
 	}
 
-	// now migrate to this new state. 
-	for(auto& nameEffectPair : currentState._effectStatePerEffectName)
+	// now migrate to this new state. Both effect lists are sorted on name so we walk them side by side. Effects which are already bound to the ids in currentState
+	// are skipped by migrateIds.
+	auto effectIt = _effectStates.begin();
+	for(const auto& currentEffectState : currentState._effectStates)
 	{
-		if(!_effectStatePerEffectName.contains(nameEffectPair.first))
+		while(effectIt != _effectStates.end() && effectIt->nameSymbol() < currentEffectState.nameSymbol())
+		{
+			++effectIt;
+		}
+		if(effectIt == _effectStates.end())
+		{
+			break;
+		}
+		if(effectIt->nameSymbol() != currentEffectState.nameSymbol())
 		{
 			// not known. We can ignore it as we don't store uniforms for unknown effects (it's the same as having an effect / technique being disabled).
 			continue;
 		}
 		// it's there, migrate id's
-		EffectState& toMigrate = _effectStatePerEffectName[nameEffectPair.first];
-		toMigrate.migrateIds(nameEffectPair.second);
+		effectIt->migrateIds(currentEffectState);
 	}
 
-	_techniqueIdPerName.clear();
-	// migrate technique ids
-	for(auto& nameIsEnabledPair : currentState._techniqueEnabledPerName)
+	// migrate technique ids. It's a bit nonsense to alter shader files while setting up a path and reloading the preset, but let's cover all the basis... 
+	if(hasTechniqueIdsOf(currentState))
+	{
+		return;
+	}
+	// The migrated techniques are the ones in currentState: known ones keep their enabled flag, new ones are added, and the ones no longer there are removed.
+	std::vector<TechniqueState> migratedTechniqueStates;
+	migratedTechniqueStates.reserve(currentState._techniqueStates->size());
+	auto techniqueIt = _techniqueStates->begin();
+	for(const auto& currentTechniqueState : *currentState._techniqueStates)
 	{
-		// It's a bit nonsense to alter shader files while setting up a path and reloading the preset, but let's cover all the basis... 
-		auto sourceIdsPerName = currentState._techniqueIdPerName;
-		const auto id = sourceIdsPerName[nameIsEnabledPair.first];
-		if(!_techniqueEnabledPerName.contains(nameIsEnabledPair.first))
+		while(techniqueIt != _techniqueStates->end() && techniqueIt->name < currentTechniqueState.name)
+		{
+			++techniqueIt;
+		}
+		if(techniqueIt != _techniqueStates->end() && techniqueIt->name == currentTechniqueState.name)
+		{
+			migratedTechniqueStates.push_back({ currentTechniqueState.name, techniqueIt->isEnabled, currentTechniqueState.techniqueId });
+		}
+		else
 		{
 			// add it, it was not yet known
-			_techniqueEnabledPerName[nameIsEnabledPair.first] = nameIsEnabledPair.second;
+			migratedTechniqueStates.push_back(currentTechniqueState);
 		}
-		_techniqueIdPerName[nameIsEnabledPair.first] = id;
 	}
-
-	// it might be the new state has less techniques than we had in the previous state. Check if there are left over techniques.
-	std::vector<std::string> toRemove;
-	for(auto& nameValuePair : _techniqueEnabledPerName)
+	if(migratedTechniqueStates != *_techniqueStates)
 	{
-		if(!_techniqueIdPerName.contains(nameValuePair.first))
-		{
-			// no longer there
-			toRemove.push_back(nameValuePair.first);
-		}
+		_techniqueStates = std::make_shared<const std::vector<TechniqueState>>(std::move(migratedTechniqueStates));
 	}
+}
 
-	for(auto& it : toRemove)
+
+bool ReshadeStateSnapshot::isBoundTo(const ReshadeStateSnapshot& currentState) const
+{
+	if(currentState.isEmpty())
+	{
+		// see migrateState
+		return true;
+	}
+	if(!hasTechniqueIdsOf(currentState))
+	{
+		return false;
+	}
+	auto currentEffectIt = currentState._effectStates.begin();
+	const auto currentEffectEnd = currentState._effectStates.end();
+	for(const auto& effectState : _effectStates)
 	{
-		_techniqueEnabledPerName.erase(it);
+		while(currentEffectIt != currentEffectEnd && currentEffectIt->nameSymbol() < effectState.nameSymbol())
+		{
+			++currentEffectIt;
+		}
+		if(currentEffectIt == currentEffectEnd)
+		{
+			break;
+		}
+		if(currentEffectIt->nameSymbol() == effectState.nameSymbol() && !effectState.isBoundTo(*currentEffectIt))
+		{
+			return false;
+		}
 	}
+	return true;
 }
 
 
-void ReshadeStateSnapshot::addTechnique(reshade::api::effect_technique id, std::string name, bool isEnabled)
+bool ReshadeStateSnapshot::hasTechniqueIdsOf(const ReshadeStateSnapshot& currentState) const
 {
-	_techniqueEnabledPerName[name] = isEnabled;
-	_techniqueIdPerName.emplace(name, id.handle);
+	// the migrated techniques are exactly the ones in currentState, so if we have the same techniques with the same ids, there's nothing to migrate.
+	return std::ranges::equal(*_techniqueStates, *currentState._techniqueStates, [](const TechniqueState& ours, const TechniqueState& current)
+							  {
+								  return ours.name == current.name && ours.techniqueId == current.techniqueId;
+							  });
 }
 
 
@@ -194,8 +253,9 @@ void ReshadeStateSnapshot::obtainReshadeState(reshade::api::effect_runtime* runt
 {
 	// enumerate techniques. if a technique is enabled, grab the effect name and its uniforms and per uniform its value. We don't store uniforms for effects which have no
 	// enabled technique, as we won't lerp to these values anyway. 
-	std::unordered_set<std::string> effectNamesWithEnabledTechniques;
-	runtime->enumerate_techniques(nullptr, [this, &effectNamesWithEnabledTechniques](reshade::api::effect_runtime* sourceRuntime, reshade::api::effect_technique technique)
+	std::unordered_set<IGCS::SymbolTable::Symbol> effectNamesWithEnabledTechniques;
+	std::vector<TechniqueState> techniqueStates;
+	runtime->enumerate_techniques(nullptr, [&techniqueStates, &effectNamesWithEnabledTechniques](reshade::api::effect_runtime* sourceRuntime, reshade::api::effect_technique technique)
 	{
 		const bool isEnabled = sourceRuntime->get_technique_state(technique);
 		char nameBuffer[1024] = { 0 };
@@ -205,85 +265,151 @@ void ReshadeStateSnapshot::obtainReshadeState(reshade::api::effect_runtime* runt
 		{
 			// grab the effect name
 			sourceRuntime->get_technique_effect_name(technique, nameBuffer, &nameBufferLength);
-			std::string effectName(nameBuffer);
-			effectNamesWithEnabledTechniques.emplace(effectName);
+			effectNamesWithEnabledTechniques.emplace(IGCS::SymbolTable::intern(nameBuffer));
 		}
 
 		memset(nameBuffer, 0, sizeof(char));
 		nameBufferLength = 1024;
 		sourceRuntime->get_technique_name(technique, nameBuffer, &nameBufferLength);
-		const std::string techniqueName(nameBuffer);
-
-		addTechnique(technique, techniqueName, isEnabled);
+		techniqueStates.push_back({ IGCS::SymbolTable::intern(nameBuffer), isEnabled, technique.handle });
 	});
 
+	// sort the techniques on name. If a name occurs more than once, the id of the first one is kept and the enabled flag of the last one.
+	std::ranges::stable_sort(techniqueStates, {}, &TechniqueState::name);
+	std::vector<TechniqueState> uniqueTechniqueStates;
+	uniqueTechniqueStates.reserve(techniqueStates.size());
+	for(const auto& techniqueState : techniqueStates)
+	{
+		if(!uniqueTechniqueStates.empty() && uniqueTechniqueStates.back().name == techniqueState.name)
+		{
+			uniqueTechniqueStates.back().isEnabled = techniqueState.isEnabled;
+			continue;
+		}
+		uniqueTechniqueStates.push_back(techniqueState);
+	}
+	_techniqueStates = std::make_shared<const std::vector<TechniqueState>>(std::move(uniqueTechniqueStates));
+
 	// per effect name, obtain all uniforms.
-	for(const auto it : effectNamesWithEnabledTechniques)
+	_effectStates.reserve(effectNamesWithEnabledTechniques.size());
+	for(const auto effectName : effectNamesWithEnabledTechniques)
 	{
-		const auto effectName = it;
 		EffectState state(effectName);
 		state.obtainEffectState(runtime);
-		addEffectState(state);
+		_effectStates.push_back(std::move(state));
 	}
+	std::ranges::sort(_effectStates, {}, &EffectState::nameSymbol);
 }
 
 
-void ReshadeStateSnapshot::applyStateFromTo(const ReshadeStateSnapshot& snapShotDestination, float interpolationFactor, reshade::api::effect_runtime* runtime)
+void ReshadeStateSnapshot::compileInterpolationPlan(const ReshadeStateSnapshot& snapShotDestination, StateInterpolationPlan& plan) const
 {
-	// traverse our effects and interpolate their values to the values in snapShotDestination using the interpolation factor
-	std::unordered_map<std::string, EffectState> destinationEffectsPerName = snapShotDestination._effectStatePerEffectName;
-	for(auto& nameEffectPair : _effectStatePerEffectName)
+	plan.clear();
+	auto destinationEffectIt = snapShotDestination._effectStates.begin();
+	const auto destinationEffectEnd = snapShotDestination._effectStates.end();
+	for(const auto& effectState : _effectStates)
 	{
-		if(!destinationEffectsPerName.contains(nameEffectPair.first))
+		while(destinationEffectIt != destinationEffectEnd && destinationEffectIt->nameSymbol() < effectState.nameSymbol())
+		{
+			++destinationEffectIt;
+		}
+		if(destinationEffectIt == destinationEffectEnd)
+		{
+			break;
+		}
+		if(destinationEffectIt->nameSymbol() != effectState.nameSymbol())
 		{
 			continue;
 		}
-		const auto& destinationEffect = destinationEffectsPerName[nameEffectPair.first];
-		nameEffectPair.second.applyStateFromTo(runtime, destinationEffect, interpolationFactor);
+		effectState.addToInterpolationPlan(*destinationEffectIt, plan);
 	}
 
-	// if techniques are enabled in both this snapshot and the destination snapshot, we're going to enable the technique. Otherwise the technique is disabled.
-	std::unordered_map<std::string, bool> destinationTechniqueEnabledPerName = snapShotDestination._techniqueEnabledPerName;
-	for(auto& nameIsEnabledPair : _techniqueEnabledPerName)
-	{
-		bool newTechniqueState = false;
+	addTechniquesToInterpolationPlan(snapShotDestination, plan);
+}
 
-		if(destinationTechniqueEnabledPerName.contains(nameIsEnabledPair.first))
+
+void ReshadeStateSnapshot::compileSplineInterpolationPlan(const ReshadeStateSnapshot* snapShotPrevious, const ReshadeStateSnapshot& snapShotDestination, 
+														  const ReshadeStateSnapshot* snapShotNext, StateInterpolationPlan& plan) const
+{
+	plan.clear();
+	auto destinationEffectIt = snapShotDestination._effectStates.begin();
+	const auto destinationEffectEnd = snapShotDestination._effectStates.end();
+	for(const auto& effectState : _effectStates)
+	{
+		while(destinationEffectIt != destinationEffectEnd && destinationEffectIt->nameSymbol() < effectState.nameSymbol())
+		{
+			++destinationEffectIt;
+		}
+		if(destinationEffectIt == destinationEffectEnd)
+		{
+			break;
+		}
+		if(destinationEffectIt->nameSymbol() != effectState.nameSymbol())
 		{
-			const auto& destinationIsEnabled = destinationTechniqueEnabledPerName[nameIsEnabledPair.first];
-			newTechniqueState = nameIsEnabledPair.second && destinationIsEnabled;
+			continue;
 		}
+		const EffectState* previousEffect = nullptr == snapShotPrevious ? nullptr : snapShotPrevious->findEffectState(effectState.nameSymbol());
+		const EffectState* nextEffect = nullptr == snapShotNext ? nullptr : snapShotNext->findEffectState(effectState.nameSymbol());
+		effectState.addToSplineInterpolationPlan(previousEffect, *destinationEffectIt, nextEffect, plan);
+	}
+	addTechniquesToInterpolationPlan(snapShotDestination, plan);
+}
+
 
-		const auto id = _techniqueIdPerName[nameIsEnabledPair.first];
-		runtime->set_technique_state(reshade::api::effect_technique(id), newTechniqueState);
+void ReshadeStateSnapshot::addTechniquesToInterpolationPlan(const ReshadeStateSnapshot& snapShotDestination, StateInterpolationPlan& plan) const
+{
+	// a technique is enabled during the interpolation if it's enabled in both snapshots.
+	auto destinationTechniqueIt = snapShotDestination._techniqueStates->begin();
+	const auto destinationTechniqueEnd = snapShotDestination._techniqueStates->end();
+	for(const auto& techniqueState : *_techniqueStates)
+	{
+		while(destinationTechniqueIt != destinationTechniqueEnd && destinationTechniqueIt->name < techniqueState.name)
+		{
+			++destinationTechniqueIt;
+		}
+		const bool presentInDestination = destinationTechniqueIt != destinationTechniqueEnd && destinationTechniqueIt->name == techniqueState.name;
+		plan.addTechnique(techniqueState.techniqueId, presentInDestination && techniqueState.isEnabled && destinationTechniqueIt->isEnabled);
 	}
 }
 
 
 ReshadeStateSnapshot ReshadeStateSnapshot::getNewlyEnabledEffects(const ReshadeStateSnapshot& originalSnapshot) const
 {
-	// only return the newly enabled effects. effects that have been disabled now aren't reported.
+	// only return the newly enabled effects. effects that have been disabled now aren't reported. As we walk our own sorted lists, the lists of the 
+	// snapshot returned are sorted too.
 	ReshadeStateSnapshot toReturn;
 
 	// techniques
-	for (const auto& [techniqueName, isEnabled] : _techniqueEnabledPerName)
+	std::vector<TechniqueState> newlyEnabledTechniqueStates;
+	auto originalTechniqueIt = originalSnapshot._techniqueStates->begin();
+	const auto originalTechniqueEnd = originalSnapshot._techniqueStates->end();
+	for(const auto& techniqueState : *_techniqueStates)
 	{
-		auto originalKvp = originalSnapshot._techniqueEnabledPerName.find(techniqueName);
-		if(originalKvp == originalSnapshot._techniqueEnabledPerName.end() || (isEnabled && !originalKvp->second))
+		while(originalTechniqueIt != originalTechniqueEnd && originalTechniqueIt->name < techniqueState.name)
+		{
+			++originalTechniqueIt;
+		}
+		const bool presentInOriginal = originalTechniqueIt != originalTechniqueEnd && originalTechniqueIt->name == techniqueState.name;
+		if(!presentInOriginal || (techniqueState.isEnabled && !originalTechniqueIt->isEnabled))
 		{
 			// this technique is now enabled or wasn't present in the original and is now present, so copy it over.
-			toReturn._techniqueEnabledPerName[techniqueName] = isEnabled;
-			toReturn._techniqueIdPerName[techniqueName] = _techniqueIdPerName.at(techniqueName);		// id entry is there as we add them together.
+			newlyEnabledTechniqueStates.push_back(techniqueState);
 		}
 	}
+	toReturn._techniqueStates = std::make_shared<const std::vector<TechniqueState>>(std::move(newlyEnabledTechniqueStates));
 
 	// effects
-	for(const auto& [effectName, effectState] : _effectStatePerEffectName)
+	auto originalEffectIt = originalSnapshot._effectStates.begin();
+	const auto originalEffectEnd = originalSnapshot._effectStates.end();
+	for(const auto& effectState : _effectStates)
 	{
-		if(!originalSnapshot._effectStatePerEffectName.contains(effectName))
+		while(originalEffectIt != originalEffectEnd && originalEffectIt->nameSymbol() < effectState.nameSymbol())
+		{
+			++originalEffectIt;
+		}
+		if(originalEffectIt == originalEffectEnd || originalEffectIt->nameSymbol() != effectState.nameSymbol())
 		{
 			// not found, so it's new in this snapshot, so we have to copy it over.
-			toReturn._effectStatePerEffectName[effectName] = effectState;
+			toReturn._effectStates.push_back(effectState);
 		}
 	}
 
@@ -296,25 +422,143 @@ void ReshadeStateSnapshot::addNewlyEnabledEffects(const ReshadeStateSnapshot& sn
 	// snapShotWithNewlyEnabledEffectsToCopy contains effects that should be copied to this snapshot. If we already have the effects
 	// we'll skip it, otherwise we'll copy the effects. We'll also set the enabled flags on the techniques if they're set in the snapShotWithNewlyEnabledEffectsToCopy.
 
-	// techniques
-	for(const auto& [techniqueName, isEnabled] : snapShotWithNewlyEnabledEffectsToCopy._techniqueEnabledPerName)
+	// techniques. The block is shared with other snapshots, so the changes are made to a copy.
+	std::vector<TechniqueState> techniqueStates = *_techniqueStates;
+	const size_t numberOfTechniquesBefore = techniqueStates.size();
+	for(const auto& techniqueStateToCopy : *snapShotWithNewlyEnabledEffectsToCopy._techniqueStates)
 	{
-		auto currentKvp = _techniqueEnabledPerName.find(techniqueName);
-		if(currentKvp == _techniqueEnabledPerName.end() || (isEnabled && !currentKvp->second))
+		const auto currentEnd = techniqueStates.begin() + numberOfTechniquesBefore;
+		const auto currentIt = std::ranges::lower_bound(techniqueStates.begin(), currentEnd, techniqueStateToCopy.name, {}, &TechniqueState::name);
+		if(currentIt == currentEnd || currentIt->name != techniqueStateToCopy.name)
+		{
+			// this technique wasn't present yet, so copy it over.
+			techniqueStates.push_back(techniqueStateToCopy);
+		}
+		else if(techniqueStateToCopy.isEnabled && !currentIt->isEnabled)
 		{
-			// this technique is now enabled or wasn't present yet, so copy it over.
-			_techniqueEnabledPerName[techniqueName] = isEnabled;
-			_techniqueIdPerName[techniqueName] = _techniqueIdPerName.at(techniqueName);		// id entry is there as we add them together.
+			// this technique is now enabled
+			currentIt->isEnabled = true;
 		}
 	}
+	std::ranges::inplace_merge(techniqueStates, techniqueStates.begin() + numberOfTechniquesBefore, {}, &TechniqueState::name);
+	if(techniqueStates != *_techniqueStates)
+	{
+		_techniqueStates = std::make_shared<const std::vector<TechniqueState>>(std::move(techniqueStates));
+	}
 
 	// effects
-	for(const auto& [effectName, effectState] : snapShotWithNewlyEnabledEffectsToCopy._effectStatePerEffectName)
+	const size_t numberOfEffectsBefore = _effectStates.size();
+	for(const auto& effectStateToCopy : snapShotWithNewlyEnabledEffectsToCopy._effectStates)
 	{
-		if(!_effectStatePerEffectName.contains(effectName))
+		const auto currentEnd = _effectStates.begin() + numberOfEffectsBefore;
+		if(!std::ranges::binary_search(_effectStates.begin(), currentEnd, effectStateToCopy.nameSymbol(), {}, &EffectState::nameSymbol))
 		{
-			// not found, so it's new in this snapshot, so we have to copy it over.
-			_effectStatePerEffectName[effectName] = effectState;
+			// not found, so it's new in this snapshot, so we have to copy it over. This only copies the references to its blocks.
+			_effectStates.push_back(effectStateToCopy);
 		}
 	}
+	std::ranges::inplace_merge(_effectStates, _effectStates.begin() + numberOfEffectsBefore, {}, &EffectState::nameSymbol);
+	_effectStates.shrink_to_fit();
+}
+
+
+void ReshadeStateSnapshot::writeTo(IGCS::BinaryWriter& writer) const
+{
+	writer.write((uint32_t)_techniqueStates->size());
+	for(const auto& techniqueState : *_techniqueStates)
+	{
+		writer.writeSymbol(techniqueState.name);
+		writer.write((uint32_t)(techniqueState.isEnabled ? 1 : 0));
+	}
+	writer.write((uint32_t)_effectStates.size());
+	for(const auto& effectState : _effectStates)
+	{
+		effectState.writeTo(writer);
+	}
+}
+
+
+bool ReshadeStateSnapshot::readFrom(IGCS::BinaryReader& reader)
+{
+	uint32_t numberOfTechniques = 0;
+	if(!reader.read(numberOfTechniques) || !reader.hasBytesLeft((size_t)numberOfTechniques * 2 * sizeof(uint32_t)))
+	{
+		return false;
+	}
+	std::vector<TechniqueState> techniqueStates;
+	techniqueStates.reserve(numberOfTechniques);
+	for(uint32_t i = 0; i < numberOfTechniques; i++)
+	{
+		TechniqueState toRead = { IGCS::SymbolTable::INVALID_SYMBOL, false, 0 };
+		uint32_t isEnabled = 0;
+		if(!reader.readSymbol(toRead.name) || !reader.read(isEnabled))
+		{
+			return false;
+		}
+		toRead.isEnabled = isEnabled != 0;
+		techniqueStates.push_back(toRead);
+	}
+
+	uint32_t numberOfEffects = 0;
+	if(!reader.read(numberOfEffects) || !reader.hasBytesLeft((size_t)numberOfEffects * 2 * sizeof(uint32_t)))
+	{
+		return false;
+	}
+	_effectStates.clear();
+	_effectStates.reserve(numberOfEffects);
+	for(uint32_t i = 0; i < numberOfEffects; i++)
+	{
+		EffectState toRead;
+		if(!toRead.readFrom(reader))
+		{
+			return false;
+		}
+		_effectStates.push_back(std::move(toRead));
+	}
+	// the symbols of this session are likely different from the ones of the session which wrote the data, so the order has to be restored.
+	std::ranges::sort(techniqueStates, {}, &TechniqueState::name);
+	_techniqueStates = std::make_shared<const std::vector<TechniqueState>>(std::move(techniqueStates));
+	std::ranges::sort(_effectStates, {}, &EffectState::nameSymbol);
+	return true;
+}
+
+
+void ReshadeStateSnapshot::shareUnchangedStateWith(const ReshadeStateSnapshot& other)
+{
+	if(_techniqueStates != other._techniqueStates && *_techniqueStates == *other._techniqueStates)
+	{
+		_techniqueStates = other._techniqueStates;
+	}
+	auto otherEffectIt = other._effectStates.begin();
+	const auto otherEffectEnd = other._effectStates.end();
+	for(auto& effectState : _effectStates)
+	{
+		while(otherEffectIt != otherEffectEnd && otherEffectIt->nameSymbol() < effectState.nameSymbol())
+		{
+			++otherEffectIt;
+		}
+		if(otherEffectIt == otherEffectEnd)
+		{
+			break;
+		}
+		if(otherEffectIt->nameSymbol() == effectState.nameSymbol())
+		{
+			effectState.shareUnchangedStateWith(*otherEffectIt);
+		}
+	}
+}
+
+
+size_t ReshadeStateSnapshot::memoryUsageInBytes(std::unordered_set<const void*>& blocksCounted) const
+{
+	size_t toReturn = sizeof(ReshadeStateSnapshot) + _effectStates.capacity() * sizeof(EffectState);
+	if(blocksCounted.insert(_techniqueStates.get()).second)
+	{
+		toReturn += _techniqueStates->capacity() * sizeof(TechniqueState);
+	}
+	for(const auto& effectState : _effectStates)
+	{
+		toReturn += effectState.memoryUsageInBytes(blocksCounted);
+	}
+	return toReturn;
 }
@@ -33,32 +33,83 @@
 
 #pragma once
 
+#include <memory>
 #include <reshade.hpp>
 #include <string>
-#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "BinaryStream.h"
 #include "EffectState.h"
+#include "StateInterpolationPlan.h"
+#include "SymbolTable.h"
+
+/// <summary>
+/// The state of a single technique: its name, the id to set it with and whether it's enabled.
+/// </summary>
+struct TechniqueState
+{
+	IGCS::SymbolTable::Symbol name;
+	bool isEnabled;
+	uint64_t techniqueId;
+
+	bool operator==(const TechniqueState& other) const = default;
+};
 
 /// <summary>
 /// Defines a reshade state snapshot, which contains all enabled techniques and all uniform variables and their values. 
 /// </summary>
-///	<remarks>It's not possible to add a mutex to this class as it's contained in the CameraPathData objects for camera paths.</remarks>
+///	<remarks>It's not possible to add a mutex to this class as it's contained in the CameraPathData objects for camera paths.
+///	Names are stored as symbols and effects and techniques are kept sorted on their name symbol, so a path with many snapshots doesn't store the same strings
+///	over and over and two snapshots can be compared in a single pass. The techniques and the uniforms of the effects are kept in immutable blocks which are shared
+///	between snapshots, so snapshots on a path which are mostly the same mostly share their data.</remarks>
 class ReshadeStateSnapshot
 {
 public:
-	void applyState(reshade::api::effect_runtime* runtime);
+	void applyState(reshade::api::effect_runtime* runtime) const;
 
 	/// <summary>
 	/// Will migrate the state contained in this snapshot to the new id's used for variables. Doesn't mgirate variables to new values, only
 	///	id's so we can set the state again using the current id's. Will also remove effects that are no longer enabled, and add new ones that are now enabled. 
 	/// </summary>
 	void migrateState(const ReshadeStateSnapshot& currentState);
+	/// <summary>
+	/// Returns true if migrating this snapshot to currentState wouldn't change anything, as it already uses the ids in currentState.
+	/// </summary>
+	bool isBoundTo(const ReshadeStateSnapshot& currentState) const;
 	void obtainReshadeState(reshade::api::effect_runtime* runtime);
-	void applyStateFromTo(const ReshadeStateSnapshot& snapShotDestination, float interpolationFactor, reshade::api::effect_runtime* runtime);
+	/// <summary>
+	/// Compiles the linear interpolation from this snapshot to snapShotDestination into the plan specified. Only the uniforms present in both snapshots are
+	///	interpolated, and a technique is enabled if it's enabled in both. The plan has to be recompiled when either snapshot changes or its handles are migrated.
+	/// </summary>
+	void compileInterpolationPlan(const ReshadeStateSnapshot& snapShotDestination, StateInterpolationPlan& plan) const;
+	/// <summary>
+	/// Same as compileInterpolationPlan but the uniforms are interpolated using a Catmull-Rom spline which also passes through the values in snapShotPrevious and snapShotNext,
+	/// the states before this snapshot and after snapShotDestination on the path. Pass nullptr for either if there's no such state.
+	/// </summary>
+	void compileSplineInterpolationPlan(const ReshadeStateSnapshot* snapShotPrevious, const ReshadeStateSnapshot& snapShotDestination, const ReshadeStateSnapshot* snapShotNext, 
+										StateInterpolationPlan& plan) const;
 	ReshadeStateSnapshot getNewlyEnabledEffects(const ReshadeStateSnapshot& originalSnapshot) const;
 	void addNewlyEnabledEffects(const ReshadeStateSnapshot& snapShotWithNewlyEnabledEffectsToCopy);
 
-	bool isEmpty() const { return _effectStatePerEffectName.size() <= 0; }
-	int numberOfContainedEffects() { return _effectStatePerEffectName.size(); }
+	/// <summary>
+	/// Writes the techniques and effects by name. Ids aren't written as they're only valid in the current session, use migrateState after reading.
+	/// </summary>
+	void writeTo(IGCS::BinaryWriter& writer) const;
+	/// <summary>
+	/// Reads the data written by writeTo. Returns false if the data is corrupt.
+	/// </summary>
+	bool readFrom(IGCS::BinaryReader& reader);
+	/// <summary>
+	/// Makes this snapshot share the blocks of other which contain the same data as its own, so only the data which differs between the two is stored twice.
+	/// </summary>
+	void shareUnchangedStateWith(const ReshadeStateSnapshot& other);
+	/// <summary>
+	/// Returns the number of bytes used by this snapshot, not counting the blocks already in blocksCounted. The blocks counted are added to blocksCounted.
+	/// </summary>
+	size_t memoryUsageInBytes(std::unordered_set<const void*>& blocksCounted) const;
+
+	bool isEmpty() const { return _effectStates.size() <= 0; }
+	int numberOfContainedEffects() { return _effectStates.size(); }
 	void logContents();
 	void setUniformIntVariable(reshade::api::effect_runtime* runtime, const std::string& effectName, const std::string& uniformName, int valueToWrite);
 	void setUniformFloatVariable(reshade::api::effect_runtime* runtime, const std::string& effectName, const std::string& uniformName, float valueToWrite);
@@ -66,11 +117,12 @@ public:
 	void setUniformBoolVariable(reshade::api::effect_runtime* runtime, const std::string& effectName, const std::string& uniformName, bool valueToWrite);
 
 private:
-	void addEffectState(EffectState toAdd);
-	void addTechnique(reshade::api::effect_technique id, std::string name, bool isEnabled);
+	EffectState* findEffectState(const std::string& effectName);
+	const EffectState* findEffectState(IGCS::SymbolTable::Symbol effectName) const;
+	void addTechniquesToInterpolationPlan(const ReshadeStateSnapshot& snapShotDestination, StateInterpolationPlan& plan) const;
+	bool hasTechniqueIdsOf(const ReshadeStateSnapshot& currentState) const;
 
-	std::unordered_map<std::string, EffectState> _effectStatePerEffectName;
-	std::unordered_map<std::string, uint64_t> _techniqueIdPerName;
-	std::unordered_map<std::string, bool> _techniqueEnabledPerName;
+	std::vector<EffectState> _effectStates;				// sorted on name symbol
+	std::shared_ptr<const std::vector<TechniqueState>> _techniqueStates = std::make_shared<const std::vector<TechniqueState>>();		// sorted on name symbol
 };
 
@@ -33,21 +33,18 @@
 #include "stdafx.h"
 #include "ScreenshotController.h"
 #include "CameraToolsConnector.h"
-#include <direct.h>
+#include "ImageUtils.h"
 #include "OverlayControl.h"
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "std_image_write.h"
+#include "Platform.h"
 #include "Utils.h"
 #include <thread>
 
-#include "fpng.h"
-
 ScreenshotController::ScreenshotController(CameraToolsConnector& connector) : _cameraToolsConnector(connector)
 {
 }
 
 
-void ScreenshotController::configure(std::string rootFolder, int numberOfFramesToWaitBetweenSteps, ScreenshotFiletype filetype)
+void ScreenshotController::configure(std::string rootFolder, int numberOfFramesToWaitBetweenSteps, ScreenshotFiletype filetype, bool useFastJpegEncoder, int shotMemoryBudgetInMB, bool spillShotsToDisk)
 {
 	if (_state != ScreenshotControllerState::Off)
 	{
@@ -59,6 +56,9 @@ void ScreenshotController::configure(std::string rootFolder, int numberOfFramesT
 	_rootFolder = rootFolder;
 	_numberOfFramesToWaitBetweenSteps = numberOfFramesToWaitBetweenSteps;
 	_filetype = filetype;
+	_useFastJpegEncoder = useFastJpegEncoder;
+	_frameBufferPool.setMemoryBudget((size_t)shotMemoryBudgetInMB * 1024 * 1024);
+	_spillShotsToDisk = spillShotsToDisk;
 }
 
 
@@ -92,16 +92,24 @@ void ScreenshotController::reshadeEffectsRendered(reshade::api::effect_runtime*
 	{
 		// take a screenshot
 		runtime->get_screenshot_width_and_height(&_framebufferWidth, &_framebufferHeight);
-		std::vector<uint8_t> shotData(_framebufferWidth * _framebufferHeight * 4);
-		runtime->capture_screenshot(shotData.data());
-
-		// as alpha is 0 anyway, we pack the RGBA data as RGB data. This is faster than setting all alpha channels to FF.
-		// From Reshade
-		for(int i = 0; i < _framebufferWidth * _framebufferHeight; ++i)
+		const size_t shotSizeInBytes = (size_t)_framebufferWidth * _framebufferHeight * 4;
+		FrameBuffer shotData = _frameBufferPool.tryAcquire(shotSizeInBytes);
+		if(shotData.isEmpty() && _spillShotsToDisk && !_isTestRun)
 		{
-			*reinterpret_cast<uint32_t*>(shotData.data() + 3 * i) = *reinterpret_cast<const uint32_t*>(shotData.data() + 4 * i);
+			// memory budget has been reached, store the shot raw in the scratch file instead. It's encoded when the writer gets to it.
+			shotData = _frameSpillFile.tryAcquire(shotSizeInBytes);
 		}
-		storeGrabbedShot(shotData);
+		if(shotData.isEmpty())
+		{
+			// the memory budget has been used up by shots the writer is still busy with. The camera isn't moved till the shot has been taken,
+			// so we simply try again next frame.
+			return;
+		}
+		runtime->capture_screenshot(shotData.data());
+
+		// as alpha is 0 anyway, we pack the RGBA data as RGB data. This is faster than setting all alpha channels to FF. Packed in place.
+		IGCS::ImageUtils::packRGBAToRGB(shotData.data(), shotData.data(), (size_t)_framebufferWidth * _framebufferHeight);
+		storeGrabbedShot(std::move(shotData));
 	}
 }
 
@@ -120,6 +128,8 @@ void ScreenshotController::cancelSession()
 		break;
 	case ScreenshotControllerState::SavingShots:
 		_state = ScreenshotControllerState::Canceling;
+		// shots which are still queued are discarded.
+		_screenshotWriter.cancel();
 		break;
 	}
 }
@@ -130,7 +140,11 @@ void ScreenshotController::completeShotSession()
 	const std::string shotTypeDescription = typeOfShotAsString();
 	// we'll wait now till all the shots are taken. 
 	waitForShots();
-	if(_state != ScreenshotControllerState::Canceling)
+	if(_state == ScreenshotControllerState::Canceling)
+	{
+		_screenshotWriter.cancel();
+	}
+	else
 	{
 		if(_isTestRun)
 		{
@@ -138,11 +152,30 @@ void ScreenshotController::completeShotSession()
 		}
 		else
 		{
+			// most shots have already been written while the session was running, wait for the ones still in progress.
 			OverlayControl::addNotification("All " + shotTypeDescription + " shots have been taken. Writing shots to disk...");
-			saveGrabbedShots();
-			OverlayControl::addNotification(shotTypeDescription + " done.");
 		}
 	}
+	_screenshotWriter.waitForCompletion();
+	// all buffers are back in the pool, no need to keep the memory around till the next session.
+	_frameBufferPool.clear();
+	const int numberOfFramesSpilled = _frameSpillFile.numberOfFramesSpilled();
+	_frameSpillFile.close();
+	if(numberOfFramesSpilled > 0)
+	{
+		IGCS::Utils::logLineToReshade(reshade::log_level::info, "%d shots were stored in the scratch file as the memory budget had been reached.", numberOfFramesSpilled);
+	}
+	if(!_sessionFolder.empty())
+	{
+		// the folder is created when the session starts, as the scratch file lives in it. Don't leave it behind if e.g. the session was canceled
+		// before a shot was written.
+		IGCS::Platform::removeEmptyDirectory(_sessionFolder);
+		_sessionFolder.clear();
+	}
+	if(_state != ScreenshotControllerState::Canceling && !_isTestRun)
+	{
+		OverlayControl::addNotification(shotTypeDescription + " done.");
+	}
 	// done
 	reset();
 }
@@ -186,6 +219,16 @@ bool ScreenshotController::startSession()
 		displayScreenshotSessionStartError(sessionStartResult);
 		return false;
 	}
+	if(!_isTestRun)
+	{
+		// start the writer so shots are saved as soon as they're grabbed.
+		_sessionFolder = createScreenshotFolder();
+		_screenshotWriter.start(_sessionFolder, _filetype, _useFastJpegEncoder);
+		if(_spillShotsToDisk && !_frameSpillFile.open(_sessionFolder))
+		{
+			OverlayControl::addNotification("Couldn't create the scratch file for shots. Shots will be kept in memory only.");
+		}
+	}
 	return true;
 }
 
@@ -300,13 +343,11 @@ void ScreenshotController::startDebugGridShot()
 
 std::string ScreenshotController::createScreenshotFolder()
 {
-	time_t t = time(nullptr);
-	tm tm;
-	localtime_s(&tm, &t);
-	const std::string optionalBackslash = (_rootFolder.ends_with('\\')) ? "" : "\\";
-	std::string folderName = IGCS::Utils::formatString("%s%s%s-%.4d-%.2d-%.2d-%.2d-%.2d-%.2d", _rootFolder.c_str(), optionalBackslash.c_str(), typeOfShotAsString().c_str(), 
+	const tm tm = IGCS::Platform::currentLocalTime();
+	const std::string optionalSeparator = (_rootFolder.ends_with(IGCS::Platform::PATH_SEPARATOR)) ? "" : std::string(1, IGCS::Platform::PATH_SEPARATOR);
+	std::string folderName = IGCS::Utils::formatString("%s%s%s-%.4d-%.2d-%.2d-%.2d-%.2d-%.2d", _rootFolder.c_str(), optionalSeparator.c_str(), typeOfShotAsString().c_str(), 
 													   (tm.tm_year + 1900), (tm.tm_mon + 1), tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
-	_mkdir(folderName.c_str());
+	IGCS::Platform::createDirectory(folderName);
 	return folderName;
 }
 
@@ -398,15 +439,18 @@ void ScreenshotController::moveCameraForDebugGrid(int shotCounter, bool end)
 }
 
 
-void ScreenshotController::storeGrabbedShot(std::vector<uint8_t> grabbedShot)
+void ScreenshotController::storeGrabbedShot(FrameBuffer grabbedShot)
 {
-	if(grabbedShot.size() <= 0)
+	if(grabbedShot.isEmpty())
 	{
 		// failed
 		return;
 	}
 
-	_grabbedFrames.push_back(grabbedShot);
+	if(!_isTestRun)
+	{
+		_screenshotWriter.addShot(std::move(grabbedShot), _framebufferWidth, _framebufferHeight, _shotCounter);
+	}
 	_shotCounter++;
 	if(_shotCounter >= _numberOfShotsToTake)
 	{
@@ -423,61 +467,6 @@ void ScreenshotController::storeGrabbedShot(std::vector<uint8_t> grabbedShot)
 }
 
 
-void ScreenshotController::saveGrabbedShots()
-{
-	if(_grabbedFrames.size() <= 0)
-	{
-		return;
-	}
-	if(!_isTestRun)
-	{
-		_state = ScreenshotControllerState::SavingShots;
-		const std::string destinationFolder = createScreenshotFolder();
-		int frameNumber = 0;
-		for(const std::vector<uint8_t>& frame : _grabbedFrames)
-		{
-			saveShotToFile(destinationFolder, frame, frameNumber);
-			frameNumber++;
-		}
-	}
-}
-
-
-void ScreenshotController::saveShotToFile(std::string destinationFolder, const std::vector<uint8_t>& data, int frameNumber)
-{
-	std::string filename = "";
-
-	// The shot data is RGB as we packed the RGBA data as RGB as Alpha is 0 in the source. So we pass 3 as the comp
-	switch(_filetype)
-	{
-	case ScreenshotFiletype::Bmp:
-		filename = IGCS::Utils::formatString("%s\\%d.bmp", destinationFolder.c_str(), frameNumber);
-		stbi_write_bmp(filename.c_str(), _framebufferWidth, _framebufferHeight, 3, data.data()) != 0;
-		break;
-	case ScreenshotFiletype::Jpeg:
-		filename = IGCS::Utils::formatString("%s\\%d.jpg", destinationFolder.c_str(), frameNumber);
-		stbi_write_jpg(filename.c_str(), _framebufferWidth, _framebufferHeight, 3, data.data(), 98) != 0;
-		break;
-	case ScreenshotFiletype::Png:
-		filename = IGCS::Utils::formatString("%s\\%d.png", destinationFolder.c_str(), frameNumber);
-		// 3 bytes per pixel!
-		//stbi_write_png(filename.c_str(), _framebufferWidth, _framebufferHeight, 3, data.data(), 3 * _framebufferWidth) != 0;
-		std::vector<uint8_t> encoded_data;
-		fpng::fpng_encode_image_to_memory(data.data(), _framebufferWidth, _framebufferHeight, 3, encoded_data);
-		FILE* pngFile;
-		if(fopen_s(&pngFile, filename.c_str(), "wb")==0)
-		{
-			fwrite(encoded_data.data(), encoded_data.size(), 1, pngFile);
-		}
-		if(nullptr != pngFile)
-		{
-			fclose(pngFile);
-		}
-		break;
-	}
-}
-
-
 void ScreenshotController::waitForShots()
 {
 	std::unique_lock lock(_waitCompletionMutex);
@@ -503,5 +492,4 @@ void ScreenshotController::reset()
 	_shotCounter = 0;
 	_overlapPercentagePerPanoShot = 30.0f;
 	_isTestRun = false;
-	_grabbedFrames.clear();
 }
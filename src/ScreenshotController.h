@@ -37,6 +37,9 @@
 
 #include "CameraToolsConnector.h"
 #include "ConstantsEnums.h"
+#include "FrameBufferPool.h"
+#include "FrameSpillFile.h"
+#include "ScreenshotWriter.h"
 
 
 // Simple controller class which controls the screenshot session.
@@ -46,11 +49,12 @@ public:
 	ScreenshotController(CameraToolsConnector& connector);
 	~ScreenshotController() = default;
 
-	void configure(std::string rootFolder, int numberOfFramesToWaitBetweenSteps, ScreenshotFiletype filetype);
+	void configure(std::string rootFolder, int numberOfFramesToWaitBetweenSteps, ScreenshotFiletype filetype, bool useFastJpegEncoder, int shotMemoryBudgetInMB, bool spillShotsToDisk);
 	void startHorizontalPanoramaShot(float totalFoVInDegrees, float overlapPercentagePerPanoShot, float currentFoVInDegrees, bool isTestRun);
 	void startLightfieldShot(float distancePerStep, int numberOfShots, bool isTestRun);
 	void startDebugGridShot();
 	ScreenshotControllerState getState() { return _state; }
+	int numberOfShotsToWrite() { return _screenshotWriter.numberOfShotsToWrite(); }
 	void reset();
 	bool shouldTakeShot();		// returns true if a shot should be taken, false otherwise. 
 	void presentCalled();
@@ -66,9 +70,7 @@ private:
 	/// <returns>true if session could successfully be started, false otherwise</returns>
 	bool startSession();
 	void waitForShots();
-	void saveGrabbedShots();
-	void storeGrabbedShot(std::vector<uint8_t>);
-	void saveShotToFile(std::string destinationFolder, const std::vector<uint8_t>& data, int frameNumber);
+	void storeGrabbedShot(FrameBuffer grabbedShot);
 	std::string createScreenshotFolder();
 	void moveCameraForLightfield(int direction, bool end);
 	void moveCameraForPanorama(int direction, bool end);
@@ -91,10 +93,15 @@ private:
 	ScreenshotType _typeOfShot = ScreenshotType::HorizontalPanorama;
 	ScreenshotControllerState _state = ScreenshotControllerState::Off;
 	ScreenshotFiletype _filetype = ScreenshotFiletype::Jpeg;
+	bool _useFastJpegEncoder = true;
 	bool _isTestRun = false;
+	bool _spillShotsToDisk = false;		// if true, shots are stored in _frameSpillFile when the memory budget has been reached.
 
 	std::string _rootFolder;
-	std::vector<std::vector<uint8_t>> _grabbedFrames;
+	std::string _sessionFolder;			// folder created for the session in progress, removed at the end of the session if no shot was written to it.
+	FrameBufferPool _frameBufferPool;		// has to be declared before the writer, as the writer holds buffers from this pool.
+	FrameSpillFile _frameSpillFile;			// idem, the writer holds views of this file.
+	ScreenshotWriter _screenshotWriter;		// grabbed shots are written by this writer while the session is in progress
 
 	// Used together to make sure the main thread in System doesn't busy-wait and waits till the grabbing process has been completed.
 	std::mutex _waitCompletionMutex;
@@ -35,15 +35,16 @@
 
 #include "ConstantsEnums.h"
 #include "stdafx.h"
-#include "ShlObj_core.h"
-
-#pragma comment(lib, "shell32.lib")
+#include "Platform.h"
 
 struct ScreenshotSettings
 {
 	int typeOfScreenshot = (int)ScreenshotType::HorizontalPanorama;
 	int screenshotFileType = (int)ScreenshotFiletype::Jpeg;
+	bool useFastJpegEncoder = true;
 	int numberOfFramesToWaitBetweenSteps = 1;
+	int shotMemoryBudgetInMB = 1024;
+	bool spillShotsToDisk = false;
 	float lightField_distanceBetweenShots = 1.0f;
 	int lightField_numberOfShotsToTake = 45;
 	float pano_totalAngleDegrees = 110.0f;
@@ -52,6 +53,6 @@ struct ScreenshotSettings
 
 	ScreenshotSettings()
 	{
-		SHGetFolderPathA(nullptr, CSIDL_MYPICTURES, nullptr, SHGFP_TYPE_CURRENT, screenshotFolder);
+		IGCS::Platform::picturesFolder().copy(screenshotFolder, _MAX_PATH);
 	}
 };
\ No newline at end of file
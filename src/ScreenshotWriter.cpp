@@ -0,0 +1,281 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "ScreenshotWriter.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "std_image_write.h"
+#include "FastJpegEncoder.h"
+#include "ImageUtils.h"
+#include "Platform.h"
+#include "StripedPngEncoder.h"
+#include "Utils.h"
+
+#include "fpng.h"
+
+
+static void appendToEncodedData(void* context, void* data, int size)
+{
+	auto encodedData = static_cast<std::vector<uint8_t>*>(context);
+	encodedData->insert(encodedData->end(), static_cast<uint8_t*>(data), static_cast<uint8_t*>(data) + size);
+}
+
+
+ScreenshotWriter::~ScreenshotWriter()
+{
+	cancel();
+	waitForCompletion();
+}
+
+
+void ScreenshotWriter::start(const std::string& destinationFolder, ScreenshotFiletype filetype, bool useFastJpegEncoder)
+{
+	// make sure a previous session is completely done.
+	waitForCompletion();
+
+	_destinationFolder = destinationFolder;
+	_filetype = filetype;
+	_useFastJpegEncoder = useFastJpegEncoder && IGCS::FastJpegEncoder::isSupported();
+	{
+		std::scoped_lock lock(_queueMutex);
+		_stopRequested = false;
+		_encodingCompleted = false;
+		_numberOfShotsInProgress = 0;
+		_numberOfShotsBeingWritten = 0;
+		_shotsToSave.clear();
+		_encodedShotsToWrite.clear();
+	}
+
+	// leave one core for the game, it still has to render the frames we have to grab.
+	const unsigned int numberOfCores = std::thread::hardware_concurrency();
+	const unsigned int numberOfWorkers = numberOfCores > 2 ? numberOfCores - 1 : 1;
+	_numberOfWorkers = numberOfWorkers;
+	// one encoded shot per worker can wait for the file writer, so a worker which finishes while the file writer is busy can still hand off its shot.
+	_maximumNumberOfEncodedShotsToWrite = numberOfWorkers;
+	for(unsigned int i = 0; i < numberOfWorkers; i++)
+	{
+		_workers.emplace_back(&ScreenshotWriter::processShots, this);
+	}
+	_fileWriter = std::thread(&ScreenshotWriter::writeEncodedShots, this);
+}
+
+
+void ScreenshotWriter::addShot(FrameBuffer shotData, uint32_t width, uint32_t height, int frameNumber)
+{
+	{
+		std::scoped_lock lock(_queueMutex);
+		if(_stopRequested || _workers.empty())
+		{
+			// not started or cancelled, ignore
+			return;
+		}
+		ShotToSave toAdd;
+		toAdd.data = std::move(shotData);
+		toAdd.width = width;
+		toAdd.height = height;
+		toAdd.frameNumber = frameNumber;
+		_shotsToSave.push_back(std::move(toAdd));
+	}
+	_shotAvailableHandle.notify_one();
+}
+
+
+void ScreenshotWriter::waitForCompletion()
+{
+	{
+		std::scoped_lock lock(_queueMutex);
+		_stopRequested = true;
+	}
+	_shotAvailableHandle.notify_all();
+
+	// workers will stop when the queue is empty.
+	for(auto& worker : _workers)
+	{
+		if(worker.joinable())
+		{
+			worker.join();
+		}
+	}
+	_workers.clear();
+
+	// all shots are encoded, the file writer stops when it has written them all.
+	{
+		std::scoped_lock lock(_queueMutex);
+		_encodingCompleted = true;
+	}
+	_encodedShotAvailableHandle.notify_all();
+	if(_fileWriter.joinable())
+	{
+		_fileWriter.join();
+	}
+}
+
+
+void ScreenshotWriter::cancel()
+{
+	{
+		std::scoped_lock lock(_queueMutex);
+		_shotsToSave.clear();
+		_encodedShotsToWrite.clear();
+		_stopRequested = true;
+	}
+	_shotAvailableHandle.notify_all();
+	_roomForEncodedShotHandle.notify_all();
+}
+
+
+int ScreenshotWriter::numberOfShotsToWrite()
+{
+	std::scoped_lock lock(_queueMutex);
+	return _shotsToSave.size() + _numberOfShotsInProgress + _encodedShotsToWrite.size() + _numberOfShotsBeingWritten;
+}
+
+
+void ScreenshotWriter::processShots()
+{
+	for(;;)
+	{
+		ShotToSave shot;
+		uint32_t numberOfThreadsForShot = 1;
+		{
+			std::unique_lock lock(_queueMutex);
+			_shotAvailableHandle.wait(lock, [this] { return _stopRequested || !_shotsToSave.empty(); });
+			if(_shotsToSave.empty())
+			{
+				// stop requested and nothing left to do.
+				return;
+			}
+			shot = std::move(_shotsToSave.front());
+			_shotsToSave.pop_front();
+			_numberOfShotsInProgress++;
+			// the workers which have nothing to do can be used to encode this shot. If there's enough work for all workers, the shot is encoded on this 
+			// thread alone, so the encoders together never use many more threads than there are cores.
+			const uint32_t numberOfShotsToEncode = _numberOfShotsInProgress + (uint32_t)_shotsToSave.size();
+			numberOfThreadsForShot = numberOfShotsToEncode < _numberOfWorkers ? _numberOfWorkers - numberOfShotsToEncode + 1 : 1;
+		}
+
+		EncodedShot encodedShot;
+		const bool encodingSucceeded = encodeShot(shot, numberOfThreadsForShot, encodedShot);
+		// hand the buffer back to the pool right away so the next shot can be grabbed into it, the file writer only needs the encoded data.
+		shot.data.release();
+
+		{
+			std::unique_lock lock(_queueMutex);
+			// the file writer can't keep up: wait for room instead of keeping ever more encoded shots in memory.
+			_roomForEncodedShotHandle.wait(lock, [this] { return _encodedShotsToWrite.size() < _maximumNumberOfEncodedShotsToWrite; });
+			_numberOfShotsInProgress--;
+			if(encodingSucceeded)
+			{
+				_encodedShotsToWrite.push_back(std::move(encodedShot));
+			}
+		}
+		_encodedShotAvailableHandle.notify_one();
+	}
+}
+
+
+void ScreenshotWriter::writeEncodedShots()
+{
+	for(;;)
+	{
+		EncodedShot shotToWrite;
+		{
+			std::unique_lock lock(_queueMutex);
+			_encodedShotAvailableHandle.wait(lock, [this] { return _encodingCompleted || !_encodedShotsToWrite.empty(); });
+			if(_encodedShotsToWrite.empty())
+			{
+				// all shots have been encoded and written.
+				return;
+			}
+			shotToWrite = std::move(_encodedShotsToWrite.front());
+			_encodedShotsToWrite.pop_front();
+			_numberOfShotsBeingWritten++;
+		}
+		_roomForEncodedShotHandle.notify_one();
+
+		FILE* encodedFile = nullptr;
+		if(fopen_s(&encodedFile, shotToWrite.filename.c_str(), "wb")==0)
+		{
+			fwrite(shotToWrite.data.data(), shotToWrite.data.size(), 1, encodedFile);
+		}
+		if(nullptr != encodedFile)
+		{
+			fclose(encodedFile);
+		}
+
+		std::scoped_lock lock(_queueMutex);
+		_numberOfShotsBeingWritten--;
+	}
+}
+
+
+bool ScreenshotWriter::encodeShot(const ShotToSave& shot, uint32_t numberOfThreads, EncodedShot& encodedShot)
+{
+	std::vector<uint8_t>& encoded_data = encodedShot.data;
+	bool succeeded = false;
+
+	// The shot data is RGB as we packed the RGBA data as RGB as Alpha is 0 in the source. So we pass 3 as the comp
+	switch(_filetype)
+	{
+	case ScreenshotFiletype::Bmp:
+		encodedShot.filename = IGCS::Utils::formatString("%s%c%d.bmp", _destinationFolder.c_str(), IGCS::Platform::PATH_SEPARATOR, shot.frameNumber);
+		succeeded = stbi_write_bmp_to_func(appendToEncodedData, &encoded_data, shot.width, shot.height, 3, shot.data.data()) != 0;
+		break;
+	case ScreenshotFiletype::Jpeg:
+		encodedShot.filename = IGCS::Utils::formatString("%s%c%d.jpg", _destinationFolder.c_str(), IGCS::Platform::PATH_SEPARATOR, shot.frameNumber);
+		if(_useFastJpegEncoder)
+		{
+			// very large shots are split in bands which are encoded in parallel.
+			const uint32_t numberOfThreadsForBands = IGCS::ImageUtils::benefitsFromParallelEncoding(shot.width, shot.height) ? numberOfThreads : 1;
+			succeeded = IGCS::FastJpegEncoder::encodeImageToMemory(shot.data.data(), shot.width, shot.height, 98, encoded_data, numberOfThreadsForBands);
+		}
+		else
+		{
+			succeeded = stbi_write_jpg_to_func(appendToEncodedData, &encoded_data, shot.width, shot.height, 3, shot.data.data(), 98) != 0;
+		}
+		break;
+	case ScreenshotFiletype::Png:
+		encodedShot.filename = IGCS::Utils::formatString("%s%c%d.png", _destinationFolder.c_str(), IGCS::Platform::PATH_SEPARATOR, shot.frameNumber);
+		// 3 bytes per pixel!
+		if(numberOfThreads > 1 && IGCS::ImageUtils::benefitsFromParallelEncoding(shot.width, shot.height))
+		{
+			// very large shot and idle workers, fpng would encode it on this thread alone.
+			succeeded = IGCS::StripedPngEncoder::encodeImageToMemory(shot.data.data(), shot.width, shot.height, 3, encoded_data, numberOfThreads);
+		}
+		else
+		{
+			succeeded = fpng::fpng_encode_image_to_memory(shot.data.data(), shot.width, shot.height, 3, encoded_data);
+		}
+		break;
+	}
+	return succeeded;
+}
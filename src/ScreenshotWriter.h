@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConstantsEnums.h"
+#include "FrameBufferPool.h"
+
+
+/// <summary>
+/// Encodes and writes grabbed shots to disk using a pool of worker threads. Shots are handed to the writer as soon as they're grabbed so they're
+/// encoded in parallel while the screenshot session is still running. The encoders encode to memory, a dedicated thread writes the encoded shots
+/// to disk so the disk I/O overlaps the encoding of the next shots.
+/// </summary>
+/// <remarks>The number of encoded shots waiting to be written is capped: if the disk can't keep up, the encoders wait for room before they pick up
+/// the next shot, so the shots stay in their frame buffers, whose memory is budgeted, instead of piling up encoded in memory.</remarks>
+class ScreenshotWriter
+{
+	struct ShotToSave
+	{
+		FrameBuffer data;		// RGB data, 3 bytes per pixel
+		uint32_t width = 0;
+		uint32_t height = 0;
+		int frameNumber = 0;
+	};
+
+	struct EncodedShot
+	{
+		std::string filename;
+		std::vector<uint8_t> data;		// file contents
+	};
+
+public:
+	ScreenshotWriter() = default;
+	~ScreenshotWriter();
+
+	/// <summary>
+	/// Starts the worker threads. Shots added after this call are written to the destination folder specified using the filetype specified.
+	/// </summary>
+	/// <param name="destinationFolder"></param>
+	/// <param name="filetype"></param>
+	/// <param name="useFastJpegEncoder">if true, jpg files are encoded with the FastJpegEncoder if the cpu supports it, otherwise with stb</param>
+	void start(const std::string& destinationFolder, ScreenshotFiletype filetype, bool useFastJpegEncoder);
+	/// <summary>
+	/// Queues the shot specified for encoding. The data has to be RGB data, 3 bytes per pixel. Returns immediately. The buffer is returned to its pool
+	/// once the shot has been encoded.
+	/// </summary>
+	void addShot(FrameBuffer shotData, uint32_t width, uint32_t height, int frameNumber);
+	/// <summary>
+	/// Waits till all queued shots have been written and stops the worker threads. 
+	/// </summary>
+	void waitForCompletion();
+	/// <summary>
+	/// Discards all queued shots and encoded shots which aren't being written yet. Shots which are being encoded or written are completed. Call 
+	/// waitForCompletion afterwards to wait for the worker threads to end. 
+	/// </summary>
+	void cancel();
+	/// <summary>
+	/// Returns the number of shots which are queued, are being encoded or are waiting to be written.
+	/// </summary>
+	int numberOfShotsToWrite();
+
+private:
+	void processShots();
+	void writeEncodedShots();
+	/// <summary>
+	/// Encodes the shot specified into the file contents for the filetype set. Very large shots are encoded by numberOfThreads threads, the calling 
+	///	thread included. Returns false if the shot couldn't be encoded.
+	/// </summary>
+	bool encodeShot(const ShotToSave& shot, uint32_t numberOfThreads, EncodedShot& encodedShot);
+
+	std::string _destinationFolder;
+	ScreenshotFiletype _filetype = ScreenshotFiletype::Jpeg;
+	bool _useFastJpegEncoder = true;
+	std::vector<std::thread> _workers;
+	uint32_t _numberOfWorkers = 1;
+	std::thread _fileWriter;
+	std::deque<ShotToSave> _shotsToSave;
+	std::deque<EncodedShot> _encodedShotsToWrite;
+	int _numberOfShotsInProgress = 0;			// shots being encoded
+	int _numberOfShotsBeingWritten = 0;
+	size_t _maximumNumberOfEncodedShotsToWrite = 1;		// encoders wait till there are fewer encoded shots waiting to be written than this.
+	bool _stopRequested = false;
+	bool _encodingCompleted = false;			// if true, the file writer stops when there are no more encoded shots to write.
+
+	std::mutex _queueMutex;
+	std::condition_variable _shotAvailableHandle;
+	std::condition_variable _encodedShotAvailableHandle;
+	std::condition_variable _roomForEncodedShotHandle;
+};
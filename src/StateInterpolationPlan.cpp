@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "StateInterpolationPlan.h"
+#include <cmath>
+#include "LerpUtils.h"
+
+
+static bool areEqual(const DirectX::XMFLOAT4& a, const DirectX::XMFLOAT4& b)
+{
+	return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+}
+
+
+void StateInterpolationPlan::addUniform(uint64_t variableId, const DirectX::XMFLOAT4& startValue, const DirectX::XMFLOAT4& endValue)
+{
+	if(variableId == 0)
+	{
+		return;
+	}
+	if(areEqual(startValue, endValue))
+	{
+		_constantVariableIds.push_back(variableId);
+		_constantValues.push_back(startValue);
+		return;
+	}
+	addInterpolatedUniform(variableId, startValue, DirectX::XMFLOAT4(endValue.x - startValue.x, endValue.y - startValue.y, endValue.z - startValue.z, endValue.w - startValue.w),
+						   DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f), DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f));
+}
+
+
+void StateInterpolationPlan::addUniform(uint64_t variableId, const DirectX::XMFLOAT4& previousValue, const DirectX::XMFLOAT4& startValue, const DirectX::XMFLOAT4& endValue, 
+										const DirectX::XMFLOAT4& nextValue)
+{
+	if(variableId == 0)
+	{
+		return;
+	}
+	if(areEqual(startValue, endValue) && areEqual(previousValue, startValue) && areEqual(endValue, nextValue))
+	{
+		_constantVariableIds.push_back(variableId);
+		_constantValues.push_back(startValue);
+		return;
+	}
+	// uniform Catmull-Rom with p0..p3 = previous, start, end, next:
+	// a = p1, b = (p2 - p0) / 2, c = p0 - 2.5p1 + 2p2 - 0.5p3, d = (-p0 + 3p1 - 3p2 + p3) / 2
+	const auto coefficients = [](float p0, float p1, float p2, float p3, float& b, float& c, float& d)
+	{
+		b = 0.5f * (p2 - p0);
+		c = p0 - (2.5f * p1) + (2.0f * p2) - (0.5f * p3);
+		d = 0.5f * (-p0 + (3.0f * p1) - (3.0f * p2) + p3);
+	};
+	DirectX::XMFLOAT4 b, c, d;
+	coefficients(previousValue.x, startValue.x, endValue.x, nextValue.x, b.x, c.x, d.x);
+	coefficients(previousValue.y, startValue.y, endValue.y, nextValue.y, b.y, c.y, d.y);
+	coefficients(previousValue.z, startValue.z, endValue.z, nextValue.z, b.z, c.z, d.z);
+	coefficients(previousValue.w, startValue.w, endValue.w, nextValue.w, b.w, c.w, d.w);
+	addInterpolatedUniform(variableId, startValue, b, c, d);
+}
+
+
+void StateInterpolationPlan::addInterpolatedUniform(uint64_t variableId, const DirectX::XMFLOAT4& a, const DirectX::XMFLOAT4& b, const DirectX::XMFLOAT4& c, const DirectX::XMFLOAT4& d)
+{
+	const DirectX::XMFLOAT4 zero(0.0f, 0.0f, 0.0f, 0.0f);
+	_isCubic |= !areEqual(c, zero) || !areEqual(d, zero);
+	_interpolatedVariableIds.push_back(variableId);
+	_startValues.push_back(a);
+	_deltaValues.push_back(b);
+	_quadraticCoefficients.push_back(c);
+	_cubicCoefficients.push_back(d);
+	_interpolatedValues.push_back(a);
+	_lastWrittenValues.push_back(a);
+}
+
+
+void StateInterpolationPlan::addTechnique(uint64_t techniqueId, bool isEnabled)
+{
+	_techniquesToSet.push_back({ techniqueId, isEnabled });
+}
+
+
+void StateInterpolationPlan::apply(reshade::api::effect_runtime* runtime, float interpolationFactor, bool applyConstantState, float writeEpsilon)
+{
+	// interpolate all uniforms in one go. An XMFLOAT4 is 4 consecutive floats, so the arrays are passed as flat float arrays.
+	const size_t numberOfInterpolatedUniforms = _interpolatedVariableIds.size();
+	const float* interpolatedValues = reinterpret_cast<const float*>(_interpolatedValues.data());
+	if(_isCubic)
+	{
+		IGCS::LerpUtils::evaluateCubicFloats(reinterpret_cast<const float*>(_startValues.data()), reinterpret_cast<const float*>(_deltaValues.data()), 
+											 reinterpret_cast<const float*>(_quadraticCoefficients.data()), reinterpret_cast<const float*>(_cubicCoefficients.data()), 
+											 interpolationFactor, reinterpret_cast<float*>(_interpolatedValues.data()), numberOfInterpolatedUniforms * 4);
+	}
+	else
+	{
+		IGCS::LerpUtils::lerpFloats(reinterpret_cast<const float*>(_startValues.data()), reinterpret_cast<const float*>(_deltaValues.data()), interpolationFactor, 
+									reinterpret_cast<float*>(_interpolatedValues.data()), numberOfInterpolatedUniforms * 4);
+	}
+	_numberOfRuntimeCallsMade = 0;
+	_numberOfRuntimeCallsSkipped = 0;
+	for(size_t i = 0; i < numberOfInterpolatedUniforms; i++)
+	{
+		const DirectX::XMFLOAT4& newValue = _interpolatedValues[i];
+		DirectX::XMFLOAT4& lastWrittenValue = _lastWrittenValues[i];
+		// if the segment just became active, reshade might contain anything, so we can't rely on what we've written before.
+		if(!applyConstantState && fabsf(newValue.x - lastWrittenValue.x) <= writeEpsilon && fabsf(newValue.y - lastWrittenValue.y) <= writeEpsilon &&
+		   fabsf(newValue.z - lastWrittenValue.z) <= writeEpsilon && fabsf(newValue.w - lastWrittenValue.w) <= writeEpsilon)
+		{
+			_numberOfRuntimeCallsSkipped++;
+			continue;
+		}
+		runtime->set_uniform_value_float(reshade::api::effect_uniform_variable(_interpolatedVariableIds[i]), interpolatedValues + i * 4, 4);
+		lastWrittenValue = newValue;
+		_numberOfRuntimeCallsMade++;
+	}
+
+	if(!applyConstantState)
+	{
+		_numberOfRuntimeCallsSkipped += _constantVariableIds.size() + _techniquesToSet.size();
+		return;
+	}
+	for(size_t i = 0; i < _constantVariableIds.size(); i++)
+	{
+		runtime->set_uniform_value_float(reshade::api::effect_uniform_variable(_constantVariableIds[i]), &_constantValues[i].x, 4);
+	}
+	for(const auto& techniqueToSet : _techniquesToSet)
+	{
+		runtime->set_technique_state(reshade::api::effect_technique(techniqueToSet.techniqueId), techniqueToSet.isEnabled);
+	}
+	_numberOfRuntimeCallsMade += _constantVariableIds.size() + _techniquesToSet.size();
+}
+
+
+void StateInterpolationPlan::clear()
+{
+	_interpolatedVariableIds.clear();
+	_startValues.clear();
+	_deltaValues.clear();
+	_quadraticCoefficients.clear();
+	_cubicCoefficients.clear();
+	_isCubic = false;
+	_interpolatedValues.clear();
+	_lastWrittenValues.clear();
+	_constantVariableIds.clear();
+	_constantValues.clear();
+	_techniquesToSet.clear();
+	_numberOfRuntimeCallsMade = 0;
+	_numberOfRuntimeCallsSkipped = 0;
+}
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <DirectXMath.h>
+#include <reshade.hpp>
+#include <vector>
+
+/// <summary>
+/// The precompiled interpolation between two reshade state snapshots. Matching effects, uniforms and techniques on name is done once when the plan is
+/// compiled, so applying it for an interpolation factor is a single lerp over packed arrays, followed by setting the values in reshade.
+/// Uniforms which have the same value in both snapshots, and the technique states, don't change with the interpolation factor, so they're only set
+/// when asked for, e.g. when the plan becomes active. Of the interpolated uniforms, the last written values are kept, so a uniform is only set again
+/// if its value changed.
+/// </summary>
+class StateInterpolationPlan
+{
+public:
+	/// <summary>
+	/// Adds a float uniform to the plan. If start and end value are equal, it's added as a constant uniform.
+	/// </summary>
+	void addUniform(uint64_t variableId, const DirectX::XMFLOAT4& startValue, const DirectX::XMFLOAT4& endValue);
+	/// <summary>
+	/// Adds a float uniform which is interpolated using a Catmull-Rom spline from startValue to endValue, through the values of the states before and after the segment.
+	/// The coefficients of the spline segment are calculated here, so applying the plan is a single polynomial evaluation per uniform. If the uniform has the same
+	/// value in all 4 states, it's added as a constant uniform.
+	/// </summary>
+	void addUniform(uint64_t variableId, const DirectX::XMFLOAT4& previousValue, const DirectX::XMFLOAT4& startValue, const DirectX::XMFLOAT4& endValue, const DirectX::XMFLOAT4& nextValue);
+	void addTechnique(uint64_t techniqueId, bool isEnabled);
+	/// <summary>
+	/// Sets the interpolated uniforms to their value for the interpolation factor specified. If applyConstantState is true, the constant uniforms
+	/// and the technique states are set as well, as are all interpolated uniforms. Otherwise an interpolated uniform is only set if one of its components
+	/// differs more than writeEpsilon from the value written last.
+	/// </summary>
+	void apply(reshade::api::effect_runtime* runtime, float interpolationFactor, bool applyConstantState, float writeEpsilon = 0.0f);
+	void clear();
+
+	int numberOfInterpolatedUniforms() const { return _interpolatedVariableIds.size(); }
+	int numberOfConstantUniforms() const { return _constantVariableIds.size(); }
+	/// <summary>
+	/// The number of set_uniform_value_float and set_technique_state calls made by the last apply.
+	/// </summary>
+	int numberOfRuntimeCallsMade() const { return _numberOfRuntimeCallsMade; }
+	/// <summary>
+	/// The number of set_uniform_value_float and set_technique_state calls the last apply didn't have to make, compared to setting everything.
+	/// </summary>
+	int numberOfRuntimeCallsSkipped() const { return _numberOfRuntimeCallsSkipped; }
+
+private:
+	struct TechniqueToSet
+	{
+		uint64_t techniqueId;
+		bool isEnabled;
+	};
+
+	void addInterpolatedUniform(uint64_t variableId, const DirectX::XMFLOAT4& a, const DirectX::XMFLOAT4& b, const DirectX::XMFLOAT4& c, const DirectX::XMFLOAT4& d);
+
+	// parallel arrays, per interpolated uniform: id and the coefficients of value(t) = a + bt + ct^2 + dt^3. For a lerp a is the start value, b is end - start and
+	// c and d are 0.
+	std::vector<uint64_t> _interpolatedVariableIds;
+	std::vector<DirectX::XMFLOAT4> _startValues;				// a
+	std::vector<DirectX::XMFLOAT4> _deltaValues;				// b
+	std::vector<DirectX::XMFLOAT4> _quadraticCoefficients;		// c
+	std::vector<DirectX::XMFLOAT4> _cubicCoefficients;			// d
+	bool _isCubic = false;										// true if a uniform has been added with a non-zero c or d, otherwise a lerp suffices.
+	std::vector<DirectX::XMFLOAT4> _interpolatedValues;		// receives the values of the last apply, sized at compile time so apply doesn't allocate.
+	std::vector<DirectX::XMFLOAT4> _lastWrittenValues;		// the values last set in reshade.
+	// parallel arrays, per constant uniform: id and value.
+	std::vector<uint64_t> _constantVariableIds;
+	std::vector<DirectX::XMFLOAT4> _constantValues;
+	std::vector<TechniqueToSet> _techniquesToSet;
+	int _numberOfRuntimeCallsMade = 0;
+	int _numberOfRuntimeCallsSkipped = 0;
+};
@@ -0,0 +1,200 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "stdafx.h"
+#include "StripedPngEncoder.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include "fpng.h"
+
+namespace IGCS::StripedPngEncoder
+{
+	// Stripes smaller than this don't pay off the thread start and the per stripe overhead.
+	static const uint32_t MIN_NUMBER_OF_ROWS_PER_STRIPE = 64;
+	static const uint8_t IDAT_CHUNK_TYPE[4] = { 'I', 'D', 'A', 'T' };
+	// zlib header: deflate, 32KB window, no preset dictionary, fastest compression.
+	static const uint8_t ZLIB_HEADER[2] = { 0x78, 0x01 };
+
+	struct EncodedStripe
+	{
+		std::vector<uint8_t> deflatedData;
+		uint32_t adler32 = 0;
+		uint32_t crc32 = 0;			// crc of the IDAT chunk type and data, except the zlib trailer.
+		uint32_t numberOfBytes = 0;	// the number of filtered bytes in the stripe.
+		bool succeeded = false;
+	};
+
+
+	static void appendBigEndian(std::vector<uint8_t>& destination, uint32_t value)
+	{
+		destination.push_back((uint8_t)(value >> 24));
+		destination.push_back((uint8_t)(value >> 16));
+		destination.push_back((uint8_t)(value >> 8));
+		destination.push_back((uint8_t)value);
+	}
+
+
+	static void appendBytes(std::vector<uint8_t>& destination, const uint8_t* source, size_t numberOfBytes)
+	{
+		destination.insert(destination.end(), source, source + numberOfBytes);
+	}
+
+
+	static EncodedStripe encodeStripe(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t numberOfChannels, uint32_t firstRow, uint32_t numberOfRows)
+	{
+		EncodedStripe toReturn;
+		toReturn.succeeded = fpng::fpng_deflate_image_stripe(pixels, width, height, numberOfChannels, firstRow, numberOfRows, toReturn.deflatedData, toReturn.adler32);
+		if(!toReturn.succeeded)
+		{
+			return toReturn;
+		}
+		toReturn.numberOfBytes = (1 + width * numberOfChannels) * numberOfRows;
+		toReturn.crc32 = fpng::fpng_crc32(IDAT_CHUNK_TYPE, sizeof(IDAT_CHUNK_TYPE));
+		if(0 == firstRow)
+		{
+			// the zlib header is written at the start of the first IDAT chunk.
+			toReturn.crc32 = fpng::fpng_crc32(ZLIB_HEADER, sizeof(ZLIB_HEADER), toReturn.crc32);
+		}
+		toReturn.crc32 = fpng::fpng_crc32(toReturn.deflatedData.data(), toReturn.deflatedData.size(), toReturn.crc32);
+		return toReturn;
+	}
+
+
+	bool encodeImageToMemory(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t numberOfChannels, std::vector<uint8_t>& encodedData, 
+							 uint32_t numberOfThreads, uint32_t numberOfStripes)
+	{
+		if(nullptr == pixels || 0 == width || 0 == height || (numberOfChannels != 3 && numberOfChannels != 4))
+		{
+			return false;
+		}
+		if(0 == numberOfThreads)
+		{
+			numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		if(0 == numberOfStripes)
+		{
+			numberOfStripes = numberOfThreads;
+		}
+		const uint32_t maxNumberOfStripes = std::max(1u, height / MIN_NUMBER_OF_ROWS_PER_STRIPE);
+		numberOfStripes = std::clamp(numberOfStripes, 1u, maxNumberOfStripes);
+		const uint32_t rowsPerStripe = (height + numberOfStripes - 1) / numberOfStripes;
+		// the last stripes can end up empty if the rows don't divide evenly, so they're dropped.
+		numberOfStripes = (height + rowsPerStripe - 1) / rowsPerStripe;
+
+		// the threads take the next stripe to encode till all stripes are taken. The calling thread is one of them.
+		std::vector<EncodedStripe> stripes(numberOfStripes);
+		std::atomic<uint32_t> nextStripeIndex = 0;
+		const auto encodeStripes = [&]()
+		{
+			for(uint32_t stripeIndex = nextStripeIndex++; stripeIndex < numberOfStripes; stripeIndex = nextStripeIndex++)
+			{
+				const uint32_t firstRow = stripeIndex * rowsPerStripe;
+				stripes[stripeIndex] = encodeStripe(pixels, width, height, numberOfChannels, firstRow, std::min(rowsPerStripe, height - firstRow));
+			}
+		};
+		std::vector<std::future<void>> workers;
+		for(uint32_t i = 1; i < std::min(numberOfThreads, numberOfStripes); i++)
+		{
+			workers.push_back(std::async(std::launch::async, encodeStripes));
+		}
+		encodeStripes();
+		for(auto& worker : workers)
+		{
+			worker.get();
+		}
+		size_t totalDeflatedSize = 0;
+		for(const auto& stripe : stripes)
+		{
+			if(!stripe.succeeded)
+			{
+				return false;
+			}
+			totalDeflatedSize += stripe.deflatedData.size();
+		}
+
+		// signature, IHDR, per stripe an IDAT chunk with its header and crc, zlib header + trailer and IEND.
+		encodedData.clear();
+		encodedData.reserve(8 + 25 + stripes.size() * 12 + 6 + 12 + totalDeflatedSize);
+
+		static const uint8_t pngSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+		static const uint8_t colorTypePerNumberOfChannels[5] = { 0, 0, 4, 2, 6 };
+		appendBytes(encodedData, pngSignature, sizeof(pngSignature));
+
+		// IHDR. 8 bits per channel, deflate, adaptive filtering, not interlaced.
+		const uint8_t ihdr[17] = { 'I', 'H', 'D', 'R', 
+								   (uint8_t)(width >> 24), (uint8_t)(width >> 16), (uint8_t)(width >> 8), (uint8_t)width,
+								   (uint8_t)(height >> 24), (uint8_t)(height >> 16), (uint8_t)(height >> 8), (uint8_t)height,
+								   8, colorTypePerNumberOfChannels[numberOfChannels], 0, 0, 0 };
+		appendBigEndian(encodedData, 13);
+		appendBytes(encodedData, ihdr, sizeof(ihdr));
+		appendBigEndian(encodedData, fpng::fpng_crc32(ihdr, sizeof(ihdr)));
+
+		uint32_t adler32 = fpng::FPNG_ADLER32_INIT;
+		for(size_t i = 0; i < stripes.size(); i++)
+		{
+			const EncodedStripe& stripe = stripes[i];
+			const bool isFirstStripe = (i == 0);
+			const bool isLastStripe = (i == stripes.size() - 1);
+			adler32 = fpng::fpng_adler32_combine(adler32, stripe.adler32, stripe.numberOfBytes);
+
+			const size_t chunkLength = stripe.deflatedData.size() + (isFirstStripe ? sizeof(ZLIB_HEADER) : 0) + (isLastStripe ? 4 : 0);
+			if(chunkLength > INT32_MAX)
+			{
+				// png chunks are limited to 2^31-1 bytes.
+				return false;
+			}
+			appendBigEndian(encodedData, (uint32_t)chunkLength);
+			appendBytes(encodedData, IDAT_CHUNK_TYPE, sizeof(IDAT_CHUNK_TYPE));
+			if(isFirstStripe)
+			{
+				appendBytes(encodedData, ZLIB_HEADER, sizeof(ZLIB_HEADER));
+			}
+			appendBytes(encodedData, stripe.deflatedData.data(), stripe.deflatedData.size());
+			uint32_t chunkCrc32 = stripe.crc32;
+			if(isLastStripe)
+			{
+				// zlib trailer, which is the adler32 of all stripes combined.
+				const uint8_t zlibTrailer[4] = { (uint8_t)(adler32 >> 24), (uint8_t)(adler32 >> 16), (uint8_t)(adler32 >> 8), (uint8_t)adler32 };
+				appendBytes(encodedData, zlibTrailer, sizeof(zlibTrailer));
+				chunkCrc32 = fpng::fpng_crc32(zlibTrailer, sizeof(zlibTrailer), chunkCrc32);
+			}
+			appendBigEndian(encodedData, chunkCrc32);
+		}
+
+		static const uint8_t iend[12] = { 0, 0, 0, 0, 'I', 'E', 'N', 'D', 0xAE, 0x42, 0x60, 0x82 };
+		appendBytes(encodedData, iend, sizeof(iend));
+		return true;
+	}
+}
@@ -0,0 +1,54 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace IGCS::StripedPngEncoder
+{
+	/// <summary>
+	/// Encodes the image specified as PNG. The image is split into horizontal stripes which are deflated in parallel by the number of threads specified.
+	/// Each stripe is written as its own IDAT chunk, the stripes together form a single zlib stream.
+	/// </summary>
+	/// <param name="pixels">width * height * numberOfChannels bytes, no padding between rows</param>
+	/// <param name="width"></param>
+	/// <param name="height"></param>
+	/// <param name="numberOfChannels">3 (RGB) or 4 (RGBA)</param>
+	/// <param name="encodedData">receives the png file contents</param>
+	/// <param name="numberOfThreads">the number of threads which deflate the stripes, the calling thread included. If 0, the number of cores is used. 
+	/// Callers which already encode several images in parallel should pass the number of cores they can spare</param>
+	/// <param name="numberOfStripes">the number of stripes to use. If 0, one per thread is used</param>
+	/// <returns>true if the encoding succeeded, false otherwise</returns>
+	bool encodeImageToMemory(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t numberOfChannels, std::vector<uint8_t>& encodedData, 
+							 uint32_t numberOfThreads = 0, uint32_t numberOfStripes = 0);
+}
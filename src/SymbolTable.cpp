@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#include "SymbolTable.h"
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace IGCS::SymbolTable
+{
+	static std::mutex g_symbolTableMutex;
+	static std::deque<std::string> g_namePerSymbol;						// a deque so references to the names stay valid when the table grows.
+	static std::unordered_map<std::string, Symbol> g_symbolPerName;
+
+
+	Symbol intern(const std::string& name)
+	{
+		std::scoped_lock lock(g_symbolTableMutex);
+		const auto it = g_symbolPerName.find(name);
+		if(it != g_symbolPerName.end())
+		{
+			return it->second;
+		}
+		const Symbol toReturn = (Symbol)g_namePerSymbol.size();
+		g_namePerSymbol.push_back(name);
+		g_symbolPerName.emplace(name, toReturn);
+		return toReturn;
+	}
+
+
+	Symbol find(const std::string& name)
+	{
+		std::scoped_lock lock(g_symbolTableMutex);
+		const auto it = g_symbolPerName.find(name);
+		return it == g_symbolPerName.end() ? INVALID_SYMBOL : it->second;
+	}
+
+
+	const std::string& nameOf(Symbol symbol)
+	{
+		static const std::string unknownName;
+		std::scoped_lock lock(g_symbolTableMutex);
+		return symbol < g_namePerSymbol.size() ? g_namePerSymbol[symbol] : unknownName;
+	}
+}
@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// Process wide table of interned names (effects, uniforms, techniques). Snapshots store the symbol of a name instead of the name itself, so a name is
+/// stored once no matter how many snapshots refer to it, and comparing names is comparing integers. Symbols are only valid during the current process.
+/// </summary>
+namespace IGCS::SymbolTable
+{
+	typedef uint32_t Symbol;
+	static const Symbol INVALID_SYMBOL = UINT32_MAX;
+
+	/// <summary>
+	/// Returns the symbol for the name specified. If the name isn't known yet, it's added.
+	/// </summary>
+	Symbol intern(const std::string& name);
+	/// <summary>
+	/// Returns the symbol for the name specified, or INVALID_SYMBOL if the name was never interned. Use this for lookups so they don't grow the table.
+	/// </summary>
+	Symbol find(const std::string& name);
+	/// <summary>
+	/// Returns the name of the symbol specified. The reference stays valid for the lifetime of the process.
+	/// </summary>
+	const std::string& nameOf(Symbol symbol);
+}
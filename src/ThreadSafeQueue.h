@@ -1,63 +1,134 @@
 ﻿#pragma once
-#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <optional>
-#include <queue>
+#include <utility>
 
 namespace IGCS
 {
     /// <summary>
-    /// Thread safe queue. To check if the queue is empty, call pop() and check if the value is empty.
-    /// From: https://codetrips.com/2020/07/26/modern-c-writing-a-thread-safe-queue/
+    /// Bounded lock-free multi producer, single consumer queue. Any thread can push, only one thread may pop or drain. To check if the queue is empty,
+    /// call pop() and check if the value is empty.
+    /// Based on Dmitry Vyukov's bounded MPMC queue: every slot has a sequence number which tells whether it's free for the producer which claimed it or 
+    /// filled for the consumer, so producers only contend on claiming a slot and never block the consumer, and the consumer never blocks producers.
+    /// Pushing and popping don't allocate. This queue is used for work that's performed every frame, e.g. camera path playback.
+    /// Pushing never waits: when the queue is full, tryPush fails and the producer decides what to do with the item. Waiting for room could deadlock,
+    /// as the consumer thread queues work too.
     /// </summary>
     /// <typeparam name="T"></typeparam>
-    template<typename T>
+    /// <typeparam name="Capacity">the maximum number of elements in the queue. Has to be a power of 2.</typeparam>
+    template<typename T, size_t Capacity = 1024>
     class ThreadSafeQueue
     {
-    public:
-        ThreadSafeQueue() = default;
-        ThreadSafeQueue(const ThreadSafeQueue<T>&) = delete;
-        ThreadSafeQueue& operator=(const ThreadSafeQueue<T>&) = delete;
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of 2");
 
-        ThreadSafeQueue(ThreadSafeQueue<T>&& other) noexcept
+    public:
+        ThreadSafeQueue()
         {
-            std::scoped_lock lock(mutex_);
-            queue_ = std::move(other.queue_);
+            for(size_t i = 0; i < Capacity; i++)
+            {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
         }
 
-        virtual ~ThreadSafeQueue() { }
+        ThreadSafeQueue(const ThreadSafeQueue<T, Capacity>&) = delete;
+        ThreadSafeQueue& operator=(const ThreadSafeQueue<T, Capacity>&) = delete;
 
-        unsigned long size() const
-        {
-            std::scoped_lock lock(mutex_);
-            return queue_.size();
-        }
+        virtual ~ThreadSafeQueue() { }
 
+        /// <summary>
+        /// Removes the oldest element and returns it. Returns an empty optional if there's no element. Only call from the consumer thread.
+        /// </summary>
         std::optional<T> pop()
         {
-            std::scoped_lock lock(mutex_);
-            if(queue_.empty())
+            Slot& slot = slots_[popPosition_ & (Capacity - 1)];
+            if(slot.sequence.load(std::memory_order_acquire) != popPosition_ + 1)
             {
+                // empty, or the producer which claimed this slot hasn't filled it yet.
                 return {};
             }
-            T tmp = queue_.front();
-            queue_.pop();
+            std::optional<T> tmp = std::move(slot.value);
+            slot.value.reset();
+            // hand the slot back to the producers, for the push one lap further.
+            slot.sequence.store(popPosition_ + Capacity, std::memory_order_release);
+            popPosition_++;
             return tmp;
         }
 
-        void push(const T& item)
+        /// <summary>
+        /// Pops elements and passes them to elementFunc in the order they were pushed, till the queue is empty or maximumNumberOfElements have been
+        /// passed. Elements pushed while draining are passed too. Only call from the consumer thread. Returns the number of elements drained, so if
+        /// that's less than maximumNumberOfElements, the queue was empty.
+        /// </summary>
+        template<typename TFunc>
+        size_t drain(TFunc&& elementFunc, size_t maximumNumberOfElements = SIZE_MAX)
         {
-            std::scoped_lock lock(mutex_);
-            queue_.push(item);
+            size_t numberOfElementsDrained = 0;
+            for(; numberOfElementsDrained < maximumNumberOfElements; numberOfElementsDrained++)
+            {
+                std::optional<T> element = pop();
+                if(!element.has_value())
+                {
+                    break;
+                }
+                elementFunc(std::move(*element));
+            }
+            return numberOfElementsDrained;
         }
 
-    private:
-        std::queue<T> queue_;
-        mutable std::mutex mutex_;
+        /// <summary>
+        /// Adds the item to the queue. Returns false if the queue is full.
+        /// </summary>
+        bool tryPush(T&& item)
+        {
+            size_t position = pushPosition_.load(std::memory_order_relaxed);
+            Slot* slot = nullptr;
+            for(;;)
+            {
+                slot = &slots_[position & (Capacity - 1)];
+                const intptr_t difference = (intptr_t)slot->sequence.load(std::memory_order_acquire) - (intptr_t)position;
+                if(difference == 0)
+                {
+                    // the slot is free for this position, claim it.
+                    if(pushPosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if(difference < 0)
+                {
+                    // the consumer hasn't consumed the element pushed one lap earlier.
+                    return false;
+                }
+                else
+                {
+                    // another producer claimed it first.
+                    position = pushPosition_.load(std::memory_order_relaxed);
+                }
+            }
+            slot->value.emplace(std::move(item));
+            slot->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
 
-        // Moved out of public interface to prevent races between this and pop().
-        bool empty() const
+        bool tryPush(const T& item)
         {
-            return queue_.empty();
+            T copy = item;
+            return tryPush(std::move(copy));
         }
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            std::optional<T> value;
+        };
+
+        Slot slots_[Capacity];
+        // the producers and the consumer each get their own cache line for their position, so they don't invalidate each other's.
+        alignas(64) std::atomic<size_t> pushPosition_ = 0;
+        alignas(64) size_t popPosition_ = 0;        // only touched by the consumer
     };
-}
\ No newline at end of file
+}
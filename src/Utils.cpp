@@ -27,7 +27,10 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "stdafx.h"
 #include "Utils.h"
+#include "Platform.h"
+#ifdef _WIN32
 #include <comdef.h>
+#endif
 #include <codecvt>
 #include <reshade.hpp>
 
@@ -67,10 +70,15 @@ namespace IGCS::Utils
 		va_list args_copy;
 		va_copy(args_copy, args);
 
-		int len = vsnprintf(NULL, 0, fmt, args_copy);
-		char* buffer = new char[len + 2];
-		vsnprintf(buffer, len + 1, fmt, args_copy);
-		string toReturn(buffer, len + 1);
+		// the copy is consumed by measuring, so args is still intact for the actual formatting.
+		const int len = vsnprintf(NULL, 0, fmt, args_copy);
+		va_end(args_copy);
+		if(len < 0)
+		{
+			return "";
+		}
+		string toReturn(len, '\0');
+		vsnprintf(toReturn.data(), len + 1, fmt, args);
 		return toReturn;
 	}
 
@@ -89,4 +97,24 @@ namespace IGCS::Utils
 
 		reshade::log_message(logLevel, formattedString.c_str());
 	}
+
+
+	string pathInReshadeBaseFolder(const string& filename)
+	{
+		size_t pathSize = 0;
+		reshade::get_reshade_base_path(nullptr, &pathSize);
+		if(pathSize <= 1)
+		{
+			return filename;
+		}
+		string basePath(pathSize, '\0');
+		reshade::get_reshade_base_path(basePath.data(), &pathSize);
+		// the size includes the terminating zero.
+		basePath.resize(strlen(basePath.c_str()));
+		if(!basePath.ends_with(IGCS::Platform::PATH_SEPARATOR))
+		{
+			basePath += IGCS::Platform::PATH_SEPARATOR;
+		}
+		return basePath + filename;
+	}
 }
\ No newline at end of file
@@ -36,6 +36,11 @@ namespace IGCS::Utils
 	std::string formatString(const char* fmt, ...);
 	std::string formatStringVa(const char* fmt, va_list args);
 	void logLineToReshade(const reshade::log_level logLevel, const char* fmt, ...);
+	/// <summary>
+	/// Returns the path of the file specified in the folder ReShade resolves relative paths against, which is the folder of ReShade's config file. 
+	/// Returns the filename as-is if ReShade doesn't return that folder.
+	/// </summary>
+	std::string pathInReshadeBaseFolder(const std::string& filename);
 
 	BYTE CharToByte(char c);
 	bool stringStartsWith(const char *a, const char *b);
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "stdafx.h"
+#include "WorkItem.h"
+#include <algorithm>
+
+
+size_t markSupersededWorkItems(const std::vector<WorkItem>& workItems, std::vector<bool>& isSuperseded, std::vector<uint64_t>& supersedingKeys)
+{
+	// walk backwards, so the keys of the work items which supersede earlier ones are known when those are reached.
+	isSuperseded.assign(workItems.size(), false);
+	supersedingKeys.clear();
+	size_t numberOfWorkItemsSuperseded = 0;
+	for(size_t i = workItems.size(); i > 0; i--)
+	{
+		const uint64_t coalescingKey = workItems[i - 1].coalescingKey();
+		if(coalescingKey == WorkItem::NO_COALESCING_KEY)
+		{
+			supersedingKeys.clear();
+			continue;
+		}
+		if(std::find(supersedingKeys.begin(), supersedingKeys.end(), coalescingKey) != supersedingKeys.end())
+		{
+			isSuperseded[i - 1] = true;
+			numberOfWorkItemsSuperseded++;
+			continue;
+		}
+		supersedingKeys.push_back(coalescingKey);
+	}
+	return numberOfWorkItemsSuperseded;
+}
+
+
+size_t performWorkItems(std::vector<WorkItem>& workItems, const std::vector<bool>& isSuperseded, reshade::api::effect_runtime* runtime, WorkBudget& budget)
+{
+	const auto frameWorkStart = std::chrono::steady_clock::now();
+	bool heavyWorkPerformed = false;
+	bool deferWork = false;
+	size_t numberOfWorkItemsDeferred = 0;
+	for(size_t i = 0; i < workItems.size(); i++)
+	{
+		if(isSuperseded[i])
+		{
+			// the work item superseding it comes later, so it's performed or deferred as well.
+			continue;
+		}
+		WorkItem& workItem = workItems[i];
+		const bool isHeavy = workItem.cost() == WorkItemCost::Heavy;
+		const auto workStart = std::chrono::steady_clock::now();
+		deferWork = deferWork || (isHeavy && heavyWorkPerformed && (workStart - frameWorkStart) + budget.averageHeavyWorkItemDuration >= budget.budgetPerFrame);
+		if(deferWork)
+		{
+			// keep it, in order, at the front for the next frame.
+			workItems[numberOfWorkItemsDeferred] = std::move(workItem);
+			numberOfWorkItemsDeferred++;
+			continue;
+		}
+		workItem.perform(runtime);
+		if(isHeavy)
+		{
+			heavyWorkPerformed = true;
+			// moving average, so a single outlier doesn't defer all heavy work for a while.
+			const auto heavyWorkDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - workStart);
+			budget.averageHeavyWorkItemDuration = (budget.averageHeavyWorkItemDuration * 7 + heavyWorkDuration) / 8;
+		}
+	}
+	workItems.erase(workItems.begin() + numberOfWorkItemsDeferred, workItems.end());
+	return numberOfWorkItemsDeferred;
+}
@@ -33,22 +33,167 @@
 
 #pragma once
 
-#include <functional>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <reshade.hpp>
+#include "ConstantsEnums.h"
 
+/// <summary>
+/// Work to perform on the present thread. Move only, and the callable is stored inline: a callable which doesn't fit in the inline storage doesn't compile,
+///	so creating, queueing and performing a work item never allocates.
+/// A work item with a coalescing key other than NO_COALESCING_KEY is superseded by a later work item with the same key, so it can be skipped if that one
+///	is performed after it without other work in between. Work items might be deferred to a later frame to keep the time spent per frame within budget, see
+///	performWorkItems.
+/// </summary>
 struct WorkItem
 {
 public:
-	WorkItem(std::function<void(reshade::api::effect_runtime* runtime)> workPerformer)
+	// room for the captures of the lambdas passed in, e.g. a path index, two state indices and an interpolation factor.
+	static constexpr size_t INLINE_STORAGE_SIZE = 48;
+	static constexpr uint64_t NO_COALESCING_KEY = 0;
+
+	template<typename TFunc> requires (!std::is_same_v<std::remove_cvref_t<TFunc>, WorkItem>)
+	WorkItem(TFunc&& workPerformer) : WorkItem(NO_COALESCING_KEY, std::forward<TFunc>(workPerformer))
+	{
+	}
+
+	template<typename TFunc>
+	WorkItem(WorkItemCost cost, TFunc&& workPerformer) : WorkItem(NO_COALESCING_KEY, std::forward<TFunc>(workPerformer))
+	{
+		_cost = cost;
+	}
+
+	template<typename TFunc>
+	WorkItem(uint64_t coalescingKey, TFunc&& workPerformer) : _coalescingKey(coalescingKey)
+	{
+		using TStored = std::remove_cvref_t<TFunc>;
+		static_assert(sizeof(TStored) <= INLINE_STORAGE_SIZE, "The work performer captures too much to be stored inline. Capture less or raise INLINE_STORAGE_SIZE");
+		static_assert(alignof(TStored) <= alignof(std::max_align_t), "The work performer's alignment is too strict to be stored inline");
+		static_assert(std::is_nothrow_move_constructible_v<TStored>, "The work performer has to be nothrow move constructible");
+		::new((void*)_storage) TStored(std::forward<TFunc>(workPerformer));
+		_operations = &OPERATIONS_FOR<TStored>;
+	}
+
+	WorkItem(WorkItem&& other) noexcept : _operations(other._operations), _coalescingKey(other._coalescingKey), _cost(other._cost)
+	{
+		if(nullptr != _operations)
+		{
+			_operations->moveTo(other._storage, _storage);
+			other._operations = nullptr;
+		}
+	}
+
+	WorkItem& operator=(WorkItem&& other) noexcept
+	{
+		if(this != &other)
+		{
+			reset();
+			_operations = other._operations;
+			_coalescingKey = other._coalescingKey;
+			_cost = other._cost;
+			if(nullptr != _operations)
+			{
+				_operations->moveTo(other._storage, _storage);
+				other._operations = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	WorkItem(const WorkItem&) = delete;
+	WorkItem& operator=(const WorkItem&) = delete;
+
+	~WorkItem()
 	{
-		_workPerformer = workPerformer;
+		reset();
 	}
 
 	void perform(reshade::api::effect_runtime* runtime)
 	{
-		_workPerformer(runtime);
+		if(nullptr != _operations)
+		{
+			_operations->invoke(_storage, runtime);
+		}
 	}
 
+	uint64_t coalescingKey() const { return _coalescingKey; }
+	WorkItemCost cost() const { return _cost; }
+
 private:
-	std::function<void(reshade::api::effect_runtime* runtime)> _workPerformer;
+	/// <summary>
+	/// What's needed to invoke, move and destroy the callable in the storage, without knowing its type.
+	/// </summary>
+	struct Operations
+	{
+		void (*invoke)(void* storage, reshade::api::effect_runtime* runtime);
+		// move constructs the callable in destination and destroys the one in source
+		void (*moveTo)(void* source, void* destination);
+		void (*destroy)(void* storage);
+	};
+
+	template<typename TStored>
+	static constexpr Operations OPERATIONS_FOR =
+	{
+		[](void* storage, reshade::api::effect_runtime* runtime) { (*static_cast<TStored*>(storage))(runtime); },
+		[](void* source, void* destination)
+		{
+			::new(destination) TStored(std::move(*static_cast<TStored*>(source)));
+			static_cast<TStored*>(source)->~TStored();
+		},
+		[](void* storage) { static_cast<TStored*>(storage)->~TStored(); }
+	};
+
+	void reset()
+	{
+		if(nullptr != _operations)
+		{
+			_operations->destroy(_storage);
+			_operations = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) unsigned char _storage[INLINE_STORAGE_SIZE];
+	const Operations* _operations = nullptr;
+	uint64_t _coalescingKey = NO_COALESCING_KEY;
+	WorkItemCost _cost = WorkItemCost::Light;
 };
+
+
+/// <summary>
+/// Marks the work items which are superseded: a work item is superseded if a later one with the same coalescing key follows it without a work item 
+/// without a coalescing key in between, e.g. an append snapshot, which might read the state set. Performing it would only be overwritten by the later one.
+/// </summary>
+/// <param name="workItems">the work items, in the order they're performed</param>
+/// <param name="isSuperseded">receives a flag per work item, true if it's superseded</param>
+/// <param name="supersedingKeys">scratch space, passed in so the caller can reserve it once and marking doesn't allocate</param>
+/// <returns>the number of work items marked as superseded</returns>
+size_t markSupersededWorkItems(const std::vector<WorkItem>& workItems, std::vector<bool>& isSuperseded, std::vector<uint64_t>& supersedingKeys);
+
+
+/// <summary>
+/// The time heavy work items can take per frame, and how long they took so far. Kept across frames.
+/// </summary>
+struct WorkBudget
+{
+	std::chrono::microseconds budgetPerFrame = std::chrono::microseconds(2000);
+	// moving average of the time a heavy work item takes, to predict whether the next one still fits in the budget.
+	std::chrono::microseconds averageHeavyWorkItemDuration = std::chrono::microseconds(0);
+};
+
+
+/// <summary>
+/// Performs the work items which aren't superseded in order, till the budget would be exceeded by the next heavy work item. That item and all work after it,
+/// light or heavy, is deferred to the next frame in the same order, as later work might depend on it: e.g. a state set after a snapshot capture was queued
+/// mustn't end up in the snapshot. At least one heavy work item is performed per call, so heavy work never starves.
+/// </summary>
+/// <param name="workItems">the work items to perform. Receives the deferred work items, in order</param>
+/// <param name="isSuperseded">a flag per work item, see markSupersededWorkItems. Superseded work items are neither performed nor deferred</param>
+/// <param name="runtime">the runtime to pass to the work items</param>
+/// <param name="budget">the budget to stay within, which is updated with the time the heavy work items took</param>
+/// <returns>the number of work items deferred</returns>
+size_t performWorkItems(std::vector<WorkItem>& workItems, const std::vector<bool>& isSuperseded, reshade::api::effect_runtime* runtime, WorkBudget& budget);
@@ -479,6 +479,22 @@ namespace fpng
 		return fpng_adler32_scalar(ptr, buf_len, adler);
 	}
 
+	// Same as zlib's adler32_combine().
+	uint32_t fpng_adler32_combine(uint32_t adler1, uint32_t adler2, size_t len2)
+	{
+		const uint32_t BASE = 65521U;
+		const uint32_t rem = (uint32_t)(len2 % BASE);
+		uint32_t sum1 = adler1 & 0xffff;
+		uint32_t sum2 = (uint32_t)(((uint64_t)rem * sum1) % BASE);
+		sum1 += (adler2 & 0xffff) + BASE - 1;
+		sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + BASE - rem;
+		if (sum1 >= BASE) sum1 -= BASE;
+		if (sum1 >= BASE) sum1 -= BASE;
+		if (sum2 >= (BASE << 1)) sum2 -= (BASE << 1);
+		if (sum2 >= BASE) sum2 -= BASE;
+		return sum1 | (sum2 << 16);
+	}
+
 	// Ensure we've been configured for endianness correctly.
 	static inline bool endian_check()
 	{
@@ -1079,16 +1095,21 @@ do { \
 		return dst_ofs;
 	}
 
+	// If raw_stripe is true, only the raw deflate block is written: no zlib header and no adler32. If final_stripe is false, the block isn't 
+	// marked as final and is followed by an empty stored block, so the output is byte aligned and can be concatenated with the next stripe.
 	static uint32_t pixel_deflate_dyn_3_rle_one_pass(
 		const uint8_t* pImg, uint32_t w, uint32_t h,
-		uint8_t* pDst, uint32_t dst_buf_size)
+		uint8_t* pDst, uint32_t dst_buf_size, bool raw_stripe = false, bool final_stripe = true)
 	{
 		const uint32_t bpl = 1 + w * 3;
 
-		if (dst_buf_size < sizeof(g_dyn_huff_3))
+		const uint32_t header_ofs = raw_stripe ? 2 : 0;
+		if (dst_buf_size < sizeof(g_dyn_huff_3) - header_ofs)
 			return false;
-		memcpy(pDst, g_dyn_huff_3, sizeof(g_dyn_huff_3));
-		uint32_t dst_ofs = sizeof(g_dyn_huff_3);
+		memcpy(pDst, g_dyn_huff_3 + header_ofs, sizeof(g_dyn_huff_3) - header_ofs);
+		uint32_t dst_ofs = sizeof(g_dyn_huff_3) - header_ofs;
+		if (!final_stripe)
+			pDst[2 - header_ofs] &= ~1; // clear BFINAL
 
 		uint64_t bit_buf = DYN_HUFF_3_BITBUF;
 		int bit_buf_size = DYN_HUFF_3_BITBUF_SIZE;
@@ -1096,7 +1117,7 @@ do { \
 		const uint8_t* pSrc = pImg;
 		uint32_t src_ofs = 0;
 
-		uint32_t src_adler32 = fpng_adler32(pImg, bpl * h, FPNG_ADLER32_INIT);
+		uint32_t src_adler32 = raw_stripe ? 0 : fpng_adler32(pImg, bpl * h, FPNG_ADLER32_INIT);
 
 		for (uint32_t y = 0; y < h; y++)
 		{
@@ -1167,8 +1188,23 @@ do { \
 
 		PUT_BITS_CZ(g_dyn_huff_3_codes[256].m_code, g_dyn_huff_3_codes[256].m_code_size);
 
+		if (!final_stripe)
+		{
+			// empty stored block (BFINAL 0, BTYPE 00, LEN 0, NLEN 0xFFFF) to byte align the stream
+			PUT_BITS(0, 3);
+			PUT_BITS_FORCE_FLUSH;
+			if ((dst_ofs + 4) > dst_buf_size)
+				return 0;
+			static const uint8_t s_empty_stored_block[4] = { 0x00, 0x00, 0xFF, 0xFF };
+			memcpy(pDst + dst_ofs, s_empty_stored_block, 4);
+			dst_ofs += 4;
+		}
+
 		PUT_BITS_FORCE_FLUSH;
 
+		if (raw_stripe)
+			return dst_ofs;
+
 		// Write zlib adler32
 		for (uint32_t i = 0; i < 4; i++)
 		{
@@ -1364,16 +1400,21 @@ do { \
 		return dst_ofs;
 	}
 
+	// If raw_stripe is true, only the raw deflate block is written: no zlib header and no adler32. If final_stripe is false, the block isn't 
+	// marked as final and is followed by an empty stored block, so the output is byte aligned and can be concatenated with the next stripe.
 	static uint32_t pixel_deflate_dyn_4_rle_one_pass(
 		const uint8_t* pImg, uint32_t w, uint32_t h,
-		uint8_t* pDst, uint32_t dst_buf_size)
+		uint8_t* pDst, uint32_t dst_buf_size, bool raw_stripe = false, bool final_stripe = true)
 	{
 		const uint32_t bpl = 1 + w * 4;
 
-		if (dst_buf_size < sizeof(g_dyn_huff_4))
+		const uint32_t header_ofs = raw_stripe ? 2 : 0;
+		if (dst_buf_size < sizeof(g_dyn_huff_4) - header_ofs)
 			return false;
-		memcpy(pDst, g_dyn_huff_4, sizeof(g_dyn_huff_4));
-		uint32_t dst_ofs = sizeof(g_dyn_huff_4);
+		memcpy(pDst, g_dyn_huff_4 + header_ofs, sizeof(g_dyn_huff_4) - header_ofs);
+		uint32_t dst_ofs = sizeof(g_dyn_huff_4) - header_ofs;
+		if (!final_stripe)
+			pDst[2 - header_ofs] &= ~1; // clear BFINAL
 
 		uint64_t bit_buf = DYN_HUFF_4_BITBUF;
 		int bit_buf_size = DYN_HUFF_4_BITBUF_SIZE;
@@ -1381,7 +1422,7 @@ do { \
 		const uint8_t* pSrc = pImg;
 		uint32_t src_ofs = 0;
 
-		uint32_t src_adler32 = fpng_adler32(pImg, bpl * h, FPNG_ADLER32_INIT);
+		uint32_t src_adler32 = raw_stripe ? 0 : fpng_adler32(pImg, bpl * h, FPNG_ADLER32_INIT);
 
 		for (uint32_t y = 0; y < h; y++)
 		{
@@ -1481,8 +1522,23 @@ do_literals:
 
 		PUT_BITS_CZ(g_dyn_huff_4_codes[256].m_code, g_dyn_huff_4_codes[256].m_code_size);
 
+		if (!final_stripe)
+		{
+			// empty stored block (BFINAL 0, BTYPE 00, LEN 0, NLEN 0xFFFF) to byte align the stream
+			PUT_BITS(0, 3);
+			PUT_BITS_FORCE_FLUSH;
+			if ((dst_ofs + 4) > dst_buf_size)
+				return 0;
+			static const uint8_t s_empty_stored_block[4] = { 0x00, 0x00, 0xFF, 0xFF };
+			memcpy(pDst + dst_ofs, s_empty_stored_block, 4);
+			dst_ofs += 4;
+		}
+
 		PUT_BITS_FORCE_FLUSH;
 
+		if (raw_stripe)
+			return dst_ofs;
+
 		// Write zlib adler32
 		for (uint32_t i = 0; i < 4; i++)
 		{
@@ -1705,6 +1761,82 @@ do_literals:
 		return true;
 	}
 
+	bool fpng_deflate_image_stripe(const void* pImage, uint32_t w, uint32_t h, uint32_t num_chans, uint32_t first_row, uint32_t num_rows, std::vector<uint8_t>& out_buf, uint32_t& stripe_adler32)
+	{
+		if (!endian_check())
+		{
+			assert(0);
+			return false;
+		}
+
+		if ((w < 1) || (h < 1) || (w * h > UINT32_MAX) || (w > FPNG_MAX_SUPPORTED_DIM) || (h > FPNG_MAX_SUPPORTED_DIM))
+		{
+			assert(0);
+			return false;
+		}
+
+		if (((num_chans != 3) && (num_chans != 4)) || (num_rows < 1) || (first_row + num_rows > h))
+		{
+			assert(0);
+			return false;
+		}
+
+		const uint32_t bpl = w * num_chans;
+		const bool final_stripe = (first_row + num_rows) == h;
+
+		// The filter of a row only depends on the row above it in the source image, so a stripe filters exactly like the whole image would.
+		std::vector<uint8_t> temp_buf;
+		temp_buf.resize(((bpl + 1) * num_rows + 7) & ~7);
+		uint32_t temp_buf_ofs = 0;
+
+		for (uint32_t y = first_row; y < first_row + num_rows; ++y)
+		{
+			const uint8_t* pSrc = (uint8_t*)pImage + (size_t)y * bpl;
+			const uint8_t* pPrev_src = y ? ((uint8_t*)pImage + (size_t)(y - 1) * bpl) : nullptr;
+
+			apply_filter(y ? 2 : 0, w, h, num_chans, bpl, pSrc, pPrev_src, &temp_buf[temp_buf_ofs]);
+
+			temp_buf_ofs += 1 + bpl;
+		}
+
+		stripe_adler32 = fpng_adler32(temp_buf.data(), temp_buf_ofs, FPNG_ADLER32_INIT);
+
+		out_buf.resize((temp_buf_ofs + 64 + 7) & ~7);
+
+		uint32_t defl_size;
+		if (num_chans == 3)
+			defl_size = pixel_deflate_dyn_3_rle_one_pass(temp_buf.data(), w, num_rows, out_buf.data(), (uint32_t)out_buf.size(), true, final_stripe);
+		else
+			defl_size = pixel_deflate_dyn_4_rle_one_pass(temp_buf.data(), w, num_rows, out_buf.data(), (uint32_t)out_buf.size(), true, final_stripe);
+
+		if (!defl_size)
+		{
+			// Dynamic block failed to compress - fall back to stored blocks. These are byte aligned already.
+			out_buf.resize(temp_buf_ofs + ((temp_buf_ofs + 65534) / 65535) * 5);
+
+			uint32_t src_ofs = 0;
+			while (src_ofs < temp_buf_ofs)
+			{
+				const uint32_t src_remaining = temp_buf_ofs - src_ofs;
+				const uint32_t block_size = minimum<uint32_t>(UINT16_MAX, src_remaining);
+				const bool final_block = final_stripe && (block_size == src_remaining);
+
+				out_buf[defl_size + 0] = final_block ? 1 : 0;
+				out_buf[defl_size + 1] = block_size & 0xFF;
+				out_buf[defl_size + 2] = (block_size >> 8) & 0xFF;
+				out_buf[defl_size + 3] = (~block_size) & 0xFF;
+				out_buf[defl_size + 4] = ((~block_size) >> 8) & 0xFF;
+				memcpy(&out_buf[defl_size + 5], temp_buf.data() + src_ofs, block_size);
+
+				src_ofs += block_size;
+				defl_size += 5 + block_size;
+			}
+		}
+
+		out_buf.resize(defl_size);
+		return true;
+	}
+
 #ifndef FPNG_NO_STDIO
 	bool fpng_encode_image_to_file(const char* pFilename, const void* pImage, uint32_t w, uint32_t h, uint32_t num_chans, uint32_t flags)
 	{
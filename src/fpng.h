@@ -24,6 +24,8 @@ namespace fpng
 	// Fast Adler32 SSE4.1 Adler-32 with a scalar fallback.
 	const uint32_t FPNG_ADLER32_INIT = 1;
 	uint32_t fpng_adler32(const uint8_t* ptr, size_t buf_len, uint32_t adler = FPNG_ADLER32_INIT);
+	// Returns the adler32 of the concatenation of two buffers, given the adler32 of each buffer and the length of the second one.
+	uint32_t fpng_adler32_combine(uint32_t adler1, uint32_t adler2, size_t len2);
 
 	// ---- Compression
 	enum
@@ -42,6 +44,13 @@ namespace fpng
 	// num_chans must be 3 or 4. 
 	bool fpng_encode_image_to_memory(const void* pImage, uint32_t w, uint32_t h, uint32_t num_chans, std::vector<uint8_t>& out_buf, uint32_t flags = 0);
 
+	// Compresses the rows [first_row, first_row + num_rows) of an image as raw Deflate data, without zlib header and adler32. 
+	// Stripes can be compressed independently (e.g. on separate threads) and concatenated in order to form the Deflate stream of the whole image: 
+	// all stripes but the last end with an empty stored block so they're byte aligned, the last stripe's block is marked as final.
+	// stripe_adler32 receives the adler32 of the stripe's filtered rows, combine these with fpng_adler32_combine() for the zlib trailer.
+	// The resulting stream can't be decoded with fpng_decode_memory(), use a standard PNG decoder.
+	bool fpng_deflate_image_stripe(const void* pImage, uint32_t w, uint32_t h, uint32_t num_chans, uint32_t first_row, uint32_t num_rows, std::vector<uint8_t>& out_buf, uint32_t& stripe_adler32);
+
 #ifndef FPNG_NO_STDIO
 	// Fast PNG encoding to the specified file.
 	bool fpng_encode_image_to_file(const char* pFilename, const void* pImage, uint32_t w, uint32_t h, uint32_t num_chans, uint32_t flags = 0);
@@ -37,16 +37,28 @@
 
 #pragma once
 
+#ifdef _WIN32
 #include <SDKDDKVer.h>
 
 // Windows Header Files:
 #include <windows.h>
-#include <iostream>
-#include <string>
 #include <tchar.h>
 #include <Psapi.h>
+#else
+// the core is built on other platforms for the tests and benchmarks, see Posix/Windows.h
+#include <Windows.h>
+#endif
+#include <iostream>
+#include <string>
 #include <utility>
 #include <vector>
 #include "DirectXMath.h"
 
+// MSVC lets every function use the intrinsics of any instruction set, GCC and Clang only allow it in functions marked with the instruction set.
+#if defined(__GNUC__)
+#define TARGET_INSTRUCTION_SET(instructionSet) __attribute__((target(instructionSet)))
+#else
+#define TARGET_INSTRUCTION_SET(instructionSet)
+#endif
+
 // TODO: reference additional headers your program requires here
@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	thread_local size_t t_numberOfAllocations = 0;
+
+	void* allocate(size_t sizeInBytes)
+	{
+		t_numberOfAllocations++;
+		void* toReturn = malloc(sizeInBytes == 0 ? 1 : sizeInBytes);
+		if(nullptr == toReturn)
+		{
+			throw std::bad_alloc();
+		}
+		return toReturn;
+	}
+
+	void* allocateAligned(size_t sizeInBytes, std::align_val_t alignment)
+	{
+		t_numberOfAllocations++;
+		// aligned_alloc wants the size to be a multiple of the alignment.
+		const size_t alignmentInBytes = static_cast<size_t>(alignment);
+		void* toReturn = aligned_alloc(alignmentInBytes, ((sizeInBytes + alignmentInBytes - 1) / alignmentInBytes) * alignmentInBytes);
+		if(nullptr == toReturn)
+		{
+			throw std::bad_alloc();
+		}
+		return toReturn;
+	}
+}
+
+
+AllocationCounter::AllocationCounter() : _numberOfAllocationsAtStart(t_numberOfAllocations)
+{
+}
+
+
+size_t AllocationCounter::numberOfAllocations() const
+{
+	return t_numberOfAllocations - _numberOfAllocationsAtStart;
+}
+
+
+void* operator new(size_t sizeInBytes) { return allocate(sizeInBytes); }
+void* operator new[](size_t sizeInBytes) { return allocate(sizeInBytes); }
+void* operator new(size_t sizeInBytes, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return allocate(sizeInBytes);
+	}
+	catch(const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+void* operator new[](size_t sizeInBytes, const std::nothrow_t& tag) noexcept { return operator new(sizeInBytes, tag); }
+void* operator new(size_t sizeInBytes, std::align_val_t alignment) { return allocateAligned(sizeInBytes, alignment); }
+void* operator new[](size_t sizeInBytes, std::align_val_t alignment) { return allocateAligned(sizeInBytes, alignment); }
+void operator delete(void* block) noexcept { free(block); }
+void operator delete[](void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+void operator delete[](void* block, size_t) noexcept { free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { free(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { free(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { free(block); }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept { free(block); }
@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+// CameraToolsData.h is shared with the camera tools and relies on the includer for DirectXMath.
+#include <DirectXMath.h>
+#include "CameraToolsDataExchange.h"
+
+namespace
+{
+	const uint32_t NUMBER_OF_WRITES = 200000;
+
+	/// <summary>
+	/// Fills all fields of the camera data with values derived from the value specified, so a reader can check whether it got a consistent copy.
+	/// </summary>
+	void fillCameraToolsData(CameraToolsData& toFill, uint32_t value)
+	{
+		// floats represent integers exactly up to 2^24.
+		const float valueAsFloat = (float)(value & 0xFFFFFF);
+		toFill.cameraEnabled = (uint8_t)(value & 1);
+		toFill.cameraMovementLocked = (uint8_t)(value & 1);
+		toFill.fov = valueAsFloat;
+		toFill.coordinates.setValues(valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.lookQuaternion.setValues(valueAsFloat, valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.rotationMatrixUpVector.setValues(valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.rotationMatrixRightVector.setValues(valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.rotationMatrixForwardVector.setValues(valueAsFloat, valueAsFloat, valueAsFloat);
+		toFill.pitch = valueAsFloat;
+		toFill.yaw = valueAsFloat;
+		toFill.roll = valueAsFloat;
+	}
+
+
+	std::unique_ptr<CameraToolsDataExchange> createExchange()
+	{
+		// the exchange lives in a zeroed buffer shared with the camera tools.
+		auto toReturn = std::make_unique<CameraToolsDataExchange>();
+		memset(toReturn.get(), 0, sizeof(CameraToolsDataExchange));
+		return toReturn;
+	}
+}
+
+
+TEST(CameraToolsDataExchangeTests, ReadFailsIfNeverWritten)
+{
+	auto exchange = createExchange();
+	CameraToolsData snapshot;
+	fillCameraToolsData(snapshot, 42);
+	EXPECT_FALSE(exchange->isWrittenTo());
+	EXPECT_FALSE(exchange->read(snapshot));
+	EXPECT_EQ(42.0f, snapshot.fov);
+}
+
+
+TEST(CameraToolsDataExchangeTests, ReadReturnsTheLastWrite)
+{
+	auto exchange = createExchange();
+	CameraToolsData toWrite;
+	fillCameraToolsData(toWrite, 1);
+	exchange->write(toWrite);
+	fillCameraToolsData(toWrite, 2);
+	exchange->write(toWrite);
+	CameraToolsData snapshot;
+	ASSERT_TRUE(exchange->read(snapshot));
+	EXPECT_TRUE(exchange->isWrittenTo());
+	EXPECT_EQ(0, memcmp(&toWrite, &snapshot, sizeof(CameraToolsData)));
+}
+
+
+TEST(CameraToolsDataExchangeTests, ReadGivesUpIfAWriteNeverFinishes)
+{
+	auto exchange = createExchange();
+	CameraToolsData toWrite;
+	fillCameraToolsData(toWrite, 1);
+	exchange->write(toWrite);
+	// a writer which stopped halfway leaves the sequence number odd.
+	exchange->sequence++;
+	CameraToolsData snapshot;
+	fillCameraToolsData(snapshot, 42);
+	EXPECT_FALSE(exchange->read(snapshot));
+	EXPECT_TRUE(exchange->isWrittenTo());
+	EXPECT_EQ(42.0f, snapshot.fov);
+}
+
+
+TEST(CameraToolsDataExchangeTests, ConcurrentReadsAreConsistent)
+{
+	// the calling thread reads while the writer thread writes as fast as it can, and every copy read has to be one the writer wrote.
+	auto exchange = createExchange();
+	std::atomic<bool> writerDone = false;
+	std::thread writer([&exchange, &writerDone]
+	{
+		CameraToolsData toWrite;
+		for(uint32_t i = 1; i <= NUMBER_OF_WRITES; i++)
+		{
+			fillCameraToolsData(toWrite, i);
+			exchange->write(toWrite);
+		}
+		writerDone.store(true, std::memory_order_release);
+	});
+	size_t numberOfReads = 0;
+	size_t numberOfInconsistentReads = 0;
+	CameraToolsData snapshot;
+	CameraToolsData expected;
+	while(!writerDone.load(std::memory_order_acquire))
+	{
+		if(!exchange->read(snapshot))
+		{
+			continue;
+		}
+		numberOfReads++;
+		fillCameraToolsData(expected, (uint32_t)snapshot.fov);
+		if(memcmp(&snapshot, &expected, sizeof(CameraToolsData)) != 0)
+		{
+			numberOfInconsistentReads++;
+		}
+	}
+	writer.join();
+	EXPECT_EQ(0u, numberOfInconsistentReads) << "out of " << numberOfReads << " reads";
+}
@@ -0,0 +1,484 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "FakeEffectRuntime.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	void copyName(const std::string& source, char* destination, size_t* destinationSize)
+	{
+		if(nullptr == destination)
+		{
+			*destinationSize = source.size() + 1;
+			return;
+		}
+		const size_t numberOfCharsToCopy = std::min(source.size(), *destinationSize - 1);
+		memcpy(destination, source.c_str(), numberOfCharsToCopy);
+		destination[numberOfCharsToCopy] = '\0';
+		*destinationSize = numberOfCharsToCopy + 1;
+	}
+}
+
+
+FakeEffectRuntime::FakeEffectRuntime(uint32_t screenshotWidth, uint32_t screenshotHeight) : _screenshotWidth(screenshotWidth), _screenshotHeight(screenshotHeight)
+{
+}
+
+
+void FakeEffectRuntime::addEffect(const std::string& effectName, const std::vector<std::string>& techniqueNames, const std::vector<Uniform>& uniforms)
+{
+	const int effectIndex = static_cast<int>(_effectNames.size());
+	_effectNames.push_back(effectName);
+	_effectGenerations.push_back(1);
+	for(const auto& techniqueName : techniqueNames)
+	{
+		_techniques.push_back({ techniqueName, effectIndex, true });
+	}
+	for(const auto& uniform : uniforms)
+	{
+		_uniforms.push_back({ uniform, effectIndex });
+	}
+}
+
+
+void FakeEffectRuntime::addSyntheticEffect(const std::string& effectName, int numberOfUniforms, float valueSeed)
+{
+	std::vector<Uniform> uniforms;
+	uniforms.reserve(numberOfUniforms);
+	for(int i = 0; i < numberOfUniforms; i++)
+	{
+		Uniform toAdd;
+		toAdd.name = effectName + "_uniform" + std::to_string(i);
+		if(i % 8 == 7)
+		{
+			// every 8th is an int, which the core should skip.
+			toAdd.baseType = reshade::api::format::r32_sint;
+			toAdd.numberOfRows = 1;
+		}
+		else
+		{
+			toAdd.numberOfRows = (i % 4) + 1;
+		}
+		for(int j = 0; j < 4; j++)
+		{
+			toAdd.values[j] = valueSeed + static_cast<float>(i) + static_cast<float>(j) * 0.25f;
+		}
+		uniforms.push_back(toAdd);
+	}
+	addEffect(effectName, { effectName + "_technique" }, uniforms);
+}
+
+
+void FakeEffectRuntime::reloadEffects()
+{
+	for(auto& generation : _effectGenerations)
+	{
+		generation++;
+	}
+}
+
+
+void FakeEffectRuntime::reloadEffect(const std::string& effectName)
+{
+	const int effectIndex = findEffectIndex(effectName.c_str());
+	if(effectIndex >= 0)
+	{
+		_effectGenerations[effectIndex]++;
+	}
+}
+
+
+float* FakeEffectRuntime::uniformValues(const std::string& effectName, const std::string& uniformName)
+{
+	const int effectIndex = findEffectIndex(effectName.c_str());
+	for(auto& entry : _uniforms)
+	{
+		if(entry.effectIndex == effectIndex && entry.uniform.name == uniformName)
+		{
+			return entry.uniform.values;
+		}
+	}
+	return nullptr;
+}
+
+
+void FakeEffectRuntime::setTechniqueEnabled(const std::string& effectName, const std::string& techniqueName, bool isEnabled)
+{
+	const int effectIndex = findEffectIndex(effectName.c_str());
+	for(auto& entry : _techniques)
+	{
+		if(entry.effectIndex == effectIndex && entry.name == techniqueName)
+		{
+			entry.isEnabled = isEnabled;
+		}
+	}
+}
+
+
+bool FakeEffectRuntime::isTechniqueEnabled(const std::string& effectName, const std::string& techniqueName) const
+{
+	const int effectIndex = findEffectIndex(effectName.c_str());
+	for(const auto& entry : _techniques)
+	{
+		if(entry.effectIndex == effectIndex && entry.name == techniqueName)
+		{
+			return entry.isEnabled;
+		}
+	}
+	return false;
+}
+
+
+void FakeEffectRuntime::setScreenshotSize(uint32_t width, uint32_t height)
+{
+	_screenshotWidth = width;
+	_screenshotHeight = height;
+}
+
+
+void FakeEffectRuntime::resetCounters()
+{
+	_numberOfUniformWrites = 0;
+	_numberOfTechniqueStateChanges = 0;
+	_numberOfScreenshotsCaptured = 0;
+}
+
+
+void FakeEffectRuntime::enumerate_uniform_variables(const char* effect_name, void(*callback)(effect_runtime* runtime, reshade::api::effect_uniform_variable variable, void* user_data), void* user_data)
+{
+	const int effectIndex = nullptr == effect_name ? -1 : findEffectIndex(effect_name);
+	if(nullptr != effect_name && effectIndex < 0)
+	{
+		return;
+	}
+	for(size_t i = 0; i < _uniforms.size(); i++)
+	{
+		if(effectIndex < 0 || _uniforms[i].effectIndex == effectIndex)
+		{
+			callback(this, { toHandle(i, _uniforms[i].effectIndex) }, user_data);
+		}
+	}
+}
+
+
+reshade::api::effect_uniform_variable FakeEffectRuntime::find_uniform_variable(const char* effect_name, const char* variable_name) const
+{
+	const int effectIndex = findEffectIndex(effect_name);
+	for(size_t i = 0; i < _uniforms.size(); i++)
+	{
+		if(_uniforms[i].effectIndex == effectIndex && _uniforms[i].uniform.name == variable_name)
+		{
+			return { toHandle(i, effectIndex) };
+		}
+	}
+	return { 0 };
+}
+
+
+void FakeEffectRuntime::get_uniform_variable_type(reshade::api::effect_uniform_variable variable, reshade::api::format* out_base_type, uint32_t* out_rows, uint32_t* out_columns, uint32_t* out_array_length) const
+{
+	const UniformEntry* entry = findUniform(variable.handle);
+	*out_base_type = nullptr == entry ? reshade::api::format::unknown : entry->uniform.baseType;
+	if(nullptr != out_rows)
+	{
+		*out_rows = nullptr == entry ? 0 : entry->uniform.numberOfRows;
+	}
+	if(nullptr != out_columns)
+	{
+		*out_columns = 1;
+	}
+	if(nullptr != out_array_length)
+	{
+		*out_array_length = 0;
+	}
+}
+
+
+void FakeEffectRuntime::get_uniform_variable_name(reshade::api::effect_uniform_variable variable, char* name, size_t* name_size) const
+{
+	const UniformEntry* entry = findUniform(variable.handle);
+	copyName(nullptr == entry ? std::string() : entry->uniform.name, name, name_size);
+}
+
+
+void FakeEffectRuntime::get_uniform_variable_effect_name(reshade::api::effect_uniform_variable variable, char* effect_name, size_t* effect_name_size) const
+{
+	const UniformEntry* entry = findUniform(variable.handle);
+	copyName(nullptr == entry ? std::string() : _effectNames[entry->effectIndex], effect_name, effect_name_size);
+}
+
+
+void FakeEffectRuntime::get_uniform_value_bool(reshade::api::effect_uniform_variable variable, bool* values, size_t count, size_t /*array_index*/) const
+{
+	const UniformEntry* entry = findUniform(variable.handle);
+	for(size_t i = 0; i < count && i < 4; i++)
+	{
+		values[i] = nullptr != entry && entry->uniform.values[i] != 0.0f;
+	}
+}
+
+
+void FakeEffectRuntime::get_uniform_value_float(reshade::api::effect_uniform_variable variable, float* values, size_t count, size_t /*array_index*/) const
+{
+	const UniformEntry* entry = findUniform(variable.handle);
+	for(size_t i = 0; i < count && i < 4; i++)
+	{
+		values[i] = nullptr == entry ? 0.0f : entry->uniform.values[i];
+	}
+}
+
+
+void FakeEffectRuntime::get_uniform_value_int(reshade::api::effect_uniform_variable variable, int32_t* values, size_t count, size_t /*array_index*/) const
+{
+	const UniformEntry* entry = findUniform(variable.handle);
+	for(size_t i = 0; i < count && i < 4; i++)
+	{
+		values[i] = nullptr == entry ? 0 : static_cast<int32_t>(entry->uniform.values[i]);
+	}
+}
+
+
+void FakeEffectRuntime::get_uniform_value_uint(reshade::api::effect_uniform_variable variable, uint32_t* values, size_t count, size_t /*array_index*/) const
+{
+	const UniformEntry* entry = findUniform(variable.handle);
+	for(size_t i = 0; i < count && i < 4; i++)
+	{
+		values[i] = nullptr == entry ? 0 : static_cast<uint32_t>(entry->uniform.values[i]);
+	}
+}
+
+
+void FakeEffectRuntime::set_uniform_value_bool(reshade::api::effect_uniform_variable variable, const bool* values, size_t count, size_t /*array_index*/)
+{
+	UniformEntry* entry = findUniform(variable.handle);
+	if(nullptr == entry)
+	{
+		return;
+	}
+	for(size_t i = 0; i < count && i < 4; i++)
+	{
+		entry->uniform.values[i] = values[i] ? 1.0f : 0.0f;
+	}
+	_numberOfUniformWrites++;
+}
+
+
+void FakeEffectRuntime::set_uniform_value_float(reshade::api::effect_uniform_variable variable, const float* values, size_t count, size_t /*array_index*/)
+{
+	UniformEntry* entry = findUniform(variable.handle);
+	if(nullptr == entry)
+	{
+		return;
+	}
+	for(size_t i = 0; i < count && i < 4; i++)
+	{
+		entry->uniform.values[i] = values[i];
+	}
+	_numberOfUniformWrites++;
+}
+
+
+void FakeEffectRuntime::set_uniform_value_int(reshade::api::effect_uniform_variable variable, const int32_t* values, size_t count, size_t /*array_index*/)
+{
+	UniformEntry* entry = findUniform(variable.handle);
+	if(nullptr == entry)
+	{
+		return;
+	}
+	for(size_t i = 0; i < count && i < 4; i++)
+	{
+		entry->uniform.values[i] = static_cast<float>(values[i]);
+	}
+	_numberOfUniformWrites++;
+}
+
+
+void FakeEffectRuntime::set_uniform_value_uint(reshade::api::effect_uniform_variable variable, const uint32_t* values, size_t count, size_t /*array_index*/)
+{
+	UniformEntry* entry = findUniform(variable.handle);
+	if(nullptr == entry)
+	{
+		return;
+	}
+	for(size_t i = 0; i < count && i < 4; i++)
+	{
+		entry->uniform.values[i] = static_cast<float>(values[i]);
+	}
+	_numberOfUniformWrites++;
+}
+
+
+void FakeEffectRuntime::enumerate_techniques(const char* effect_name, void(*callback)(effect_runtime* runtime, reshade::api::effect_technique technique, void* user_data), void* user_data)
+{
+	const int effectIndex = nullptr == effect_name ? -1 : findEffectIndex(effect_name);
+	if(nullptr != effect_name && effectIndex < 0)
+	{
+		return;
+	}
+	for(size_t i = 0; i < _techniques.size(); i++)
+	{
+		if(effectIndex < 0 || _techniques[i].effectIndex == effectIndex)
+		{
+			callback(this, { toHandle(i, _techniques[i].effectIndex) }, user_data);
+		}
+	}
+}
+
+
+reshade::api::effect_technique FakeEffectRuntime::find_technique(const char* effect_name, const char* technique_name)
+{
+	const int effectIndex = findEffectIndex(effect_name);
+	for(size_t i = 0; i < _techniques.size(); i++)
+	{
+		if(_techniques[i].effectIndex == effectIndex && _techniques[i].name == technique_name)
+		{
+			return { toHandle(i, effectIndex) };
+		}
+	}
+	return { 0 };
+}
+
+
+void FakeEffectRuntime::get_technique_name(reshade::api::effect_technique technique, char* name, size_t* name_size) const
+{
+	const TechniqueEntry* entry = findTechnique(technique.handle);
+	copyName(nullptr == entry ? std::string() : entry->name, name, name_size);
+}
+
+
+void FakeEffectRuntime::get_technique_effect_name(reshade::api::effect_technique technique, char* effect_name, size_t* effect_name_size) const
+{
+	const TechniqueEntry* entry = findTechnique(technique.handle);
+	copyName(nullptr == entry ? std::string() : _effectNames[entry->effectIndex], effect_name, effect_name_size);
+}
+
+
+bool FakeEffectRuntime::get_technique_state(reshade::api::effect_technique technique) const
+{
+	const TechniqueEntry* entry = findTechnique(technique.handle);
+	return nullptr != entry && entry->isEnabled;
+}
+
+
+void FakeEffectRuntime::set_technique_state(reshade::api::effect_technique technique, bool enabled)
+{
+	TechniqueEntry* entry = findTechnique(technique.handle);
+	if(nullptr == entry)
+	{
+		return;
+	}
+	entry->isEnabled = enabled;
+	_numberOfTechniqueStateChanges++;
+}
+
+
+bool FakeEffectRuntime::capture_screenshot(uint8_t* pixels)
+{
+	// a gradient which shifts every capture, so consecutive shots differ like frames of a moving camera do.
+	const uint32_t offset = static_cast<uint32_t>(_numberOfScreenshotsCaptured);
+	for(uint32_t y = 0; y < _screenshotHeight; y++)
+	{
+		uint8_t* row = pixels + static_cast<size_t>(y) * _screenshotWidth * 4;
+		for(uint32_t x = 0; x < _screenshotWidth; x++)
+		{
+			row[x * 4] = static_cast<uint8_t>(x + offset);
+			row[x * 4 + 1] = static_cast<uint8_t>(y + offset);
+			row[x * 4 + 2] = static_cast<uint8_t>((x ^ y) + offset);
+			row[x * 4 + 3] = 0xFF;
+		}
+	}
+	_numberOfScreenshotsCaptured++;
+	return true;
+}
+
+
+void FakeEffectRuntime::get_screenshot_width_and_height(uint32_t* out_width, uint32_t* out_height) const
+{
+	*out_width = _screenshotWidth;
+	*out_height = _screenshotHeight;
+}
+
+
+uint64_t FakeEffectRuntime::toHandle(size_t index, int effectIndex) const
+{
+	return (_effectGenerations[effectIndex] << 32) | static_cast<uint64_t>(index + 1);
+}
+
+
+const FakeEffectRuntime::UniformEntry* FakeEffectRuntime::findUniform(uint64_t handle) const
+{
+	const uint64_t index = (handle & 0xFFFFFFFF) - 1;
+	if(index >= _uniforms.size() || (handle >> 32) != _effectGenerations[_uniforms[index].effectIndex])
+	{
+		return nullptr;
+	}
+	return &_uniforms[index];
+}
+
+
+FakeEffectRuntime::UniformEntry* FakeEffectRuntime::findUniform(uint64_t handle)
+{
+	return const_cast<UniformEntry*>(static_cast<const FakeEffectRuntime*>(this)->findUniform(handle));
+}
+
+
+const FakeEffectRuntime::TechniqueEntry* FakeEffectRuntime::findTechnique(uint64_t handle) const
+{
+	const uint64_t index = (handle & 0xFFFFFFFF) - 1;
+	if(index >= _techniques.size() || (handle >> 32) != _effectGenerations[_techniques[index].effectIndex])
+	{
+		return nullptr;
+	}
+	return &_techniques[index];
+}
+
+
+FakeEffectRuntime::TechniqueEntry* FakeEffectRuntime::findTechnique(uint64_t handle)
+{
+	return const_cast<TechniqueEntry*>(static_cast<const FakeEffectRuntime*>(this)->findTechnique(handle));
+}
+
+
+int FakeEffectRuntime::findEffectIndex(const char* effectName) const
+{
+	for(size_t i = 0; i < _effectNames.size(); i++)
+	{
+		if(_effectNames[i] == effectName)
+		{
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <reshade.hpp>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// In-memory effect_runtime for the tests and benchmarks of the core. Serves a synthetic framebuffer and the techniques and uniforms of the effects
+/// added to it, like ReShade does for a loaded preset. Everything not needed by the core is a no-op.
+/// </summary>
+/// <remarks>Not thread safe, like the ReShade runtime it stands in for is only used from the present thread.</remarks>
+class FakeEffectRuntime : public reshade::api::effect_runtime
+{
+public:
+	struct Uniform
+	{
+		std::string name;
+		reshade::api::format baseType = reshade::api::format::r32_float;
+		uint32_t numberOfRows = 4;					// float4 has 4 rows and 1 column, like ReShade reports it.
+		float values[4] = {};
+	};
+
+	FakeEffectRuntime(uint32_t screenshotWidth = 1920, uint32_t screenshotHeight = 1080);
+
+	/// <summary>
+	/// Adds an effect with the techniques and uniforms specified. The techniques are enabled.
+	/// </summary>
+	void addEffect(const std::string& effectName, const std::vector<std::string>& techniqueNames, const std::vector<Uniform>& uniforms);
+	/// <summary>
+	/// Adds an effect like the ones in a heavy preset: a technique and numberOfUniforms uniforms, mostly floats with 1 to 4 components and some ints.
+	/// The float values are derived from valueSeed, so two calls with a different seed give effects with different values.
+	/// </summary>
+	void addSyntheticEffect(const std::string& effectName, int numberOfUniforms, float valueSeed = 0.0f);
+	/// <summary>
+	/// Simulates a reload of the effects: all handles handed out so far become invalid and the effects get new handles. Values are kept.
+	/// </summary>
+	void reloadEffects();
+	/// <summary>
+	/// Same as reloadEffects but only the handles of the effect specified change, like when ReShade recompiles a single effect after its source changed.
+	/// </summary>
+	void reloadEffect(const std::string& effectName);
+	/// <summary>
+	/// Returns the values of the uniform specified, or nullptr if there's no such uniform.
+	/// </summary>
+	float* uniformValues(const std::string& effectName, const std::string& uniformName);
+	void setTechniqueEnabled(const std::string& effectName, const std::string& techniqueName, bool isEnabled);
+	bool isTechniqueEnabled(const std::string& effectName, const std::string& techniqueName) const;
+	void setScreenshotSize(uint32_t width, uint32_t height);
+
+	int numberOfUniformWrites() const { return _numberOfUniformWrites; }
+	int numberOfTechniqueStateChanges() const { return _numberOfTechniqueStateChanges; }
+	int numberOfScreenshotsCaptured() const { return _numberOfScreenshotsCaptured; }
+	void resetCounters();
+
+	// effect_runtime
+	using effect_runtime::enumerate_uniform_variables;
+	using effect_runtime::enumerate_techniques;
+	void enumerate_uniform_variables(const char* effect_name, void(*callback)(effect_runtime* runtime, reshade::api::effect_uniform_variable variable, void* user_data), void* user_data) override;
+	reshade::api::effect_uniform_variable find_uniform_variable(const char* effect_name, const char* variable_name) const override;
+	void get_uniform_variable_type(reshade::api::effect_uniform_variable variable, reshade::api::format* out_base_type, uint32_t* out_rows = nullptr, uint32_t* out_columns = nullptr, uint32_t* out_array_length = nullptr) const override;
+	void get_uniform_variable_name(reshade::api::effect_uniform_variable variable, char* name, size_t* name_size) const override;
+	void get_uniform_variable_effect_name(reshade::api::effect_uniform_variable variable, char* effect_name, size_t* effect_name_size) const override;
+	void get_uniform_value_bool(reshade::api::effect_uniform_variable variable, bool* values, size_t count, size_t array_index = 0) const override;
+	void get_uniform_value_float(reshade::api::effect_uniform_variable variable, float* values, size_t count, size_t array_index = 0) const override;
+	void get_uniform_value_int(reshade::api::effect_uniform_variable variable, int32_t* values, size_t count, size_t array_index = 0) const override;
+	void get_uniform_value_uint(reshade::api::effect_uniform_variable variable, uint32_t* values, size_t count, size_t array_index = 0) const override;
+	void set_uniform_value_bool(reshade::api::effect_uniform_variable variable, const bool* values, size_t count, size_t array_index = 0) override;
+	void set_uniform_value_float(reshade::api::effect_uniform_variable variable, const float* values, size_t count, size_t array_index = 0) override;
+	void set_uniform_value_int(reshade::api::effect_uniform_variable variable, const int32_t* values, size_t count, size_t array_index = 0) override;
+	void set_uniform_value_uint(reshade::api::effect_uniform_variable variable, const uint32_t* values, size_t count, size_t array_index = 0) override;
+	void enumerate_techniques(const char* effect_name, void(*callback)(effect_runtime* runtime, reshade::api::effect_technique technique, void* user_data), void* user_data) override;
+	reshade::api::effect_technique find_technique(const char* effect_name, const char* technique_name) override;
+	void get_technique_name(reshade::api::effect_technique technique, char* name, size_t* name_size) const override;
+	void get_technique_effect_name(reshade::api::effect_technique technique, char* effect_name, size_t* effect_name_size) const override;
+	bool get_technique_state(reshade::api::effect_technique technique) const override;
+	void set_technique_state(reshade::api::effect_technique technique, bool enabled) override;
+	bool capture_screenshot(uint8_t* pixels) override;
+	void get_screenshot_width_and_height(uint32_t* out_width, uint32_t* out_height) const override;
+
+	// everything below isn't used by the core.
+	uint64_t get_native() const override { return 0; }
+	void get_private_data(const uint8_t /*guid*/[16], uint64_t* data) const override { *data = 0; }
+	void set_private_data(const uint8_t /*guid*/[16], const uint64_t /*data*/) override {}
+	reshade::api::device* get_device() override { return nullptr; }
+	void* get_hwnd() const override { return nullptr; }
+	reshade::api::resource get_back_buffer(uint32_t /*index*/) override { return { 0 }; }
+	uint32_t get_back_buffer_count() const override { return 1; }
+	uint32_t get_current_back_buffer_index() const override { return 0; }
+	reshade::api::command_queue* get_command_queue() override { return nullptr; }
+	void render_effects(reshade::api::command_list* /*cmd_list*/, reshade::api::resource_view /*rtv*/, reshade::api::resource_view /*rtv_srgb*/ = { 0 }) override {}
+	bool is_key_down(uint32_t /*keycode*/) const override { return false; }
+	bool is_key_pressed(uint32_t /*keycode*/) const override { return false; }
+	bool is_key_released(uint32_t /*keycode*/) const override { return false; }
+	bool is_mouse_button_down(uint32_t /*button*/) const override { return false; }
+	bool is_mouse_button_pressed(uint32_t /*button*/) const override { return false; }
+	bool is_mouse_button_released(uint32_t /*button*/) const override { return false; }
+	void get_mouse_cursor_position(uint32_t* out_x, uint32_t* out_y, int16_t* /*out_wheel_delta*/ = nullptr) const override { *out_x = 0; *out_y = 0; }
+	bool get_annotation_bool_from_uniform_variable(reshade::api::effect_uniform_variable /*variable*/, const char* /*name*/, bool* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_float_from_uniform_variable(reshade::api::effect_uniform_variable /*variable*/, const char* /*name*/, float* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_int_from_uniform_variable(reshade::api::effect_uniform_variable /*variable*/, const char* /*name*/, int32_t* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_uint_from_uniform_variable(reshade::api::effect_uniform_variable /*variable*/, const char* /*name*/, uint32_t* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_string_from_uniform_variable(reshade::api::effect_uniform_variable /*variable*/, const char* /*name*/, char* /*value*/, size_t* /*value_size*/) const override { return false; }
+	void enumerate_texture_variables(const char* /*effect_name*/, void(* /*callback*/)(effect_runtime* runtime, reshade::api::effect_texture_variable variable, void* user_data), void* /*user_data*/) override {}
+	reshade::api::effect_texture_variable find_texture_variable(const char* /*effect_name*/, const char* /*variable_name*/) const override { return { 0 }; }
+	void get_texture_variable_name(reshade::api::effect_texture_variable /*variable*/, char* /*name*/, size_t* name_size) const override { *name_size = 0; }
+	void get_texture_variable_effect_name(reshade::api::effect_texture_variable /*variable*/, char* /*effect_name*/, size_t* effect_name_size) const override { *effect_name_size = 0; }
+	bool get_annotation_bool_from_texture_variable(reshade::api::effect_texture_variable /*variable*/, const char* /*name*/, bool* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_float_from_texture_variable(reshade::api::effect_texture_variable /*variable*/, const char* /*name*/, float* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_int_from_texture_variable(reshade::api::effect_texture_variable /*variable*/, const char* /*name*/, int32_t* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_uint_from_texture_variable(reshade::api::effect_texture_variable /*variable*/, const char* /*name*/, uint32_t* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_string_from_texture_variable(reshade::api::effect_texture_variable /*variable*/, const char* /*name*/, char* /*value*/, size_t* /*value_size*/) const override { return false; }
+	void update_texture(reshade::api::effect_texture_variable /*variable*/, const uint32_t /*width*/, const uint32_t /*height*/, const uint8_t* /*pixels*/) override {}
+	void get_texture_binding(reshade::api::effect_texture_variable /*variable*/, reshade::api::resource_view* /*out_srv*/, reshade::api::resource_view* /*out_srv_srgb*/ = nullptr) const override {}
+	void update_texture_bindings(const char* /*semantic*/, reshade::api::resource_view /*srv*/, reshade::api::resource_view /*srv_srgb*/ = { 0 }) override {}
+	bool get_annotation_bool_from_technique(reshade::api::effect_technique /*technique*/, const char* /*name*/, bool* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_float_from_technique(reshade::api::effect_technique /*technique*/, const char* /*name*/, float* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_int_from_technique(reshade::api::effect_technique /*technique*/, const char* /*name*/, int32_t* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_uint_from_technique(reshade::api::effect_technique /*technique*/, const char* /*name*/, uint32_t* /*values*/, size_t /*count*/, size_t /*array_index*/ = 0) const override { return false; }
+	bool get_annotation_string_from_technique(reshade::api::effect_technique /*technique*/, const char* /*name*/, char* /*value*/, size_t* /*value_size*/) const override { return false; }
+	bool get_preprocessor_definition(const char* /*name*/, char* /*value*/, size_t* /*value_size*/) const override { return false; }
+	void set_preprocessor_definition(const char* /*name*/, const char* /*value*/) override {}
+	bool get_preprocessor_definition_for_effect(const char* /*effect_name*/, const char* /*name*/, char* /*value*/, size_t* /*value_size*/) const override { return false; }
+	void set_preprocessor_definition_for_effect(const char* /*effect_name*/, const char* /*name*/, const char* /*value*/) override {}
+	void render_technique(reshade::api::effect_technique /*technique*/, reshade::api::command_list* /*cmd_list*/, reshade::api::resource_view /*rtv*/, reshade::api::resource_view /*rtv_srgb*/ = { 0 }) override {}
+	bool get_effects_state() const override { return true; }
+	void set_effects_state(bool /*enabled*/) override {}
+	void get_current_preset_path(char* /*path*/, size_t* path_size) const override { *path_size = 0; }
+	void set_current_preset_path(const char* /*path*/) override {}
+	void reorder_techniques(size_t /*count*/, const reshade::api::effect_technique* /*techniques*/) override {}
+	void block_input_next_frame() override {}
+	uint32_t last_key_pressed() const override { return 0; }
+	uint32_t last_key_released() const override { return 0; }
+	void save_current_preset() const override {}
+
+private:
+	struct UniformEntry
+	{
+		Uniform uniform;
+		int effectIndex;
+	};
+
+	struct TechniqueEntry
+	{
+		std::string name;
+		int effectIndex;
+		bool isEnabled;
+	};
+
+	// handles are the index in the vectors below plus 1, combined with the generation of their effect, so handles from before a reload are invalid.
+	uint64_t toHandle(size_t index, int effectIndex) const;
+	// returns nullptr if the handle is invalid
+	const UniformEntry* findUniform(uint64_t handle) const;
+	UniformEntry* findUniform(uint64_t handle);
+	TechniqueEntry* findTechnique(uint64_t handle);
+	const TechniqueEntry* findTechnique(uint64_t handle) const;
+	int findEffectIndex(const char* effectName) const;
+
+	std::vector<std::string> _effectNames;
+	std::vector<uint64_t> _effectGenerations;			// per effect in _effectNames
+	std::vector<UniformEntry> _uniforms;
+	std::vector<TechniqueEntry> _techniques;
+	uint32_t _screenshotWidth;
+	uint32_t _screenshotHeight;
+	int _numberOfUniformWrites = 0;
+	int _numberOfTechniqueStateChanges = 0;
+	int _numberOfScreenshotsCaptured = 0;
+};
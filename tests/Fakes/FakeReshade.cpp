@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include "FakeReshade.h"
+#include <reshade.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace
+{
+	std::mutex g_fakeReshadeMutex;
+	std::string g_basePath = std::filesystem::temp_directory_path().string();
+	std::vector<std::string> g_logMessages;
+	std::map<std::string, std::string> g_configValues;
+
+	std::string toConfigKey(const char* section, const char* key)
+	{
+		return std::string(nullptr == section ? "" : section) + "|" + key;
+	}
+}
+
+
+namespace FakeReshade
+{
+	void setBasePath(const std::string& basePath)
+	{
+		std::scoped_lock lock(g_fakeReshadeMutex);
+		g_basePath = basePath;
+	}
+
+
+	std::vector<std::string> takeLogMessages()
+	{
+		std::scoped_lock lock(g_fakeReshadeMutex);
+		return std::exchange(g_logMessages, {});
+	}
+
+
+	void clearConfig()
+	{
+		std::scoped_lock lock(g_fakeReshadeMutex);
+		g_configValues.clear();
+	}
+}
+
+
+extern "C" void ReShadeLogMessage(HMODULE /*module*/, int level, const char* message)
+{
+	if(level == static_cast<int>(reshade::log_level::error))
+	{
+		fprintf(stderr, "ReShade error: %s\n", message);
+	}
+	std::scoped_lock lock(g_fakeReshadeMutex);
+	g_logMessages.emplace_back(message);
+}
+
+
+extern "C" void ReShadeGetBasePath(char* path, size_t* path_size)
+{
+	std::scoped_lock lock(g_fakeReshadeMutex);
+	if(nullptr == path)
+	{
+		*path_size = g_basePath.size() + 1;
+		return;
+	}
+	const size_t numberOfCharsToCopy = std::min(g_basePath.size(), *path_size - 1);
+	memcpy(path, g_basePath.c_str(), numberOfCharsToCopy);
+	path[numberOfCharsToCopy] = '\0';
+	*path_size = numberOfCharsToCopy + 1;
+}
+
+
+extern "C" bool ReShadeGetConfigValue(HMODULE /*module*/, reshade::api::effect_runtime* /*runtime*/, const char* section, const char* key, char* value, size_t* value_size)
+{
+	std::scoped_lock lock(g_fakeReshadeMutex);
+	const auto it = g_configValues.find(toConfigKey(section, key));
+	if(it == g_configValues.end())
+	{
+		*value_size = 0;
+		return false;
+	}
+	if(nullptr == value)
+	{
+		*value_size = it->second.size() + 1;
+		return true;
+	}
+	const size_t numberOfCharsToCopy = std::min(it->second.size(), *value_size - 1);
+	memcpy(value, it->second.c_str(), numberOfCharsToCopy);
+	value[numberOfCharsToCopy] = '\0';
+	*value_size = numberOfCharsToCopy + 1;
+	return true;
+}
+
+
+extern "C" void ReShadeSetConfigValue(HMODULE /*module*/, reshade::api::effect_runtime* /*runtime*/, const char* section, const char* key, const char* value)
+{
+	std::scoped_lock lock(g_fakeReshadeMutex);
+	g_configValues[toConfigKey(section, key)] = nullptr == value ? "" : value;
+}
+
+
+extern "C" bool ReShadeRegisterAddon(HMODULE /*module*/, uint32_t /*api_version*/)
+{
+	return true;
+}
+
+
+extern "C" void ReShadeUnregisterAddon(HMODULE /*module*/)
+{
+}
+
+
+extern "C" void ReShadeRegisterEvent(reshade::addon_event /*ev*/, void* /*callback*/)
+{
+}
+
+
+extern "C" void ReShadeUnregisterEvent(reshade::addon_event /*ev*/, void* /*callback*/)
+{
+}
+
+
+extern "C" void ReShadeRegisterOverlay(const char* /*title*/, void(* /*callback*/)(reshade::api::effect_runtime* runtime))
+{
+}
+
+
+extern "C" void ReShadeUnregisterOverlay(const char* /*title*/, void(* /*callback*/)(reshade::api::effect_runtime* runtime))
+{
+}
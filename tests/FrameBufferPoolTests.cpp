@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include "FrameBufferPool.h"
+
+TEST(FrameBufferPoolTests, RecyclesReturnedBuffers)
+{
+	FrameBufferPool pool;
+	auto buffer = pool.tryAcquire(100);
+	const uint8_t* bytes = buffer.data();
+	buffer.release();
+	auto recycled = pool.tryAcquire(80);
+	EXPECT_EQ(bytes, recycled.data());
+	EXPECT_EQ(80u, recycled.size());
+	EXPECT_EQ(1, pool.numberOfBuffersInUse());
+}
+
+
+TEST(FrameBufferPoolTests, AlwaysHandsOutASingleBuffer)
+{
+	FrameBufferPool pool;
+	pool.setMemoryBudget(50);
+	auto buffer = pool.tryAcquire(100);
+	EXPECT_FALSE(buffer.isEmpty());
+	EXPECT_TRUE(pool.tryAcquire(10).isEmpty());
+}
+
+
+TEST(FrameBufferPoolTests, ChecksTheBudgetWithTheSizeOfTheBufferHandedOut)
+{
+	FrameBufferPool pool;
+	pool.setMemoryBudget(200);
+	{
+		auto first = pool.tryAcquire(100);
+		auto second = pool.tryAcquire(100);
+		ASSERT_FALSE(second.isEmpty());
+	}
+	pool.setMemoryBudget(150);
+	auto first = pool.tryAcquire(10);
+	ASSERT_FALSE(first.isEmpty());
+	// only 20 bytes are requested in total, but the free buffer handed out would bring the bytes in use to 200.
+	EXPECT_TRUE(pool.tryAcquire(10).isEmpty());
+	EXPECT_EQ(1, pool.numberOfBuffersInUse());
+}
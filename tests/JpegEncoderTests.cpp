@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <jpeglib.h>
+#include "FastJpegEncoder.h"
+// a private copy of stb_image_write, so the test doesn't link the screenshot writer which holds the implementation.
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#if defined(__GNUC__)
+// third party code, of which only the jpg writer is used.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+#include "std_image_write.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+	std::vector<uint8_t> createTestImage(uint32_t width, uint32_t height)
+	{
+		// smooth gradients, hard colored edges and noise, so both luma and chroma detail matter.
+		std::vector<uint8_t> image((size_t)width * height * 3);
+		uint32_t seed = 1;
+		for(uint32_t y = 0; y < height; y++)
+		{
+			for(uint32_t x = 0; x < width; x++)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				uint8_t* pixel = &image[((size_t)y * width + x) * 3];
+				pixel[0] = (uint8_t)(128 + 100 * sin(x * 0.01) + ((seed >> 24) & 7));
+				pixel[1] = (uint8_t)((x * y / 64) & 0xFF);
+				pixel[2] = (uint8_t)(((x / 50 + y / 50) & 1) ? 230 : 20 + ((seed >> 16) & 15));
+			}
+		}
+		return image;
+	}
+
+
+	void appendToEncodedData(void* context, void* data, int size)
+	{
+		auto encodedData = static_cast<std::vector<uint8_t>*>(context);
+		encodedData->insert(encodedData->end(), static_cast<uint8_t*>(data), static_cast<uint8_t*>(data) + size);
+	}
+
+
+	std::vector<uint8_t> encodeWithStb(const std::vector<uint8_t>& image, uint32_t width, uint32_t height, int quality)
+	{
+		std::vector<uint8_t> encodedData;
+		stbi_write_jpg_to_func(appendToEncodedData, &encodedData, width, height, 3, image.data(), quality);
+		return encodedData;
+	}
+
+
+	std::vector<uint8_t> encodeFast(const std::vector<uint8_t>& image, uint32_t width, uint32_t height, int quality, uint32_t numberOfThreads)
+	{
+		std::vector<uint8_t> encodedData;
+		EXPECT_TRUE(IGCS::FastJpegEncoder::encodeImageToMemory(image.data(), width, height, quality, encodedData, numberOfThreads));
+		return encodedData;
+	}
+
+
+	/// <summary>
+	/// Decodes the jpg with libjpeg. Returns an empty vector if the jpg isn't valid or has another size than expected.
+	/// </summary>
+	std::vector<uint8_t> decode(const std::vector<uint8_t>& encodedData, uint32_t expectedWidth, uint32_t expectedHeight)
+	{
+		jpeg_decompress_struct decompressInfo;
+		jpeg_error_mgr errorManager;
+		decompressInfo.err = jpeg_std_error(&errorManager);
+		// libjpeg exits on a fatal error by default, a test has to fail instead.
+		errorManager.error_exit = [](j_common_ptr /*info*/) { throw std::runtime_error("libjpeg failed to decode the jpg"); };
+		std::vector<uint8_t> toReturn;
+		jpeg_create_decompress(&decompressInfo);
+		try
+		{
+			jpeg_mem_src(&decompressInfo, encodedData.data(), (unsigned long)encodedData.size());
+			jpeg_read_header(&decompressInfo, TRUE);
+			jpeg_start_decompress(&decompressInfo);
+			if(decompressInfo.output_width == expectedWidth && decompressInfo.output_height == expectedHeight && decompressInfo.output_components == 3)
+			{
+				toReturn.resize((size_t)expectedWidth * expectedHeight * 3);
+				while(decompressInfo.output_scanline < expectedHeight)
+				{
+					uint8_t* row = &toReturn[(size_t)decompressInfo.output_scanline * expectedWidth * 3];
+					jpeg_read_scanlines(&decompressInfo, &row, 1);
+				}
+				jpeg_finish_decompress(&decompressInfo);
+			}
+			if(errorManager.num_warnings != 0)
+			{
+				toReturn.clear();
+			}
+		}
+		catch(const std::runtime_error&)
+		{
+			toReturn.clear();
+		}
+		jpeg_destroy_decompress(&decompressInfo);
+		return toReturn;
+	}
+
+
+	double psnr(const std::vector<uint8_t>& original, const std::vector<uint8_t>& decoded)
+	{
+		double sumOfSquaredErrors = 0.0;
+		for(size_t i = 0; i < original.size(); i++)
+		{
+			const double error = (double)original[i] - decoded[i];
+			sumOfSquaredErrors += error * error;
+		}
+		return 10.0 * log10(255.0 * 255.0 / (sumOfSquaredErrors / original.size()));
+	}
+}
+
+
+class FastJpegEncoderTests : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		if(!IGCS::FastJpegEncoder::isSupported())
+		{
+			GTEST_SKIP() << "the fast jpeg encoder isn't supported by this CPU";
+		}
+	}
+};
+
+
+TEST_F(FastJpegEncoderTests, MatchesStbInSizeAndQualityAtTheQualityUsed)
+{
+	// the quality the screenshot writer uses. Both encoders use the same tables and don't subsample chroma at this quality.
+	constexpr uint32_t width = 1920;
+	constexpr uint32_t height = 1080;
+	const auto image = createTestImage(width, height);
+	const auto stbData = encodeWithStb(image, width, height, 98);
+	const auto fastData = encodeFast(image, width, height, 98, 1);
+	const auto stbDecoded = decode(stbData, width, height);
+	const auto fastDecoded = decode(fastData, width, height);
+	ASSERT_FALSE(stbDecoded.empty());
+	ASSERT_FALSE(fastDecoded.empty());
+	const double stbPsnr = psnr(image, stbDecoded);
+	const double fastPsnr = psnr(image, fastDecoded);
+	printf("quality 98: stb %zu bytes, %.2f dB. fast %zu bytes, %.2f dB\n", stbData.size(), stbPsnr, fastData.size(), fastPsnr);
+	EXPECT_GT(fastPsnr, stbPsnr - 0.25);
+	EXPECT_LT((double)fastData.size(), stbData.size() * 1.02);
+}
+
+
+TEST_F(FastJpegEncoderTests, KeepsChromaDetailBelowQuality90)
+{
+	// stb subsamples chroma below quality 90, the fast encoder doesn't: its files are larger but of higher quality, see encodeImageToMemory.
+	constexpr uint32_t width = 1920;
+	constexpr uint32_t height = 1080;
+	const auto image = createTestImage(width, height);
+	const auto stbData = encodeWithStb(image, width, height, 75);
+	const auto fastData = encodeFast(image, width, height, 75, 1);
+	const auto stbDecoded = decode(stbData, width, height);
+	const auto fastDecoded = decode(fastData, width, height);
+	ASSERT_FALSE(stbDecoded.empty());
+	ASSERT_FALSE(fastDecoded.empty());
+	const double stbPsnr = psnr(image, stbDecoded);
+	const double fastPsnr = psnr(image, fastDecoded);
+	printf("quality 75: stb %zu bytes, %.2f dB. fast %zu bytes, %.2f dB\n", stbData.size(), stbPsnr, fastData.size(), fastPsnr);
+	EXPECT_GT(fastData.size(), stbData.size());
+	EXPECT_GT(fastPsnr, stbPsnr);
+}
+
+
+TEST_F(FastJpegEncoderTests, ParallelEncodingDecodesToTheSamePixels)
+{
+	// an odd size, so the last MCU row and column are partial.
+	constexpr uint32_t width = 1923;
+	constexpr uint32_t height = 1077;
+	const auto image = createTestImage(width, height);
+	const auto singleThreadedDecoded = decode(encodeFast(image, width, height, 98, 1), width, height);
+	const auto parallelDecoded = decode(encodeFast(image, width, height, 98, 4), width, height);
+	ASSERT_FALSE(singleThreadedDecoded.empty());
+	EXPECT_EQ(singleThreadedDecoded, parallelDecoded);
+}
+
+
+TEST_F(FastJpegEncoderTests, EncodesImagesSmallerThanAnMcu)
+{
+	const auto image = createTestImage(5, 3);
+	EXPECT_FALSE(decode(encodeFast(image, 5, 3, 98, 1), 5, 3).empty());
+}
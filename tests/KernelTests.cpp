@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "ImageUtils.h"
+#include "LerpUtils.h"
+
+using namespace IGCS;
+
+namespace
+{
+	std::vector<LerpUtils::LerpKernel> supportedLerpKernels()
+	{
+		std::vector<LerpUtils::LerpKernel> toReturn;
+		for(int i = 0; i <= static_cast<int>(LerpUtils::bestSupportedLerpKernel()); i++)
+		{
+			toReturn.push_back(static_cast<LerpUtils::LerpKernel>(i));
+		}
+		return toReturn;
+	}
+
+
+	std::vector<ImageUtils::PackKernel> supportedPackKernels()
+	{
+		std::vector<ImageUtils::PackKernel> toReturn;
+		for(int i = 0; i <= static_cast<int>(ImageUtils::bestSupportedPackKernel()); i++)
+		{
+			toReturn.push_back(static_cast<ImageUtils::PackKernel>(i));
+		}
+		return toReturn;
+	}
+}
+
+
+TEST(LerpUtilsTests, EveryKernelMatchesTheScalarResult)
+{
+	// an odd length so the tail after the last full vector is done too.
+	constexpr size_t numberOfFloats = 1027;
+	std::vector<float> start(numberOfFloats), delta(numberOfFloats), expected(numberOfFloats), actual(numberOfFloats);
+	for(size_t i = 0; i < numberOfFloats; i++)
+	{
+		start[i] = static_cast<float>(i) * 0.5f;
+		delta[i] = static_cast<float>(numberOfFloats - i) * -0.25f;
+	}
+	LerpUtils::lerpFloats(start.data(), delta.data(), 0.3f, expected.data(), numberOfFloats, LerpUtils::LerpKernel::Scalar);
+	for(auto kernel : supportedLerpKernels())
+	{
+		SCOPED_TRACE(LerpUtils::lerpKernelName(kernel));
+		std::fill(actual.begin(), actual.end(), 0.0f);
+		LerpUtils::lerpFloats(start.data(), delta.data(), 0.3f, actual.data(), numberOfFloats, kernel);
+		for(size_t i = 0; i < numberOfFloats; i++)
+		{
+			ASSERT_NEAR(expected[i], actual[i], 1e-4f) << "index " << i;
+		}
+	}
+}
+
+
+TEST(LerpUtilsTests, EveryCubicKernelMatchesTheScalarResult)
+{
+	constexpr size_t numberOfFloats = 517;
+	std::vector<float> a(numberOfFloats), b(numberOfFloats), c(numberOfFloats), d(numberOfFloats), expected(numberOfFloats), actual(numberOfFloats);
+	for(size_t i = 0; i < numberOfFloats; i++)
+	{
+		a[i] = static_cast<float>(i);
+		b[i] = 1.0f - static_cast<float>(i) * 0.01f;
+		c[i] = 0.5f;
+		d[i] = static_cast<float>(i % 7) - 3.0f;
+	}
+	constexpr float t = 0.7f;
+	for(size_t i = 0; i < numberOfFloats; i++)
+	{
+		expected[i] = a[i] + b[i] * t + c[i] * t * t + d[i] * t * t * t;
+	}
+	for(auto kernel : supportedLerpKernels())
+	{
+		SCOPED_TRACE(LerpUtils::lerpKernelName(kernel));
+		LerpUtils::evaluateCubicFloats(a.data(), b.data(), c.data(), d.data(), t, actual.data(), numberOfFloats, kernel);
+		for(size_t i = 0; i < numberOfFloats; i++)
+		{
+			ASSERT_NEAR(expected[i], actual[i], 1e-3f) << "index " << i;
+		}
+	}
+}
+
+
+TEST(ImageUtilsTests, EveryPackKernelDropsTheAlphaChannel)
+{
+	constexpr size_t numberOfPixels = 1001;
+	std::vector<uint8_t> rgba(numberOfPixels * 4);
+	for(size_t i = 0; i < rgba.size(); i++)
+	{
+		rgba[i] = static_cast<uint8_t>(i * 7);
+	}
+	for(auto kernel : supportedPackKernels())
+	{
+		SCOPED_TRACE(ImageUtils::packKernelName(kernel));
+		std::vector<uint8_t> rgb(numberOfPixels * 3);
+		ImageUtils::packRGBAToRGB(rgba.data(), rgb.data(), numberOfPixels, kernel);
+		for(size_t i = 0; i < numberOfPixels; i++)
+		{
+			ASSERT_EQ(rgba[i * 4], rgb[i * 3]) << "pixel " << i;
+			ASSERT_EQ(rgba[i * 4 + 1], rgb[i * 3 + 1]) << "pixel " << i;
+			ASSERT_EQ(rgba[i * 4 + 2], rgb[i * 3 + 2]) << "pixel " << i;
+		}
+	}
+}
+
+
+TEST(ImageUtilsTests, EveryPackKernelPacksInPlace)
+{
+	constexpr size_t numberOfPixels = 777;
+	std::vector<uint8_t> rgba(numberOfPixels * 4);
+	for(size_t i = 0; i < rgba.size(); i++)
+	{
+		rgba[i] = static_cast<uint8_t>(i * 13);
+	}
+	std::vector<uint8_t> expected(numberOfPixels * 3);
+	ImageUtils::packRGBAToRGB(rgba.data(), expected.data(), numberOfPixels, ImageUtils::PackKernel::Scalar);
+	for(auto kernel : supportedPackKernels())
+	{
+		SCOPED_TRACE(ImageUtils::packKernelName(kernel));
+		std::vector<uint8_t> buffer = rgba;
+		ImageUtils::packRGBAToRGB(buffer.data(), buffer.data(), numberOfPixels, kernel);
+		ASSERT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+	}
+}
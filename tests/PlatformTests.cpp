@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "Platform.h"
+
+using namespace IGCS;
+
+TEST(PlatformTests, CreatesADirectory)
+{
+	const auto directory = std::filesystem::temp_directory_path() / "IgcsConnectorTests_createDirectory";
+	std::filesystem::remove_all(directory);
+	ASSERT_TRUE(Platform::createDirectory(directory.string()));
+	EXPECT_TRUE(std::filesystem::is_directory(directory));
+	// creating it again isn't an error
+	EXPECT_TRUE(Platform::createDirectory(directory.string()));
+	std::filesystem::remove_all(directory);
+}
+
+
+TEST(PlatformTests, RemovesOnlyEmptyDirectories)
+{
+	const auto directory = std::filesystem::temp_directory_path() / "IgcsConnectorTests_removeEmptyDirectory";
+	std::filesystem::remove_all(directory);
+	ASSERT_TRUE(Platform::createDirectory(directory.string()));
+	{
+		std::ofstream file(directory / "1.jpg", std::ios::binary);
+		file << "shot";
+	}
+	EXPECT_FALSE(Platform::removeEmptyDirectory(directory.string()));
+	EXPECT_TRUE(std::filesystem::is_directory(directory));
+	std::filesystem::remove(directory / "1.jpg");
+	EXPECT_TRUE(Platform::removeEmptyDirectory(directory.string()));
+	EXPECT_FALSE(std::filesystem::exists(directory));
+}
+
+
+TEST(PlatformTests, MapsAFileForReading)
+{
+	const auto filename = (std::filesystem::temp_directory_path() / "IgcsConnectorTests_map.bin").string();
+	{
+		std::ofstream file(filename, std::ios::binary);
+		file << "IGCS connector";
+	}
+	size_t fileSize = 0;
+	const uint8_t* view = Platform::mapFileForReading(filename, fileSize);
+	ASSERT_NE(nullptr, view);
+	ASSERT_EQ(14u, fileSize);
+	EXPECT_EQ(0, memcmp(view, "IGCS connector", fileSize));
+	Platform::unmapFile(view, fileSize);
+	std::filesystem::remove(filename);
+
+	EXPECT_EQ(nullptr, Platform::mapFileForReading(filename, fileSize));
+}
+
+
+TEST(PlatformTests, ScratchFileViewsShareTheSameStorage)
+{
+	const auto filename = (std::filesystem::temp_directory_path() / "IgcsConnectorTests_scratch.tmp").string();
+	Platform::ScratchFile* file = Platform::createScratchFile(filename);
+	ASSERT_NE(nullptr, file);
+	const size_t granularity = Platform::mappingGranularity();
+	ASSERT_GT(granularity, 0u);
+	ASSERT_TRUE(Platform::resizeScratchFile(file, granularity * 2));
+
+	uint8_t* writeView = Platform::mapScratchFileView(file, granularity, granularity);
+	ASSERT_NE(nullptr, writeView);
+	memset(writeView, 0xAB, granularity);
+	Platform::unmapScratchFileView(writeView, granularity);
+
+	const uint8_t* readView = Platform::mapScratchFileView(file, granularity, granularity);
+	ASSERT_NE(nullptr, readView);
+	EXPECT_EQ(0xAB, readView[0]);
+	EXPECT_EQ(0xAB, readView[granularity - 1]);
+	Platform::unmapScratchFileView(const_cast<uint8_t*>(readView), granularity);
+	Platform::closeScratchFile(file);
+}
@@ -0,0 +1,485 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+#include "AllocationCounter.h"
+#include "FakeEffectRuntime.h"
+#include "ReshadeStateController.h"
+#include "ReshadeStateSnapshot.h"
+
+TEST(ReshadeStateSnapshotTests, AppliesTheObtainedState)
+{
+	FakeEffectRuntime runtime;
+	runtime.addSyntheticEffect("Bloom.fx", 16, 1.0f);
+	runtime.addSyntheticEffect("Vignette.fx", 8, 2.0f);
+	ReshadeStateSnapshot snapshot;
+	snapshot.obtainReshadeState(&runtime);
+	EXPECT_EQ(2, snapshot.numberOfContainedEffects());
+
+	float* values = runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform3");
+	ASSERT_NE(nullptr, values);
+	const float originalValue = values[0];
+	values[0] = -100.0f;
+	runtime.setTechniqueEnabled("Vignette.fx", "Vignette.fx_technique", false);
+
+	snapshot.applyState(&runtime);
+	EXPECT_FLOAT_EQ(originalValue, values[0]);
+	EXPECT_TRUE(runtime.isTechniqueEnabled("Vignette.fx", "Vignette.fx_technique"));
+}
+
+
+TEST(ReshadeStateSnapshotTests, SkipsEffectsWithoutEnabledTechniques)
+{
+	FakeEffectRuntime runtime;
+	runtime.addSyntheticEffect("Bloom.fx", 4);
+	runtime.addSyntheticEffect("Vignette.fx", 4);
+	runtime.setTechniqueEnabled("Vignette.fx", "Vignette.fx_technique", false);
+	ReshadeStateSnapshot snapshot;
+	snapshot.obtainReshadeState(&runtime);
+	EXPECT_EQ(1, snapshot.numberOfContainedEffects());
+}
+
+
+TEST(ReshadeStateSnapshotTests, MigratesToTheHandlesAfterAReload)
+{
+	FakeEffectRuntime runtime;
+	runtime.addSyntheticEffect("Bloom.fx", 8, 1.0f);
+	ReshadeStateSnapshot snapshot;
+	snapshot.obtainReshadeState(&runtime);
+
+	runtime.reloadEffects();
+	ReshadeStateSnapshot currentState;
+	currentState.obtainReshadeState(&runtime);
+	EXPECT_FALSE(snapshot.isBoundTo(currentState));
+	snapshot.migrateState(currentState);
+	EXPECT_TRUE(snapshot.isBoundTo(currentState));
+
+	float* values = runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1");
+	const float originalValue = values[0];
+	values[0] = 42.0f;
+	snapshot.applyState(&runtime);
+	EXPECT_FLOAT_EQ(originalValue, values[0]);
+}
+
+
+TEST(ReshadeStateSnapshotTests, MigratingAfterAReloadOfOneEffectOnlyReplacesItsState)
+{
+	FakeEffectRuntime runtime;
+	runtime.addSyntheticEffect("Bloom.fx", 8, 1.0f);
+	runtime.addSyntheticEffect("Vignette.fx", 8, 100.0f);
+	ReshadeStateSnapshot snapshot;
+	snapshot.obtainReshadeState(&runtime);
+	// the memory a migrated copy of the snapshot uses on top of the snapshot itself is the memory of the blocks it doesn't share with it.
+	const auto memoryUsageOfMigratedCopy = [&snapshot](const ReshadeStateSnapshot& currentState)
+	{
+		ReshadeStateSnapshot migratedSnapshot = snapshot;
+		migratedSnapshot.migrateState(currentState);
+		EXPECT_TRUE(migratedSnapshot.isBoundTo(currentState));
+		std::unordered_set<const void*> blocksCounted;
+		snapshot.memoryUsageInBytes(blocksCounted);
+		return migratedSnapshot.memoryUsageInBytes(blocksCounted);
+	};
+
+	runtime.reloadEffect("Bloom.fx");
+	ReshadeStateSnapshot stateAfterReloadingBloom;
+	stateAfterReloadingBloom.obtainReshadeState(&runtime);
+	EXPECT_FALSE(snapshot.isBoundTo(stateAfterReloadingBloom));
+	const size_t memoryUsageAfterReloadingBloom = memoryUsageOfMigratedCopy(stateAfterReloadingBloom);
+	runtime.reloadEffects();
+	ReshadeStateSnapshot stateAfterReloadingAll;
+	stateAfterReloadingAll.obtainReshadeState(&runtime);
+	const size_t memoryUsageAfterReloadingAll = memoryUsageOfMigratedCopy(stateAfterReloadingAll);
+	// the Vignette blocks are kept when only Bloom was reloaded.
+	EXPECT_GT(memoryUsageAfterReloadingBloom, 0u);
+	EXPECT_LT(memoryUsageAfterReloadingBloom, memoryUsageAfterReloadingAll);
+
+	ReshadeStateSnapshot migratedSnapshot = snapshot;
+	migratedSnapshot.migrateState(stateAfterReloadingAll);
+	float* bloomValues = runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1");
+	float* vignetteValues = runtime.uniformValues("Vignette.fx", "Vignette.fx_uniform1");
+	bloomValues[0] = -1.0f;
+	vignetteValues[0] = -1.0f;
+	migratedSnapshot.applyState(&runtime);
+	EXPECT_FLOAT_EQ(2.0f, bloomValues[0]);
+	EXPECT_FLOAT_EQ(101.0f, vignetteValues[0]);
+}
+
+
+class ReshadeStateControllerTests : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		_runtime.addSyntheticEffect("Bloom.fx", 8, 0.0f);
+		_controller.addCameraPath();
+		_controller.appendStateSnapshotToPath(0, &_runtime);
+		// move all values of the effect 10 up for the second state.
+		for(int i = 0; i < 8; i++)
+		{
+			float* values = _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform" + std::to_string(i));
+			for(int j = 0; j < 4; j++)
+			{
+				values[j] += 10.0f;
+			}
+		}
+		_controller.appendStateSnapshotToPath(0, &_runtime);
+	}
+
+	FakeEffectRuntime _runtime;
+	ReshadeStateController _controller;
+};
+
+
+TEST_F(ReshadeStateControllerTests, InterpolatesBetweenTheStatesOfAPath)
+{
+	ASSERT_EQ(2, _controller.numberOfSnapshotsOnPath(0));
+	_controller.setReshadeState(0, 0, 1, 0.25f, &_runtime);
+	// uniform1 is a float2 with value (1, 1.25) in the first state and (11, 11.25) in the second.
+	const float* values = _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1");
+	EXPECT_NEAR(3.5f, values[0], 1e-5f);
+	EXPECT_NEAR(3.75f, values[1], 1e-5f);
+
+	_controller.setReshadeState(0, 0, 1, 1.0f, &_runtime);
+	EXPECT_NEAR(11.0f, values[0], 1e-5f);
+}
+
+
+TEST_F(ReshadeStateControllerTests, SavedPathsLoadBackTheSame)
+{
+	const auto filename = (std::filesystem::temp_directory_path() / "IgcsConnectorTests_paths.bin").string();
+	ASSERT_TRUE(_controller.savePaths(filename));
+
+	ReshadeStateController loadedController;
+	ASSERT_TRUE(loadedController.loadPaths(filename, &_runtime));
+	std::filesystem::remove(filename);
+	ASSERT_EQ(1, loadedController.numberOfPaths());
+	ASSERT_EQ(2, loadedController.numberOfSnapshotsOnPath(0));
+
+	loadedController.setReshadeState(0, 0, &_runtime);
+	EXPECT_NEAR(1.0f, _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1")[0], 1e-5f);
+}
+
+
+TEST_F(ReshadeStateControllerTests, PlaybackDoesntAllocateOncePlanned)
+{
+	for(auto interpolationMode : { StateInterpolationMode::Linear, StateInterpolationMode::CatmullRom })
+	{
+		_controller.setInterpolationMode(interpolationMode);
+		// the first frame of a segment compiles its plan, which allocates.
+		_controller.setReshadeState(0, 0, 1, 0.0f, &_runtime);
+		const AllocationCounter allocationCounter;
+		for(int frame = 1; frame <= 100; frame++)
+		{
+			_controller.setReshadeState(0, 0, 1, (float)frame / 100.0f, &_runtime);
+		}
+		EXPECT_EQ(0u, allocationCounter.numberOfAllocations()) << "interpolation mode " << (int)interpolationMode;
+		EXPECT_NEAR(11.0f, _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1")[0], 1e-4f);
+	}
+}
+
+
+TEST_F(ReshadeStateControllerTests, MovingOnToTheNextSegmentUsesThePlanCompiledAhead)
+{
+	// a third state, with all values another 10 up.
+	for(int i = 0; i < 8; i++)
+	{
+		float* values = _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform" + std::to_string(i));
+		for(int j = 0; j < 4; j++)
+		{
+			values[j] += 10.0f;
+		}
+	}
+	_controller.appendStateSnapshotToPath(0, &_runtime);
+	ASSERT_EQ(3, _controller.numberOfSnapshotsOnPath(0));
+	// compiles the plan of the first segment and the one of the second segment ahead.
+	_controller.setReshadeState(0, 0, 1, 0.5f, &_runtime);
+	const AllocationCounter allocationCounter;
+	_controller.setReshadeState(0, 1, 2, 0.5f, &_runtime);
+	EXPECT_EQ(0u, allocationCounter.numberOfAllocations());
+	EXPECT_NEAR(16.0f, _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1")[0], 1e-4f);
+	// and back again.
+	_controller.setReshadeState(0, 0, 1, 0.5f, &_runtime);
+	EXPECT_NEAR(6.0f, _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1")[0], 1e-4f);
+}
+
+
+TEST_F(ReshadeStateControllerTests, PlaybackRacingWritersAlwaysSeesACompletePath)
+{
+	// the writer captures from its own runtime and the reader plays back into another one, as the fake runtime isn't thread safe. Both have the same
+	// effect, so the handles captured by the writer are valid in the reader's runtime.
+	FakeEffectRuntime playbackRuntime;
+	playbackRuntime.addSyntheticEffect("Bloom.fx", 8, 0.0f);
+	std::atomic<bool> writerIsDone = false;
+	std::thread writer([&]
+	{
+		for(int iteration = 0; iteration < 2000; iteration++)
+		{
+			// every value captured is between 0 and 20, like the values of the states added by SetUp.
+			for(int i = 0; i < 8; i++)
+			{
+				float* values = _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform" + std::to_string(i));
+				for(int j = 0; j < 4; j++)
+				{
+					values[j] = (float)(iteration % 21);
+				}
+			}
+			_controller.appendStateSnapshotToPath(0, &_runtime);
+			_controller.updateStateSnapshotOnPath(0, 1, &_runtime);
+			if(_controller.numberOfSnapshotsOnPath(0) > 8)
+			{
+				_controller.removeStateSnapshotFromPath(0, 0);
+			}
+			if(iteration % 100 == 0)
+			{
+				_controller.addCameraPath();
+				_controller.removeCameraPath(1);
+			}
+		}
+		writerIsDone = true;
+	});
+
+	// linear interpolation never leaves the range of the values captured, so a value outside it means playback saw a half written state.
+	int numberOfFramesPlayed = 0;
+	bool sawACompletePathEachFrame = true;
+	while(sawACompletePathEachFrame && (!writerIsDone || numberOfFramesPlayed < 100))
+	{
+		const int numberOfSnapshots = _controller.numberOfSnapshotsOnPath(0);
+		const int fromStateIndex = numberOfFramesPlayed % (std::max(numberOfSnapshots, 2) - 1);
+		// the path may have been changed since its number of snapshots was read, which playback has to cope with.
+		_controller.setReshadeState(0, fromStateIndex, fromStateIndex + 1, (float)(numberOfFramesPlayed % 10) / 10.0f, &playbackRuntime);
+		const float value = playbackRuntime.uniformValues("Bloom.fx", "Bloom.fx_uniform1")[0];
+		sawACompletePathEachFrame = numberOfSnapshots >= 2 && numberOfSnapshots <= 9 && value >= -1e-3f && value <= 20.0f + 1e-3f;
+		numberOfFramesPlayed++;
+	}
+	writer.join();
+	EXPECT_TRUE(sawACompletePathEachFrame) << "frame " << numberOfFramesPlayed;
+	EXPECT_EQ(8, _controller.numberOfSnapshotsOnPath(0));
+	EXPECT_EQ(1, _controller.numberOfPaths());
+}
+
+
+TEST_F(ReshadeStateControllerTests, FirstFrameOfASegmentSetsTheWholeState)
+{
+	// a third state in which only uniform1 differs from the second, so the segment from the second to the third has 1 interpolated uniform, 6 constant 
+	// ones and the technique.
+	float* uniform1Values = _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1");
+	uniform1Values[0] += 10.0f;
+	uniform1Values[1] += 10.0f;
+	_controller.appendStateSnapshotToPath(0, &_runtime);
+
+	_runtime.resetCounters();
+	_controller.setReshadeState(0, 1, 2, 0.0f, &_runtime);
+	EXPECT_EQ(8, _controller.numberOfRuntimeCallsMadeLastInterpolation());
+	EXPECT_EQ(0, _controller.numberOfRuntimeCallsSkippedLastInterpolation());
+	EXPECT_EQ(7, _runtime.numberOfUniformWrites());
+	EXPECT_EQ(1, _runtime.numberOfTechniqueStateChanges());
+
+	// the frames after it only set what's interpolated.
+	_runtime.resetCounters();
+	_controller.setReshadeState(0, 1, 2, 0.5f, &_runtime);
+	EXPECT_EQ(1, _controller.numberOfRuntimeCallsMadeLastInterpolation());
+	EXPECT_EQ(7, _controller.numberOfRuntimeCallsSkippedLastInterpolation());
+	EXPECT_EQ(1, _runtime.numberOfUniformWrites());
+	EXPECT_EQ(0, _runtime.numberOfTechniqueStateChanges());
+	EXPECT_NEAR(16.0f, uniform1Values[0], 1e-4f);
+
+	// after playing another segment, which sets uniform2 too, the first frame of the segment sets the whole state again.
+	_controller.setReshadeState(0, 0, 1, 0.5f, &_runtime);
+	_runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform2")[0] = -1.0f;
+	_runtime.resetCounters();
+	_controller.setReshadeState(0, 1, 2, 0.5f, &_runtime);
+	EXPECT_EQ(8, _controller.numberOfRuntimeCallsMadeLastInterpolation());
+	EXPECT_EQ(0, _controller.numberOfRuntimeCallsSkippedLastInterpolation());
+	EXPECT_EQ(7, _runtime.numberOfUniformWrites());
+	EXPECT_NEAR(12.0f, _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform2")[0], 1e-5f);
+}
+
+
+TEST_F(ReshadeStateControllerTests, ValuesChangingLessThanTheWriteEpsilonArentSet)
+{
+	// all 7 float uniforms go 10 up over the segment, so a step of 0.01 in the interpolation factor changes them by 0.1.
+	_controller.setUniformWriteEpsilon(0.5f);
+	_controller.setReshadeState(0, 0, 1, 0.0f, &_runtime);
+	const float* uniform1Values = _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1");
+
+	_runtime.resetCounters();
+	_controller.setReshadeState(0, 0, 1, 0.02f, &_runtime);
+	EXPECT_EQ(0, _controller.numberOfRuntimeCallsMadeLastInterpolation());
+	EXPECT_EQ(8, _controller.numberOfRuntimeCallsSkippedLastInterpolation());
+	EXPECT_EQ(0, _runtime.numberOfUniformWrites());
+	EXPECT_NEAR(1.0f, uniform1Values[0], 1e-5f);
+
+	// the values are compared with the ones written last, not the ones of the previous frame, so small steps don't add up unnoticed.
+	_controller.setReshadeState(0, 0, 1, 0.04f, &_runtime);
+	EXPECT_EQ(0, _controller.numberOfRuntimeCallsMadeLastInterpolation());
+	EXPECT_EQ(0, _runtime.numberOfUniformWrites());
+	_controller.setReshadeState(0, 0, 1, 0.06f, &_runtime);
+	EXPECT_EQ(7, _controller.numberOfRuntimeCallsMadeLastInterpolation());
+	EXPECT_EQ(1, _controller.numberOfRuntimeCallsSkippedLastInterpolation());
+	EXPECT_EQ(7, _runtime.numberOfUniformWrites());
+	EXPECT_NEAR(1.6f, uniform1Values[0], 1e-5f);
+
+	// without an epsilon every change is set.
+	_controller.setUniformWriteEpsilon(0.0f);
+	_runtime.resetCounters();
+	_controller.setReshadeState(0, 0, 1, 0.07f, &_runtime);
+	EXPECT_EQ(7, _controller.numberOfRuntimeCallsMadeLastInterpolation());
+	EXPECT_EQ(7, _runtime.numberOfUniformWrites());
+	EXPECT_NEAR(1.7f, uniform1Values[0], 1e-5f);
+}
+
+
+TEST_F(ReshadeStateControllerTests, CatmullRomPassesThroughTheNeighboursOfTheSegment)
+{
+	// two more states, so uniform1 goes 1, 11, 41, 21 over the path, which isn't a line.
+	float* uniform1Values = _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1");
+	for(float value : { 41.0f, 21.0f })
+	{
+		uniform1Values[0] = value;
+		_controller.appendStateSnapshotToPath(0, &_runtime);
+	}
+	ASSERT_EQ(4, _controller.numberOfSnapshotsOnPath(0));
+	const float pathValues[] = { 1.0f, 11.0f, 41.0f, 21.0f };
+	// the uniform Catmull-Rom spline from p1 to p2.
+	const auto catmullRom = [](float p0, float p1, float p2, float p3, float t)
+	{
+		return 0.5f * ((2.0f * p1) + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t * t + (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t * t * t);
+	};
+	_controller.setInterpolationMode(StateInterpolationMode::CatmullRom);
+	for(float t : { 0.25f, 0.5f, 0.75f })
+	{
+		// in the middle of the path both neighbours exist.
+		_controller.setReshadeState(0, 1, 2, t, &_runtime);
+		EXPECT_NEAR(catmullRom(pathValues[0], pathValues[1], pathValues[2], pathValues[3], t), uniform1Values[0], 1e-4f) << "t " << t;
+		// at the ends of the path the missing neighbour is the state at the end.
+		_controller.setReshadeState(0, 0, 1, t, &_runtime);
+		EXPECT_NEAR(catmullRom(pathValues[0], pathValues[0], pathValues[1], pathValues[2], t), uniform1Values[0], 1e-4f) << "t " << t;
+		_controller.setReshadeState(0, 2, 3, t, &_runtime);
+		EXPECT_NEAR(catmullRom(pathValues[1], pathValues[2], pathValues[3], pathValues[3], t), uniform1Values[0], 1e-4f) << "t " << t;
+		// played in reverse the neighbours swap sides.
+		_controller.setReshadeState(0, 2, 1, t, &_runtime);
+		EXPECT_NEAR(catmullRom(pathValues[3], pathValues[2], pathValues[1], pathValues[0], t), uniform1Values[0], 1e-4f) << "t " << t;
+		_controller.setReshadeState(0, 3, 2, t, &_runtime);
+		EXPECT_NEAR(catmullRom(pathValues[3], pathValues[3], pathValues[2], pathValues[1], t), uniform1Values[0], 1e-4f) << "t " << t;
+	}
+	// the spline passes through the states.
+	_controller.setReshadeState(0, 1, 2, 0.0f, &_runtime);
+	EXPECT_NEAR(11.0f, uniform1Values[0], 1e-4f);
+	_controller.setReshadeState(0, 1, 2, 1.0f, &_runtime);
+	EXPECT_NEAR(41.0f, uniform1Values[0], 1e-4f);
+	// and it isn't the line between them.
+	_controller.setReshadeState(0, 1, 2, 0.5f, &_runtime);
+	EXPECT_GT(std::fabs(26.0f - uniform1Values[0]), 1.0f);
+}
+
+
+TEST_F(ReshadeStateControllerTests, SnapshotsShareTheStateOfEffectsWhichDidntChange)
+{
+	// a path on which only Bloom changes and one on which both effects change, from a runtime with a second effect, Vignette, which is a lot larger.
+	_runtime.addSyntheticEffect("Vignette.fx", 64, 100.0f);
+	const auto addStateToBothPaths = [this](int numberOfState)
+	{
+		_runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1")[0] = (float)numberOfState;
+		_runtime.uniformValues("Vignette.fx", "Vignette.fx_uniform1")[0] = 0.0f;
+		_controller.appendStateSnapshotToPath(1, &_runtime);
+		_runtime.uniformValues("Vignette.fx", "Vignette.fx_uniform1")[0] = (float)numberOfState;
+		_controller.appendStateSnapshotToPath(2, &_runtime);
+	};
+	_controller.addCameraPath();
+	_controller.addCameraPath();
+	addStateToBothPaths(0);
+	const size_t memoryUsageOfASingleState = _controller.memoryUsageOfPathInBytes(1);
+	ASSERT_EQ(memoryUsageOfASingleState, _controller.memoryUsageOfPathInBytes(2));
+	for(int i = 1; i < 4; i++)
+	{
+		addStateToBothPaths(i);
+	}
+	ASSERT_EQ(4, _controller.numberOfSnapshotsOnPath(1));
+	const size_t memoryUsageOfOnlyBloomChanging = _controller.memoryUsageOfPathInBytes(1);
+	const size_t memoryUsageOfBothChanging = _controller.memoryUsageOfPathInBytes(2);
+	// the states on which Vignette didn't change all use the blocks of the first state for it, so 4 of them take less memory than 2 which share nothing.
+	EXPECT_LT(memoryUsageOfOnlyBloomChanging, 2 * memoryUsageOfASingleState);
+	EXPECT_LT(memoryUsageOfOnlyBloomChanging, memoryUsageOfBothChanging);
+	// the blocks with the ids are the same on every state of both paths, so they're shared too.
+	EXPECT_LT(memoryUsageOfBothChanging, 4 * memoryUsageOfASingleState);
+}
+
+
+TEST_F(ReshadeStateControllerTests, MigratingAfterAReloadKeepsEverySnapshotApplicable)
+{
+	// path 1 has both effects, Vignette has the same values in both of its states.
+	_runtime.addSyntheticEffect("Vignette.fx", 8, 100.0f);
+	_controller.addCameraPath();
+	_controller.appendStateSnapshotToPath(1, &_runtime);
+	float* bloomValues = _runtime.uniformValues("Bloom.fx", "Bloom.fx_uniform1");
+	float* vignetteValues = _runtime.uniformValues("Vignette.fx", "Vignette.fx_uniform1");
+	bloomValues[0] += 10.0f;
+	_controller.appendStateSnapshotToPath(1, &_runtime);
+
+	// nothing was reloaded, so the path is bound and kept, and with it the plan of the segment played: the next frame only sets the interpolated uniform.
+	_controller.setReshadeState(1, 0, 1, 0.5f, &_runtime);
+	_controller.migrateContainedHandles(&_runtime);
+	_controller.setReshadeState(1, 0, 1, 0.6f, &_runtime);
+	EXPECT_EQ(1, _controller.numberOfRuntimeCallsMadeLastInterpolation());
+	EXPECT_NEAR(17.0f, bloomValues[0], 1e-4f);
+
+	// after a reload of Bloom the path is migrated, and the first frame after it sets the whole state with the new handles.
+	_runtime.reloadEffect("Bloom.fx");
+	_controller.migrateContainedHandles(&_runtime);
+	bloomValues[0] = -1.0f;
+	vignetteValues[0] = -1.0f;
+	_controller.setReshadeState(1, 0, 1, 0.7f, &_runtime);
+	EXPECT_EQ(0, _controller.numberOfRuntimeCallsSkippedLastInterpolation());
+	EXPECT_NEAR(18.0f, bloomValues[0], 1e-4f);
+	EXPECT_FLOAT_EQ(101.0f, vignetteValues[0]);
+
+	// every state of both paths sets its own values.
+	const float expectedBloomValues[2][2] = { { 1.0f, 11.0f }, { 11.0f, 21.0f } };
+	for(int pathIndex = 0; pathIndex < 2; pathIndex++)
+	{
+		for(int stateIndex = 0; stateIndex < 2; stateIndex++)
+		{
+			bloomValues[0] = -1.0f;
+			vignetteValues[0] = -1.0f;
+			_controller.setReshadeState(pathIndex, stateIndex, &_runtime);
+			EXPECT_FLOAT_EQ(expectedBloomValues[pathIndex][stateIndex], bloomValues[0]) << "path " << pathIndex << " state " << stateIndex;
+			// path 0 was made before Vignette was added, so it doesn't touch it.
+			EXPECT_FLOAT_EQ(pathIndex == 0 ? -1.0f : 101.0f, vignetteValues[0]) << "path " << pathIndex << " state " << stateIndex;
+		}
+	}
+}
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include "FrameBufferPool.h"
+#include "Platform.h"
+#include "ScreenshotWriter.h"
+
+namespace
+{
+	const uint32_t SHOT_WIDTH = 64;
+	const uint32_t SHOT_HEIGHT = 48;
+
+	std::filesystem::path createSessionFolder(const std::string& name)
+	{
+		const auto folder = std::filesystem::temp_directory_path() / name;
+		std::filesystem::remove_all(folder);
+		IGCS::Platform::createDirectory(folder.string());
+		return folder;
+	}
+
+
+	void addShots(ScreenshotWriter& writer, FrameBufferPool& pool, int numberOfShots)
+	{
+		for(int i = 0; i < numberOfShots; i++)
+		{
+			FrameBuffer shot = pool.tryAcquire((size_t)SHOT_WIDTH * SHOT_HEIGHT * 3);
+			ASSERT_FALSE(shot.isEmpty());
+			for(size_t j = 0; j < shot.size(); j++)
+			{
+				shot.data()[j] = (uint8_t)(i + j);
+			}
+			writer.addShot(std::move(shot), SHOT_WIDTH, SHOT_HEIGHT, i);
+		}
+	}
+}
+
+
+TEST(ScreenshotWriterTests, WritesAFilePerShot)
+{
+	const auto folder = createSessionFolder("IgcsConnectorTests_writer");
+	FrameBufferPool pool;
+	ScreenshotWriter writer;
+	writer.start(folder.string(), ScreenshotFiletype::Bmp, false);
+	addShots(writer, pool, 10);
+	writer.waitForCompletion();
+	EXPECT_EQ(0, writer.numberOfShotsToWrite());
+	EXPECT_EQ(0, pool.numberOfBuffersInUse());
+
+	int numberOfFiles = 0;
+	for(const auto& entry : std::filesystem::directory_iterator(folder))
+	{
+		numberOfFiles++;
+		// a 24 bit bmp has a 54 byte header and its rows are padded to 4 bytes, which 64 pixels already are.
+		EXPECT_EQ(54u + SHOT_WIDTH * SHOT_HEIGHT * 3, std::filesystem::file_size(entry.path())) << entry.path();
+	}
+	EXPECT_EQ(10, numberOfFiles);
+	for(int i = 0; i < 10; i++)
+	{
+		EXPECT_TRUE(std::filesystem::exists(folder / (std::to_string(i) + ".bmp"))) << i;
+	}
+	// the session folder is only removed if no shot was written to it.
+	EXPECT_FALSE(IGCS::Platform::removeEmptyDirectory(folder.string()));
+	std::filesystem::remove_all(folder);
+}
+
+
+TEST(ScreenshotWriterTests, SessionWithoutShotsLeavesNoFolderBehind)
+{
+	const auto folder = createSessionFolder("IgcsConnectorTests_writerWithoutShots");
+	FrameBufferPool pool;
+	ScreenshotWriter writer;
+	writer.start(folder.string(), ScreenshotFiletype::Bmp, false);
+	writer.waitForCompletion();
+	// like a session which is canceled before its shots are encoded: none of them is written.
+	writer.start(folder.string(), ScreenshotFiletype::Bmp, false);
+	writer.cancel();
+	addShots(writer, pool, 10);
+	writer.waitForCompletion();
+	EXPECT_EQ(0, pool.numberOfBuffersInUse());
+
+	// the screenshot controller removes the session folder this way at the end of every session.
+	EXPECT_TRUE(IGCS::Platform::removeEmptyDirectory(folder.string()));
+	EXPECT_FALSE(std::filesystem::exists(folder));
+}
+
+
+TEST(ScreenshotWriterTests, CancelingWakesTheEncodersWaitingForTheFileWriter)
+{
+	// far more shots than encoded shots may wait for the file writer, so encoders end up waiting for room when the cancel comes in.
+	const auto folder = createSessionFolder("IgcsConnectorTests_writerCanceled");
+	FrameBufferPool pool;
+	ScreenshotWriter writer;
+	writer.start(folder.string(), ScreenshotFiletype::Bmp, false);
+	addShots(writer, pool, 200);
+	writer.cancel();
+	writer.waitForCompletion();
+	EXPECT_EQ(0, writer.numberOfShotsToWrite());
+	EXPECT_EQ(0, pool.numberOfBuffersInUse());
+	// the shots which were being encoded or written when the cancel came in are completed.
+	for(const auto& entry : std::filesystem::directory_iterator(folder))
+	{
+		EXPECT_EQ(54u + SHOT_WIDTH * SHOT_HEIGHT * 3, std::filesystem::file_size(entry.path())) << entry.path();
+	}
+	std::filesystem::remove_all(folder);
+}
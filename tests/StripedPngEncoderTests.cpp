@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "StripedPngEncoder.h"
+
+namespace
+{
+	std::vector<uint8_t> createTestImage(uint32_t width, uint32_t height, uint32_t numberOfChannels)
+	{
+		// gradients and noise, so the filters and the deflate both have something to do.
+		std::vector<uint8_t> image((size_t)width * height * numberOfChannels);
+		uint32_t seed = 1;
+		for(size_t i = 0; i < image.size(); i++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			const size_t pixelIndex = i / numberOfChannels;
+			image[i] = (uint8_t)((pixelIndex % width) + (pixelIndex / width) * 3 + ((seed >> 24) & 15));
+		}
+		return image;
+	}
+
+
+	uint32_t readBigEndian(const uint8_t* source)
+	{
+		return ((uint32_t)source[0] << 24) | ((uint32_t)source[1] << 16) | ((uint32_t)source[2] << 8) | source[3];
+	}
+
+
+	uint8_t paethPredictor(int left, int up, int upLeft)
+	{
+		const int estimate = left + up - upLeft;
+		const int distanceLeft = std::abs(estimate - left);
+		const int distanceUp = std::abs(estimate - up);
+		const int distanceUpLeft = std::abs(estimate - upLeft);
+		if(distanceLeft <= distanceUp && distanceLeft <= distanceUpLeft)
+		{
+			return (uint8_t)left;
+		}
+		return (uint8_t)(distanceUp <= distanceUpLeft ? up : upLeft);
+	}
+
+
+	/// <summary>
+	/// Decodes the png specified with zlib and checks it along the way: the chunk crcs, the IHDR and the zlib stream formed by the IDAT chunks. Returns
+	/// the unfiltered pixels, or an empty vector if the png is invalid.
+	/// </summary>
+	std::vector<uint8_t> decodePng(const std::vector<uint8_t>& png, uint32_t expectedWidth, uint32_t expectedHeight, uint32_t numberOfChannels, int& numberOfIdatChunks)
+	{
+		static const uint8_t pngSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+		numberOfIdatChunks = 0;
+		if(png.size() < sizeof(pngSignature) || memcmp(png.data(), pngSignature, sizeof(pngSignature)) != 0)
+		{
+			ADD_FAILURE() << "no png signature";
+			return {};
+		}
+		std::vector<uint8_t> deflatedData;
+		bool iendFound = false;
+		for(size_t offset = sizeof(pngSignature); offset < png.size() && !iendFound;)
+		{
+			if(png.size() - offset < 12)
+			{
+				ADD_FAILURE() << "truncated chunk at " << offset;
+				return {};
+			}
+			const uint32_t length = readBigEndian(&png[offset]);
+			const uint8_t* type = &png[offset + 4];
+			if(png.size() - offset - 12 < length)
+			{
+				ADD_FAILURE() << "chunk at " << offset << " runs past the end";
+				return {};
+			}
+			const uint8_t* data = type + 4;
+			// the crc covers the type and the data.
+			EXPECT_EQ(crc32(0, type, 4 + length), readBigEndian(data + length)) << "chunk " << std::string((const char*)type, 4) << " at " << offset;
+			if(memcmp(type, "IHDR", 4) == 0)
+			{
+				EXPECT_EQ(expectedWidth, readBigEndian(data));
+				EXPECT_EQ(expectedHeight, readBigEndian(data + 4));
+			}
+			else if(memcmp(type, "IDAT", 4) == 0)
+			{
+				deflatedData.insert(deflatedData.end(), data, data + length);
+				numberOfIdatChunks++;
+			}
+			iendFound = memcmp(type, "IEND", 4) == 0;
+			offset += 12 + length;
+		}
+		EXPECT_TRUE(iendFound);
+
+		// a filter type byte per row, followed by the row. inflate checks the adler32 in the zlib trailer.
+		const size_t numberOfBytesPerRow = (size_t)expectedWidth * numberOfChannels;
+		std::vector<uint8_t> filteredData(expectedHeight * (numberOfBytesPerRow + 1));
+		z_stream stream = {};
+		inflateInit(&stream);
+		stream.next_in = deflatedData.data();
+		stream.avail_in = (uInt)deflatedData.size();
+		stream.next_out = filteredData.data();
+		stream.avail_out = (uInt)filteredData.size();
+		const int inflateResult = inflate(&stream, Z_FINISH);
+		inflateEnd(&stream);
+		if(inflateResult != Z_STREAM_END || stream.avail_out != 0 || stream.avail_in != 0)
+		{
+			ADD_FAILURE() << "the IDAT chunks don't form a single zlib stream of the image, inflate returned " << inflateResult;
+			return {};
+		}
+
+		std::vector<uint8_t> pixels(expectedHeight * numberOfBytesPerRow);
+		for(uint32_t y = 0; y < expectedHeight; y++)
+		{
+			const uint8_t filterType = filteredData[y * (numberOfBytesPerRow + 1)];
+			const uint8_t* filteredRow = &filteredData[y * (numberOfBytesPerRow + 1) + 1];
+			uint8_t* row = &pixels[y * numberOfBytesPerRow];
+			const uint8_t* previousRow = y > 0 ? row - numberOfBytesPerRow : nullptr;
+			for(size_t i = 0; i < numberOfBytesPerRow; i++)
+			{
+				const int left = i >= numberOfChannels ? row[i - numberOfChannels] : 0;
+				const int up = nullptr != previousRow ? previousRow[i] : 0;
+				const int upLeft = (nullptr != previousRow && i >= numberOfChannels) ? previousRow[i - numberOfChannels] : 0;
+				uint8_t predictor = 0;
+				switch(filterType)
+				{
+				case 0: predictor = 0; break;
+				case 1: predictor = (uint8_t)left; break;
+				case 2: predictor = (uint8_t)up; break;
+				case 3: predictor = (uint8_t)((left + up) / 2); break;
+				case 4: predictor = paethPredictor(left, up, upLeft); break;
+				default:
+					ADD_FAILURE() << "unknown filter type " << (int)filterType << " in row " << y;
+					return {};
+				}
+				row[i] = (uint8_t)(filteredRow[i] + predictor);
+			}
+		}
+		return pixels;
+	}
+
+
+	void expectEncodesLosslessly(uint32_t width, uint32_t height, uint32_t numberOfChannels, uint32_t numberOfStripes, int expectedNumberOfIdatChunks)
+	{
+		const std::vector<uint8_t> image = createTestImage(width, height, numberOfChannels);
+		std::vector<uint8_t> encodedData;
+		ASSERT_TRUE(IGCS::StripedPngEncoder::encodeImageToMemory(image.data(), width, height, numberOfChannels, encodedData, 4, numberOfStripes));
+		int numberOfIdatChunks = 0;
+		const std::vector<uint8_t> decodedImage = decodePng(encodedData, width, height, numberOfChannels, numberOfIdatChunks);
+		EXPECT_EQ(expectedNumberOfIdatChunks, numberOfIdatChunks);
+		EXPECT_TRUE(decodedImage == image);
+
+		// the stripes are the same whichever thread encodes them.
+		std::vector<uint8_t> encodedOnOneThread;
+		ASSERT_TRUE(IGCS::StripedPngEncoder::encodeImageToMemory(image.data(), width, height, numberOfChannels, encodedOnOneThread, 1, numberOfStripes));
+		EXPECT_TRUE(encodedOnOneThread == encodedData);
+	}
+}
+
+
+TEST(StripedPngEncoderTests, EncodesASingleStripe)
+{
+	expectEncodesLosslessly(100, 200, 3, 1, 1);
+}
+
+
+TEST(StripedPngEncoderTests, EncodesSeveralStripes)
+{
+	// a stripe per IDAT chunk.
+	expectEncodesLosslessly(100, 256, 3, 4, 4);
+	expectEncodesLosslessly(100, 256, 4, 4, 4);
+}
+
+
+TEST(StripedPngEncoderTests, EncodesRowsWhichDontDivideEvenlyOverTheStripes)
+{
+	// 84, 84 and 82 rows.
+	expectEncodesLosslessly(101, 250, 3, 3, 3);
+	// stripes have at least 64 rows, so 10 stripes of 100 rows become 1.
+	expectEncodesLosslessly(37, 100, 3, 10, 1);
+}
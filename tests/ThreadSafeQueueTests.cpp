@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ThreadSafeQueue.h"
+
+using namespace IGCS;
+
+TEST(ThreadSafeQueueTests, PopsInPushOrder)
+{
+	ThreadSafeQueue<int, 8> queue;
+	for(int i = 0; i < 8; i++)
+	{
+		ASSERT_TRUE(queue.tryPush(i));
+	}
+	for(int i = 0; i < 8; i++)
+	{
+		auto value = queue.pop();
+		ASSERT_TRUE(value.has_value());
+		EXPECT_EQ(i, *value);
+	}
+	EXPECT_FALSE(queue.pop().has_value());
+}
+
+
+TEST(ThreadSafeQueueTests, TryPushFailsWhenFull)
+{
+	ThreadSafeQueue<std::string, 4> queue;
+	for(int i = 0; i < 4; i++)
+	{
+		ASSERT_TRUE(queue.tryPush(std::to_string(i)));
+	}
+	EXPECT_FALSE(queue.tryPush(std::string("overflow")));
+	EXPECT_EQ("0", *queue.pop());
+	EXPECT_TRUE(queue.tryPush(std::string("4")));
+}
+
+
+TEST(ThreadSafeQueueTests, DrainVisitsEveryElement)
+{
+	ThreadSafeQueue<int, 16> queue;
+	for(int i = 0; i < 10; i++)
+	{
+		queue.tryPush(i);
+	}
+	std::vector<int> drained;
+	queue.drain([&](int&& value) { drained.push_back(value); });
+	ASSERT_EQ(10u, drained.size());
+	for(int i = 0; i < 10; i++)
+	{
+		EXPECT_EQ(i, drained[i]);
+	}
+	EXPECT_FALSE(queue.pop().has_value());
+}
+
+
+TEST(ThreadSafeQueueTests, DrainStopsAtTheMaximumNumberOfElements)
+{
+	ThreadSafeQueue<int, 16> queue;
+	for(int i = 0; i < 10; i++)
+	{
+		queue.tryPush(i);
+	}
+	std::vector<int> drained;
+	EXPECT_EQ(4u, queue.drain([&](int&& value) { drained.push_back(value); }, 4));
+	EXPECT_EQ((std::vector<int>{ 0, 1, 2, 3 }), drained);
+	// fewer elements than the maximum means the queue is empty.
+	EXPECT_EQ(6u, queue.drain([&](int&& value) { drained.push_back(value); }, 8));
+	EXPECT_EQ(10u, drained.size());
+	EXPECT_FALSE(queue.pop().has_value());
+}
+
+
+TEST(ThreadSafeQueueTests, MultipleProducersLoseNothing)
+{
+	constexpr int numberOfProducers = 4;
+	constexpr int numberOfItemsPerProducer = 20000;
+	ThreadSafeQueue<int, 256> queue;
+	std::vector<std::thread> producers;
+	for(int p = 0; p < numberOfProducers; p++)
+	{
+		producers.emplace_back([&queue, p]
+		{
+			for(int i = 0; i < numberOfItemsPerProducer; i++)
+			{
+				while(!queue.tryPush(p * numberOfItemsPerProducer + i))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	std::vector<int> lastSeenPerProducer(numberOfProducers, -1);
+	int numberOfItemsPopped = 0;
+	while(numberOfItemsPopped < numberOfProducers * numberOfItemsPerProducer)
+	{
+		auto value = queue.pop();
+		if(!value.has_value())
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		// items of a single producer arrive in the order they were pushed.
+		const int producer = *value / numberOfItemsPerProducer;
+		const int index = *value % numberOfItemsPerProducer;
+		ASSERT_GT(index, lastSeenPerProducer[producer]);
+		lastSeenPerProducer[producer] = index;
+		numberOfItemsPopped++;
+	}
+	for(auto& producer : producers)
+	{
+		producer.join();
+	}
+	EXPECT_FALSE(queue.pop().has_value());
+}
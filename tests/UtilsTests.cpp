@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "FakeReshade.h"
+#include "Platform.h"
+#include "Utils.h"
+
+using namespace IGCS;
+
+TEST(UtilsTests, FormatsAllArguments)
+{
+	const std::string formatted = Utils::formatString("%ux%u, %d effects, %s", 3840u, 2160u, 64, "done");
+	EXPECT_EQ("3840x2160, 64 effects, done", formatted);
+	EXPECT_EQ(formatted.size(), strlen(formatted.c_str()));
+}
+
+
+TEST(UtilsTests, PlacesFilesInTheReshadeBaseFolder)
+{
+	const std::string separator(1, Platform::PATH_SEPARATOR);
+	FakeReshade::setBasePath("games" + separator + "game");
+	EXPECT_EQ("games" + separator + "game" + separator + "paths.bin", Utils::pathInReshadeBaseFolder("paths.bin"));
+	FakeReshade::setBasePath("games" + separator + "game" + separator);
+	EXPECT_EQ("games" + separator + "game" + separator + "paths.bin", Utils::pathInReshadeBaseFolder("paths.bin"));
+	FakeReshade::setBasePath("");
+	EXPECT_EQ("paths.bin", Utils::pathInReshadeBaseFolder("paths.bin"));
+	FakeReshade::setBasePath(std::filesystem::temp_directory_path().string());
+}
@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////
+//
+// Part of IGCS Connector, an add on for Reshade 5+ which allows you
+// to connect IGCS built camera tools with reshade to exchange data and control
+// from Reshade.
+// 
+// (c) Frans 'Otis_Inf' Bouma.
+//
+// All rights reserved.
+// https://github.com/FransBouma/IgcsConnector
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+//
+//  * Redistributions of source code must retain the above copyright notice, this
+//	  list of conditions and the following disclaimer.
+//
+//  * Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and / or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "AllocationCounter.h"
+#include "FakeEffectRuntime.h"
+#include "ThreadSafeQueue.h"
+#include "WorkItem.h"
+
+TEST(WorkItemTests, PerformsTheCallable)
+{
+	FakeEffectRuntime runtime;
+	reshade::api::effect_runtime* runtimePassed = nullptr;
+	WorkItem workItem([&runtimePassed](reshade::api::effect_runtime* lambdaRuntime) { runtimePassed = lambdaRuntime; });
+	EXPECT_EQ(WorkItem::NO_COALESCING_KEY, workItem.coalescingKey());
+	EXPECT_EQ(WorkItemCost::Light, workItem.cost());
+	workItem.perform(&runtime);
+	EXPECT_EQ(&runtime, runtimePassed);
+}
+
+
+TEST(WorkItemTests, MovingTransfersTheCallableAndDestroysItOnce)
+{
+	auto captured = std::make_shared<int>(0);
+	{
+		WorkItem workItem(WorkItemCost::Heavy, [captured](reshade::api::effect_runtime*) { (*captured)++; });
+		EXPECT_EQ(2, captured.use_count());
+		WorkItem movedTo(std::move(workItem));
+		EXPECT_EQ(2, captured.use_count());
+		EXPECT_EQ(WorkItemCost::Heavy, movedTo.cost());
+		workItem.perform(nullptr);
+		movedTo.perform(nullptr);
+		EXPECT_EQ(1, *captured);
+	}
+	EXPECT_EQ(1, captured.use_count());
+}
+
+
+TEST(WorkItemTests, QueueingAndPerformingDoesntAllocate)
+{
+	FakeEffectRuntime runtime;
+	auto queue = std::make_unique<IGCS::ThreadSafeQueue<WorkItem, 64>>();
+	int pathIndexSum = 0;
+	float lastInterpolationFactor = 0.0f;
+
+	const AllocationCounter allocationCounter;
+	for(int frame = 0; frame < 1000; frame++)
+	{
+		// the captures of the largest work item Main queues: a path index, two state indices and an interpolation factor, plus a pointer here.
+		const int pathIndex = frame % 3;
+		const int fromStateIndex = 1;
+		const int toStateIndex = 2;
+		const float interpolationFactor = (float)frame / 1000.0f;
+		ASSERT_TRUE(queue->tryPush({ (uint64_t)pathIndex + 1, [&pathIndexSum, &lastInterpolationFactor, pathIndex, fromStateIndex, toStateIndex, interpolationFactor]
+			(reshade::api::effect_runtime*)
+		{
+			pathIndexSum += pathIndex + fromStateIndex + toStateIndex;
+			lastInterpolationFactor = interpolationFactor;
+		} }));
+		ASSERT_TRUE(queue->tryPush({ WorkItemCost::Heavy, [&pathIndexSum](reshade::api::effect_runtime*) { pathIndexSum++; } }));
+		// drained, like handleWorkQueue does.
+		queue->drain([&runtime](WorkItem&& workItem) { workItem.perform(&runtime); });
+	}
+	EXPECT_EQ(0u, allocationCounter.numberOfAllocations());
+	EXPECT_FLOAT_EQ(0.999f, lastInterpolationFactor);
+	EXPECT_EQ(999 + 1000 * 3 + 1000, pathIndexSum);
+}
+
+
+namespace
+{
+	/// <summary>
+	/// Marks the superseded work items of the batch with the coalescing keys specified, NO_COALESCING_KEY for work without one.
+	/// </summary>
+	std::vector<bool> markSuperseded(const std::vector<uint64_t>& coalescingKeys)
+	{
+		std::vector<WorkItem> workItems;
+		for(const uint64_t coalescingKey : coalescingKeys)
+		{
+			workItems.emplace_back(coalescingKey, [](reshade::api::effect_runtime*) {});
+		}
+		std::vector<bool> isSuperseded;
+		std::vector<uint64_t> supersedingKeys;
+		const size_t numberOfWorkItemsSuperseded = markSupersededWorkItems(workItems, isSuperseded, supersedingKeys);
+		EXPECT_EQ((size_t)std::count(isSuperseded.begin(), isSuperseded.end(), true), numberOfWorkItemsSuperseded);
+		return isSuperseded;
+	}
+}
+
+
+TEST(WorkItemTests, OnlyTheLastWorkItemOfAKeyIsPerformed)
+{
+	EXPECT_EQ((std::vector<bool>{ true, true, false }), markSuperseded({ 1, 1, 1 }));
+}
+
+
+TEST(WorkItemTests, WorkWithoutAKeyBlocksCoalescingAcrossIt)
+{
+	const uint64_t noKey = WorkItem::NO_COALESCING_KEY;
+	EXPECT_EQ((std::vector<bool>{ true, false, false, false }), markSuperseded({ 1, 1, noKey, 1 }));
+}
+
+
+TEST(WorkItemTests, WorkItemsWithDifferentKeysAreKept)
+{
+	EXPECT_EQ((std::vector<bool>{ true, true, false, false }), markSuperseded({ 1, 2, 2, 1 }));
+	EXPECT_EQ((std::vector<bool>{ false, false, false }), markSuperseded({ 1, 2, 3 }));
+}
+
+
+TEST(WorkItemTests, WorkAfterDeferredHeavyWorkIsDeferredInOrder)
+{
+	// a state capture queued before a playback state is set has to capture the state from before it, also when the capture is deferred.
+	int state = 0;
+	std::vector<int> capturedStates;
+	std::vector<WorkItem> workItems;
+	workItems.emplace_back(WorkItemCost::Heavy, [&state, &capturedStates](reshade::api::effect_runtime*) { capturedStates.push_back(state); });
+	workItems.emplace_back(WorkItemCost::Heavy, [&state, &capturedStates](reshade::api::effect_runtime*) { capturedStates.push_back(state); });
+	workItems.emplace_back([&state](reshade::api::effect_runtime*) { state = 1; });
+	std::vector<bool> isSuperseded(workItems.size(), false);
+	// nothing fits, but a single heavy work item is always performed.
+	WorkBudget budget;
+	budget.budgetPerFrame = std::chrono::microseconds(0);
+
+	EXPECT_EQ(2u, performWorkItems(workItems, isSuperseded, nullptr, budget));
+	EXPECT_EQ((std::vector<int>{ 0 }), capturedStates);
+	EXPECT_EQ(0, state);
+	isSuperseded.assign(workItems.size(), false);
+	EXPECT_EQ(0u, performWorkItems(workItems, isSuperseded, nullptr, budget));
+	EXPECT_EQ((std::vector<int>{ 0, 0 }), capturedStates);
+	EXPECT_EQ(1, state);
+	EXPECT_TRUE(workItems.empty());
+}
+
+
+TEST(WorkItemTests, LightWorkBeforeDeferredHeavyWorkIsPerformed)
+{
+	int numberOfLightWorkItemsPerformed = 0;
+	int numberOfHeavyWorkItemsPerformed = 0;
+	std::vector<WorkItem> workItems;
+	for(int i = 0; i < 3; i++)
+	{
+		workItems.emplace_back([&numberOfLightWorkItemsPerformed](reshade::api::effect_runtime*) { numberOfLightWorkItemsPerformed++; });
+		workItems.emplace_back(WorkItemCost::Heavy, [&numberOfHeavyWorkItemsPerformed](reshade::api::effect_runtime*) { numberOfHeavyWorkItemsPerformed++; });
+	}
+	std::vector<bool> isSuperseded(workItems.size(), false);
+	WorkBudget budget;
+	budget.budgetPerFrame = std::chrono::microseconds(0);
+
+	EXPECT_EQ(3u, performWorkItems(workItems, isSuperseded, nullptr, budget));
+	EXPECT_EQ(2, numberOfLightWorkItemsPerformed);
+	EXPECT_EQ(1, numberOfHeavyWorkItemsPerformed);
+}
+
+
+TEST(WorkItemTests, AllWorkIsPerformedWithinBudget)
+{
+	int numberOfWorkItemsPerformed = 0;
+	std::vector<WorkItem> workItems;
+	for(int i = 0; i < 10; i++)
+	{
+		workItems.emplace_back(WorkItemCost::Heavy, [&numberOfWorkItemsPerformed](reshade::api::effect_runtime*) { numberOfWorkItemsPerformed++; });
+	}
+	// the second and fourth work item are superseded by later ones, so they're dropped.
+	std::vector<bool> isSuperseded(workItems.size(), false);
+	isSuperseded[1] = true;
+	isSuperseded[3] = true;
+	WorkBudget budget;
+	budget.budgetPerFrame = std::chrono::seconds(10);
+
+	EXPECT_EQ(0u, performWorkItems(workItems, isSuperseded, nullptr, budget));
+	EXPECT_EQ(8, numberOfWorkItemsPerformed);
+	EXPECT_TRUE(workItems.empty());
+}